@@ -0,0 +1,263 @@
+/*
+ * Host Benchmark for the ADXL345 Driver
+ * ==========================================
+ * Runs the unmodified driver (Vitis/ADXL345.cpp) against the emulated
+ * sensor and bus from Vitis/ADXL345Sim.hpp on your local PC, and reports
+ * bus cost per sample (time, bit times, transactions), sustained sample
+ * rate and bus utilisation for the acquisition strategies at 100 kHz and
+ * 400 kHz, against the previous readRaw() (three readRegister16() calls,
+ * each a pointer write and a 2-byte read), then times the
+ * raw-to-physical conversion paths (legacy double, float, ADXL345Scale
+ * float/mg/Q16.16) per sample.
+ *
+ * To compile: g++ -O2 -DAXIWIRE_HOST -IVitis PC_ADXL345_Sim.cpp Vitis/ADXL345.cpp -o adxl345_sim -lm
+ * To run: ./adxl345_sim
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include "ADXL345.h"
+#include "ADXL345Sim.hpp"
+
+#define SIM_SECONDS         1ull
+#define NS_PER_SECOND       1000000000ull
+#define WATERMARK           16
+
+typedef enum
+{
+    MODE_POLL_LEGACY,   // previous readRaw(): 3 x readRegister16() per ODR period
+    MODE_POLL_RAW,      // one readRaw() per ODR period
+    MODE_FIFO_DRAIN     // stream FIFO, drainFifo() once per watermark
+} bench_mode_t;
+
+static const char *const modeNames[] = {"3x16 (old)", "readRaw", "drainFifo"};
+
+// The previous readRegister16(): register pointer write with STOP, then a
+// separate 2-byte read, once per axis
+static void legacyReadRaw(AxiWire &wire, int16_t *xyz)
+{
+    static const uint8_t regs[3] = {ADXL345_REG_DATAX0, ADXL345_REG_DATAY0, ADXL345_REG_DATAZ0};
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        uint8_t reg = regs[axis];
+        uint8_t va[2] = {0, 0};
+        wire.write(ADXL345_ADDRESS, &reg, 1);
+        wire.read(ADXL345_ADDRESS, va, 2);
+        xyz[axis] = (int16_t)(va[1] << 8 | va[0]);
+    }
+}
+
+typedef struct
+{
+    double busNs;           // bus time per sample
+    double transactions;    // STOP-terminated transactions per sample
+} bench_cost_t;
+
+static bench_cost_t run(bench_mode_t mode, uint32_t clock_hz, adxl345_dataRate_t rate)
+{
+    SimIicBusModel &bus = simIicBus(0);
+    SimADXL345 sensor;
+    bus.attach(&sensor);
+    bus.setClock(clock_hz);
+
+    AxiWire wire(0);
+    ADXL345 mpu;
+
+    ADXL345Config config = ADXL345::defaultConfig();
+    config.dataRate = rate;
+    if (mode == MODE_FIFO_DRAIN)
+    {
+        config.fifoMode = ADXL345_FIFO_STREAM;
+        config.fifoWatermark = WATERMARK;
+    }
+
+    if (!mpu.begin(&wire, config))
+    {
+        printf("initialization failed\n");
+        bench_cost_t none = {0.0, 0.0};
+        return none;
+    }
+
+    wire.close();
+    uint64_t start = bus.now();
+    uint64_t end = start + SIM_SECONDS * NS_PER_SECOND;
+    uint64_t samples = 0;
+    int16_t xyz[3 * ADXL345_FIFO_DEPTH];
+
+    while (bus.now() < end)
+    {
+        if (mode != MODE_FIFO_DRAIN)
+        {
+            // Sleep until the next sample is due, then fetch it
+            bus.advance(sensor.period() - (bus.now() % sensor.period()));
+            if (mode == MODE_POLL_RAW)
+            {
+                mpu.readRaw();
+            } else
+            {
+                legacyReadRaw(wire, xyz);
+            }
+            samples++;
+        } else
+        {
+            // Sleep until the WATERMARK interrupt would fire, then drain
+            do
+            {
+                bus.advance(sensor.period());
+                sensor.update(bus.now());
+            } while (sensor.fifoEntries() < WATERMARK);
+
+            samples += mpu.drainFifo(xyz, ADXL345_FIFO_DEPTH);
+        }
+    }
+
+    uint64_t elapsed = bus.now() - start;
+    bench_cost_t cost;
+    cost.busNs = samples ? (double)bus.busyTime() / samples : 0.0;
+    cost.transactions = samples ? (double)bus.transactionCount() / samples : 0.0;
+
+    printf("%-10s %4u kHz %6.0f Hz | %8.1f us %5.0f bits %6.2f trans /sample | %8.0f samples/s %5.1f%% bus | %llu dropped\n",
+           modeNames[mode],
+           clock_hz / 1000,
+           NS_PER_SECOND / (double)sensor.period(),
+           cost.busNs / 1000.0,
+           cost.busNs * clock_hz / NS_PER_SECOND,
+           cost.transactions,
+           samples * (double)NS_PER_SECOND / elapsed,
+           100.0 * bus.busyTime() / elapsed,
+           (unsigned long long)sensor.samplesDropped());
+    return cost;
+}
+
+// --- Conversion micro-benchmark ---
+#define CONV_SAMPLES        4096
+#define CONV_PASSES         2000
+
+typedef ADXL345Scale<ADXL345_RANGE_2G> Scale2G;
+
+static Vectori convRaw[CONV_SAMPLES];
+static volatile float floatSink;
+static volatile int32_t intSink;
+
+static double nowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void report(const char *name, double start)
+{
+    printf("%-28s %6.2f ns/sample\n", name, (nowNs() - start) / ((double)CONV_SAMPLES * CONV_PASSES));
+}
+
+static void runConversion(float gravityFactor)
+{
+    for (int i = 0; i < CONV_SAMPLES; i++)
+    {
+        convRaw[i].XAxis = (i * 37) % 1024 - 512;
+        convRaw[i].YAxis = (i * 11) % 1024 - 512;
+        convRaw[i].ZAxis = 256;
+    }
+
+    double start = nowNs();
+    for (int p = 0; p < CONV_PASSES; p++)
+    {
+        float acc = 0;
+        for (int i = 0; i < CONV_SAMPLES; i++)
+        {
+            // Previous readNormalize(): double literal on every axis
+            acc += convRaw[i].XAxis * 0.004 * gravityFactor;
+            acc += convRaw[i].YAxis * 0.004 * gravityFactor;
+            acc += convRaw[i].ZAxis * 0.004 * gravityFactor;
+        }
+        floatSink = acc;
+    }
+    report("double (previous)", start);
+
+    float factor = 0.004f * gravityFactor;
+    start = nowNs();
+    for (int p = 0; p < CONV_PASSES; p++)
+    {
+        float acc = 0;
+        for (int i = 0; i < CONV_SAMPLES; i++)
+        {
+            // readNormalize(): runtime float factor
+            acc += convRaw[i].XAxis * factor + convRaw[i].YAxis * factor + convRaw[i].ZAxis * factor;
+        }
+        floatSink = acc;
+    }
+    report("float, runtime scale", start);
+
+    start = nowNs();
+    for (int p = 0; p < CONV_PASSES; p++)
+    {
+        float acc = 0;
+        for (int i = 0; i < CONV_SAMPLES; i++)
+        {
+            Vector v = Scale2G::toMs2(convRaw[i]);
+            acc += v.XAxis + v.YAxis + v.ZAxis;
+        }
+        floatSink = acc;
+    }
+    report("ADXL345Scale::toMs2", start);
+
+    start = nowNs();
+    for (int p = 0; p < CONV_PASSES; p++)
+    {
+        int32_t acc = 0;
+        for (int i = 0; i < CONV_SAMPLES; i++)
+        {
+            Vectori v = Scale2G::toMilliG(convRaw[i]);
+            acc += v.XAxis + v.YAxis + v.ZAxis;
+        }
+        intSink = acc;
+    }
+    report("ADXL345Scale::toMilliG", start);
+
+    start = nowNs();
+    for (int p = 0; p < CONV_PASSES; p++)
+    {
+        int32_t acc = 0;
+        for (int i = 0; i < CONV_SAMPLES; i++)
+        {
+            Vectori v = Scale2G::toQ16(convRaw[i]);
+            acc += v.XAxis + v.YAxis + v.ZAxis;
+        }
+        intSink = acc;
+    }
+    report("ADXL345Scale::toQ16", start);
+}
+
+int main()
+{
+    printf("ADXL345 Driver Bus Benchmark (Host Emulation)\n");
+    printf("----------------------------------------------\n");
+
+    const uint32_t clocks[] = {100000, 400000};
+    const adxl345_dataRate_t rates[] = {ADXL345_DATARATE_400HZ, ADXL345_DATARATE_1600HZ, ADXL345_DATARATE_3200HZ};
+
+    for (unsigned int c = 0; c < 2; c++)
+    {
+        for (unsigned int r = 0; r < 3; r++)
+        {
+            bench_cost_t legacy = run(MODE_POLL_LEGACY, clocks[c], rates[r]);
+            bench_cost_t burst = run(MODE_POLL_RAW, clocks[c], rates[r]);
+            bench_cost_t fifo = run(MODE_FIFO_DRAIN, clocks[c], rates[r]);
+            if (burst.busNs > 0.0 && fifo.busNs > 0.0)
+            {
+                printf("%-10s vs 3x16: readRaw %.1fx fewer transactions, %.1fx less bus time; "
+                       "drainFifo %.1fx, %.1fx\n", "",
+                       legacy.transactions / burst.transactions, legacy.busNs / burst.busNs,
+                       legacy.transactions / fifo.transactions, legacy.busNs / fifo.busNs);
+            }
+        }
+    }
+
+    printf("\nConversion cost (host; build for the target to compare soft-float)\n");
+    printf("----------------------------------------------\n");
+    runConversion(ADXL345_GRAVITY_EARTH);
+
+    return 0;
+}
@@ -0,0 +1,259 @@
+/*
+ * Host Test for the Non-Blocking AxiWire Engine
+ * ==============================================
+ * Runs Vitis/axiWireAsync.hpp over SimIicAsyncPort (Vitis/axiWireSim.hpp)
+ * with the emulated ADXL345 on the bus, on your local PC. It checks:
+ *   - queue full: one active plus AXIWIRE_QUEUE_DEPTH queued transactions
+ *     are accepted, the next submit() fails, and a completion frees a place
+ *   - in-order completion: callbacks fire in submit order, one per
+ *     transaction, each once its bus phases have elapsed, and register
+ *     read-backs (repeated START) return the values written before them
+ *   - error callbacks: a transaction to an absent address completes with
+ *     AXIWIRE_NACK without running its read phase, and the queue carries on
+ *     with the next transaction
+ *   - a callback may submit the next transaction (interrupt-context chaining)
+ *
+ * To compile: g++ -O2 -DAXIWIRE_HOST -IVitis PC_AxiWireAsync_Test.cpp -o axiwireasync_test -lm
+ * To run: ./axiwireasync_test
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ADXL345Sim.hpp"
+#include "axiWireAsync.hpp"
+
+#define ABSENT_ADDRESS      0x1D
+#define CHAIN_LENGTH        20
+
+struct Completion
+{
+    AxiWireTransaction *transaction;
+    int status;
+    uint64_t at;
+};
+
+static Completion completions[4 * AXIWIRE_QUEUE_DEPTH];
+static unsigned int completed;
+
+static void record(AxiWireTransaction *transaction, void *ref)
+{
+    SimIicBusModel *bus = static_cast<SimIicBusModel *>(ref);
+
+    if (completed < sizeof(completions) / sizeof(completions[0]))
+    {
+        completions[completed].transaction = transaction;
+        completions[completed].status = transaction->status;
+        completions[completed].at = bus->now();
+    }
+    completed++;
+}
+
+// Run the simulated interrupts until the queue is empty
+static void drain(AxiWireAsync &wire)
+{
+    for (int i = 0; i < 1000 && wire.busy(); i++)
+    {
+        wire.getPort().advance(100000);
+    }
+}
+
+static void setWrite(AxiWireTransaction *t, unsigned int address, unsigned char *tx, unsigned int length)
+{
+    t->slave_address = address;
+    t->tx = tx;
+    t->tx_length = length;
+    t->rx = NULL;
+    t->rx_length = 0;
+}
+
+static void setWriteRead(AxiWireTransaction *t, unsigned int address, unsigned char *tx, unsigned char *rx,
+                         unsigned int length)
+{
+    t->slave_address = address;
+    t->tx = tx;
+    t->tx_length = 1;
+    t->rx = rx;
+    t->rx_length = length;
+}
+
+static bool testQueueFull(AxiWireAsync &wire)
+{
+    static unsigned char tx[AXIWIRE_QUEUE_DEPTH + 2][2];
+    static AxiWireTransaction t[AXIWIRE_QUEUE_DEPTH + 2];
+    SimIicBusModel &bus = wire.getPort().getBus();
+    unsigned int accepted = 0;
+
+    completed = 0;
+    for (unsigned int i = 0; i < AXIWIRE_QUEUE_DEPTH + 2; i++)
+    {
+        tx[i][0] = ADXL345_REG_OFSX;
+        tx[i][1] = (unsigned char)i;
+        setWrite(&t[i], ADXL345_ADDRESS, tx[i], 2);
+    }
+
+    // The first submit starts at once, so the queue holds DEPTH more behind it
+    for (unsigned int i = 0; i < AXIWIRE_QUEUE_DEPTH + 1; i++)
+    {
+        accepted += wire.submit(&t[i], record, &bus);
+    }
+    bool full = !wire.submit(&t[AXIWIRE_QUEUE_DEPTH + 1], record, &bus);
+    bool pendingOk = wire.pending() == AXIWIRE_QUEUE_DEPTH;
+
+    // One completion makes room for exactly one more
+    while (completed == 0)
+    {
+        wire.getPort().advance(1000);
+    }
+    bool room = wire.submit(&t[AXIWIRE_QUEUE_DEPTH + 1], record, &bus);
+    drain(wire);
+
+    bool pass = accepted == AXIWIRE_QUEUE_DEPTH + 1 && full && pendingOk && room &&
+                completed == AXIWIRE_QUEUE_DEPTH + 2 && !wire.busy();
+    printf("queue full:    %u accepted, next %s, %s after a completion\n", accepted,
+           full ? "refused" : "ACCEPTED", room ? "accepted" : "REFUSED");
+    return pass;
+}
+
+static bool testOrder(AxiWireAsync &wire)
+{
+    const unsigned int pairs = AXIWIRE_QUEUE_DEPTH / 2;
+    static unsigned char tx[AXIWIRE_QUEUE_DEPTH][2], rx[AXIWIRE_QUEUE_DEPTH];
+    static AxiWireTransaction t[AXIWIRE_QUEUE_DEPTH];
+    SimIicBusModel &bus = wire.getPort().getBus();
+    bool pass = true;
+
+    // Write THRESH_TAP, OFSX, ..., each followed by its read-back
+    completed = 0;
+    memset(rx, 0, sizeof(rx));
+    for (unsigned int i = 0; i < pairs; i++)
+    {
+        unsigned char reg = (unsigned char)(ADXL345_REG_THRESH_TAP + i);
+
+        tx[2 * i][0] = reg;
+        tx[2 * i][1] = (unsigned char)(0xA0 + i);
+        setWrite(&t[2 * i], ADXL345_ADDRESS, tx[2 * i], 2);
+
+        tx[2 * i + 1][0] = reg;
+        setWriteRead(&t[2 * i + 1], ADXL345_ADDRESS, tx[2 * i + 1], &rx[i], 1);
+    }
+
+    uint64_t start = bus.now();
+    for (unsigned int i = 0; i < 2 * pairs; i++)
+    {
+        pass = pass && wire.submit(&t[i], record, &bus);
+    }
+    drain(wire);
+
+    uint64_t last = start;
+    for (unsigned int i = 0; i < completed && i < 2 * pairs; i++)
+    {
+        pass = pass && completions[i].transaction == &t[i] && completions[i].status == AXIWIRE_OK &&
+               completions[i].at > last;
+        last = completions[i].at;
+    }
+    for (unsigned int i = 0; i < pairs; i++)
+    {
+        pass = pass && rx[i] == 0xA0 + i;
+    }
+    pass = pass && completed == 2 * pairs;
+
+    printf("order:         %u callbacks in submit order, read-backs %s\n", completed,
+           pass ? "match the writes" : "WRONG");
+    return pass;
+}
+
+static bool testErrors(AxiWireAsync &wire)
+{
+    static unsigned char tx[3][2], rx[2];
+    static AxiWireTransaction t[3];
+    SimIicBusModel &bus = wire.getPort().getBus();
+
+    // Good write, write-read to an absent device, good read-back
+    completed = 0;
+    tx[0][0] = ADXL345_REG_OFSY;
+    tx[0][1] = 0x5A;
+    setWrite(&t[0], ADXL345_ADDRESS, tx[0], 2);
+    tx[1][0] = ADXL345_REG_DEVID;
+    rx[0] = 0xEE;
+    setWriteRead(&t[1], ABSENT_ADDRESS, tx[1], &rx[0], 1);
+    tx[2][0] = ADXL345_REG_OFSY;
+    rx[1] = 0;
+    setWriteRead(&t[2], ADXL345_ADDRESS, tx[2], &rx[1], 1);
+
+    bus.clearStats();
+    bool pass = wire.submit(&t[0], record, &bus) && wire.submit(&t[1], record, &bus) &&
+                wire.submit(&t[2], record, &bus);
+    drain(wire);
+
+    // 1 + 1 (NACKed write phase, no read phase) + 2 phases
+    pass = pass && completed == 3 &&
+           completions[0].status == AXIWIRE_OK &&
+           completions[1].transaction == &t[1] && completions[1].status == AXIWIRE_NACK &&
+           t[1].status == AXIWIRE_NACK && rx[0] == 0xEE &&
+           completions[2].status == AXIWIRE_OK && rx[1] == 0x5A &&
+           bus.phaseCount() == 4;
+
+    printf("errors:        absent device -> status %d, read phase %s, next transaction %s\n",
+           completions[1].status, bus.phaseCount() == 4 ? "skipped" : "RUN",
+           completions[2].status == AXIWIRE_OK && rx[1] == 0x5A ? "ok" : "FAILED");
+    return pass;
+}
+
+// Callback that queues the next link from interrupt context
+struct Chain
+{
+    AxiWireAsync *wire;
+    AxiWireTransaction t;
+    unsigned char tx[2];
+    unsigned int done;
+    bool ok;
+};
+
+static void chainNext(AxiWireTransaction *transaction, void *ref)
+{
+    Chain *chain = static_cast<Chain *>(ref);
+
+    chain->ok = chain->ok && transaction->status == AXIWIRE_OK;
+    if (++chain->done < CHAIN_LENGTH)
+    {
+        chain->tx[1] = (unsigned char)chain->done;
+        chain->ok = chain->ok && chain->wire->submit(&chain->t, chainNext, chain);
+    }
+}
+
+static bool testChain(AxiWireAsync &wire)
+{
+    static Chain chain;
+
+    chain.wire = &wire;
+    chain.tx[0] = ADXL345_REG_OFSZ;
+    chain.tx[1] = 0;
+    chain.done = 0;
+    chain.ok = true;
+    setWrite(&chain.t, ADXL345_ADDRESS, chain.tx, 2);
+
+    bool pass = wire.submit(&chain.t, chainNext, &chain);
+    drain(wire);
+    pass = pass && chain.ok && chain.done == CHAIN_LENGTH && !wire.busy();
+
+    printf("chaining:      %u transactions queued from callbacks\n", chain.done);
+    return pass;
+}
+
+int main()
+{
+    SimADXL345 sensor;
+    simIicBus(0).attach(&sensor);
+    simIicBus(0).setClock(400000);
+
+    AxiWireAsync wire(0);
+    bool pass = true;
+
+    pass &= testQueueFull(wire);
+    pass &= testOrder(wire);
+    pass &= testErrors(wire);
+    pass &= testChain(wire);
+
+    printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
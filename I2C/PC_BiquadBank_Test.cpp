@@ -0,0 +1,244 @@
+/*
+ * Host Test for BiquadBank
+ * ========================
+ * Checks Vitis/BiquadBank.hpp on your local PC:
+ *   - the constexpr sin / cos series against libm over [0, pi]
+ *   - BiquadDesign low-pass / high-pass / band-pass coefficients (built as
+ *     constants at compile time) against the RBJ formulas evaluated with
+ *     libm, and their gains: unity DC gain for the low-pass, zero DC and
+ *     unity Nyquist gain for the high-pass, unity peak gain at f0 for the
+ *     band-pass
+ *   - BiquadCascade::process (SSE2 on x86 hosts) against a scalar TDF-II
+ *     reference, with the state carried across blocks, and a low-pass step
+ *     response settling at 1
+ *   - decimate: the phase carries across blocks, factor 0 is rejected
+ *
+ * Build with -U__SSE2__ to run the scalar path the MicroBlaze uses.
+ *
+ * To compile: g++ -O2 -std=c++11 -IVitis PC_BiquadBank_Test.cpp -o biquadbank_test -lm
+ * To run: ./biquadbank_test
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "BiquadBank.hpp"
+
+#define FS              3200.0
+#define BLOCK           32
+#define BLOCKS          40
+
+// Folded by the compiler, as the firmware uses them
+constexpr BiquadCoeffs kLowPass = BiquadDesign::lowPass(FS, 400.0, 0.7071);
+constexpr BiquadCoeffs kHighPass = BiquadDesign::highPass(FS, 0.5, 0.7071);
+constexpr BiquadCoeffs kBandPass = BiquadDesign::bandPass(FS, 50.0, 2.0);
+static_assert(kLowPass.b0 > 0.0f && kLowPass.b0 < 1.0f, "low-pass designed at compile time");
+
+// RBJ cookbook with libm
+static BiquadCoeffs rbj(int type, double fs, double f0, double q)
+{
+    double w = 2.0 * M_PI * f0 / fs, cw = cos(w), alpha = sin(w) / (2.0 * q);
+    double b0, b1, b2;
+
+    if (type == 0)
+    {
+        b0 = (1.0 - cw) / 2.0;
+        b1 = 1.0 - cw;
+        b2 = b0;
+    } else if (type == 1)
+    {
+        b0 = (1.0 + cw) / 2.0;
+        b1 = -(1.0 + cw);
+        b2 = b0;
+    } else
+    {
+        b0 = alpha;
+        b1 = 0.0;
+        b2 = -alpha;
+    }
+
+    double a0 = 1.0 + alpha;
+    BiquadCoeffs c = { (float)(b0 / a0), (float)(b1 / a0), (float)(b2 / a0), (float)(-2.0 * cw / a0),
+                       (float)((1.0 - alpha) / a0) };
+    return c;
+}
+
+// |H(e^jw)| of one section
+static double gain(const BiquadCoeffs &c, double fs, double f)
+{
+    double w = 2.0 * M_PI * f / fs;
+    double nr = c.b0 + c.b1 * cos(w) + c.b2 * cos(2 * w), ni = -c.b1 * sin(w) - c.b2 * sin(2 * w);
+    double dr = 1.0 + c.a1 * cos(w) + c.a2 * cos(2 * w), di = -c.a1 * sin(w) - c.a2 * sin(2 * w);
+    return sqrt((nr * nr + ni * ni) / (dr * dr + di * di));
+}
+
+static double coeffError(const BiquadCoeffs &a, const BiquadCoeffs &b)
+{
+    double e = fabs(a.b0 - b.b0);
+    e = fmax(e, fabs(a.b1 - b.b1));
+    e = fmax(e, fabs(a.b2 - b.b2));
+    e = fmax(e, fabs(a.a1 - b.a1));
+    return fmax(e, fabs(a.a2 - b.a2));
+}
+
+static bool testSeries(void)
+{
+    double worst = 0;
+
+    for (int i = 0; i <= 1000; i++)
+    {
+        double x = M_PI * i / 1000;
+        worst = fmax(worst, fabs(BiquadDesign::sin(x) - sin(x)));
+        worst = fmax(worst, fabs(BiquadDesign::cos(x) - cos(x)));
+    }
+    printf("sin/cos:     max error against libm %.2g over [0, pi]\n", worst);
+    return worst < 1e-9;
+}
+
+static bool testDesign(void)
+{
+    double eLp = coeffError(kLowPass, rbj(0, FS, 400.0, 0.7071));
+    double eHp = coeffError(kHighPass, rbj(1, FS, 0.5, 0.7071));
+    double eBp = coeffError(kBandPass, rbj(2, FS, 50.0, 2.0));
+    double lpDc = gain(kLowPass, FS, 0.0), lpCut = gain(kLowPass, FS, 400.0);
+    double hpDc = gain(kHighPass, FS, 0.0), hpNyq = gain(kHighPass, FS, FS / 2);
+    double bpPeak = gain(kBandPass, FS, 50.0);
+
+    bool pass = eLp < 1e-6 && eHp < 1e-6 && eBp < 1e-6 &&
+                fabs(lpDc - 1.0) < 1e-5 && fabs(lpCut - M_SQRT1_2) < 1e-3 &&
+                hpDc < 1e-5 && fabs(hpNyq - 1.0) < 1e-5 && fabs(bpPeak - 1.0) < 1e-4;
+    printf("design:      coefficient error lp %.2g hp %.2g bp %.2g against libm\n", eLp, eHp, eBp);
+    printf("             low-pass DC %.6f, -3 dB %.4f; high-pass DC %.2g, Nyquist %.6f; band-pass peak %.6f\n",
+           lpDc, lpCut, hpDc, hpNyq, bpPeak);
+    return pass;
+}
+
+// Scalar TDF-II, one axis per call
+struct RefSection
+{
+    BiquadCoeffs c;
+    float z1[3], z2[3];
+};
+
+static float refStep(RefSection *s, int sections, int axis, float v)
+{
+    for (int k = 0; k < sections; k++)
+    {
+        float y = s[k].c.b0 * v + s[k].z1[axis];
+        s[k].z1[axis] = (s[k].c.b1 * v + s[k].z2[axis]) - s[k].c.a1 * y;
+        s[k].z2[axis] = s[k].c.b2 * v - s[k].c.a2 * y;
+        v = y;
+    }
+    return v;
+}
+
+static bool testProcess(void)
+{
+    BiquadCascade<2> cascade;
+    RefSection ref[2] = { { kLowPass, { 0 }, { 0 } }, { kBandPass, { 0 }, { 0 } } };
+    double worst = 0;
+
+    cascade.setSection(0, kLowPass);
+    cascade.setSection(1, kBandPass);
+
+    // Odd block sizes, history carried from block to block
+    srand(1);
+    for (int b = 0; b < BLOCKS; b++)
+    {
+        SampleBlock<BLOCK> block;
+        block.count = 1 + (size_t)(b * 7) % BLOCK;
+        for (size_t i = 0; i < block.count; i++)
+        {
+            block.x[i] = (rand() % 2001 - 1000) / 250.0f;
+            block.y[i] = sinf(0.1f * (b * BLOCK + i));
+            block.z[i] = 1.0f;
+        }
+
+        float expect[3][BLOCK];
+        for (size_t i = 0; i < block.count; i++)
+        {
+            expect[0][i] = refStep(ref, 2, 0, block.x[i]);
+            expect[1][i] = refStep(ref, 2, 1, block.y[i]);
+            expect[2][i] = refStep(ref, 2, 2, block.z[i]);
+        }
+        cascade.process(block);
+
+        for (size_t i = 0; i < block.count; i++)
+        {
+            worst = fmax(worst, fabs(block.x[i] - expect[0][i]));
+            worst = fmax(worst, fabs(block.y[i] - expect[1][i]));
+            worst = fmax(worst, fabs(block.z[i] - expect[2][i]));
+        }
+    }
+
+    // Low-pass step response settles at the DC gain
+    BiquadCascade<1> lowPass;
+    lowPass.setSection(0, kLowPass);
+    SampleBlock<BLOCK> step;
+    float settled = 0;
+    for (int b = 0; b < 4; b++)
+    {
+        step.count = BLOCK;
+        for (size_t i = 0; i < BLOCK; i++)
+        {
+            step.x[i] = 1.0f;
+            step.y[i] = -1.0f;
+            step.z[i] = 0.0f;
+        }
+        lowPass.process(step);
+        settled = step.x[BLOCK - 1];
+    }
+
+    bool pass = worst < 1e-5 && fabsf(settled - 1.0f) < 1e-4f && fabsf(step.y[BLOCK - 1] + 1.0f) < 1e-4f &&
+                step.z[BLOCK - 1] == 0.0f;
+    printf("process:     max difference from scalar TDF-II %.2g, step response %.6f\n", worst, settled);
+    return pass;
+}
+
+static bool testDecimate(void)
+{
+    BiquadCascade<1> cascade;
+    SampleBlock<BLOCK> block;
+    size_t kept = 0;
+    bool order = true;
+    float next = 0;
+
+    // 3 blocks of 10 samples at factor 4 keep samples 0, 4, 8, ..., 28
+    for (int b = 0; b < 3; b++)
+    {
+        block.count = 10;
+        for (size_t i = 0; i < block.count; i++)
+        {
+            block.x[i] = (float)(b * 10 + i);
+            block.y[i] = 0;
+            block.z[i] = 0;
+        }
+        size_t n = cascade.decimate(block, 4);
+        for (size_t i = 0; i < n; i++)
+        {
+            order = order && block.x[i] == next;
+            next += 4;
+        }
+        kept += n;
+    }
+
+    block.count = 10;
+    bool rejected = cascade.decimate(block, 0) == 0 && block.count == 10;
+
+    printf("decimate:    %zu of 30 samples kept across blocks, factor 0 %s\n", kept,
+           rejected ? "rejected" : "ACCEPTED");
+    return kept == 8 && order && rejected;
+}
+
+int main()
+{
+    bool pass = true;
+
+    pass &= testSeries();
+    pass &= testDesign();
+    pass &= testProcess();
+    pass &= testDecimate();
+
+    printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,244 @@
+/*
+ * Host Decoder for the Deferred Binary Logger
+ * ==========================================
+ * Renders the frames sent by dlog_drain() (Vitis/deferLog.h) back into
+ * text using the message table in Vitis/logFormats.h, and passes any plain
+ * text written with xil_printf through unchanged. Reads a capture file or
+ * stdin, e.g. straight from the UART:
+ *   stty -F /dev/ttyUSB1 115200 raw && ./deferlog_decode < /dev/ttyUSB1
+ *
+ * "./deferlog_decode --bench" runs the logger itself on the PC: it times
+ * the DLOG3() hot path, then drains into memory and decodes the capture.
+ *
+ * To compile: gcc -O2 -IVitis -DDLOG_OUTBYTE=dlog_capture PC_DeferLog_Decode.c Vitis/deferLog.c -o deferlog_decode
+ * To run: ./deferlog_decode [capture.bin | --bench]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "deferLog.h"
+
+#define DLOG_FORMAT(id, format) format,
+static const char *formats[] = {
+#include "logFormats.h"
+};
+#undef DLOG_FORMAT
+
+// --- Byte source: file plus a small push-back buffer for resync ---
+static FILE *input;
+static unsigned char pushback[5 + 4 * DLOG_MAX_ARGS + 1];
+static int pushed;
+
+static int next_byte(void)
+{
+    if (pushed > 0) {
+        return pushback[--pushed];
+    }
+    return fgetc(input);
+}
+
+// Re-scan bytes[1..n-1] after a bad frame
+static void unread(const unsigned char *bytes, int n)
+{
+    for (int i = n - 1; i >= 1; i--) {
+        pushback[pushed++] = bytes[i];
+    }
+}
+
+// printf one record, taking each conversion's argument as int or float
+static void render(FILE *out, uint16_t id, int nargs, const uint32_t *arg)
+{
+    if (id >= DLOG_FORMAT_COUNT) {
+        fprintf(out, "[unknown message %u]\n", id);
+        return;
+    }
+
+    const char *p = formats[id];
+    int a = 0;
+
+    while (*p) {
+        if (*p != '%') {
+            fputc(*p++, out);
+            continue;
+        }
+        if (p[1] == '%') {
+            fputc('%', out);
+            p += 2;
+            continue;
+        }
+
+        // Copy one conversion spec, e.g. "%.3f" or "%08X"
+        char spec[16];
+        int n = 0;
+        spec[n++] = *p++;
+        while (*p && strchr("diuxXcfeEgG", *p) == NULL && n < (int)sizeof(spec) - 2) {
+            spec[n++] = *p++;
+        }
+        char conversion = *p;
+        if (*p) {
+            spec[n++] = *p++;
+        }
+        spec[n] = '\0';
+
+        uint32_t value = a < nargs ? arg[a] : 0;
+        a++;
+
+        if (strchr("feEgG", conversion)) {
+            union { uint32_t u; float f; } v;
+            v.u = value;
+            fprintf(out, spec, (double)v.f);
+        } else if (conversion == 'd' || conversion == 'i' || conversion == 'c') {
+            fprintf(out, spec, (int32_t)value);
+        } else {
+            fprintf(out, spec, value);
+        }
+    }
+}
+
+static void decode(FILE *in, FILE *out)
+{
+    int c;
+    int expected = -1;
+    unsigned long frames = 0, bad = 0, lost = 0;
+
+    input = in;
+    pushed = 0;
+
+    while ((c = next_byte()) != EOF) {
+        if (c != DLOG_SYNC) {
+            fputc(c, out);      // plain text
+            continue;
+        }
+
+        unsigned char frame[5 + 4 * DLOG_MAX_ARGS + 1];
+        int length = 0;
+        frame[length++] = (unsigned char)c;
+
+        // id (2), seq, nargs
+        while (length < 5 && (c = next_byte()) != EOF) {
+            frame[length++] = (unsigned char)c;
+        }
+        int nargs = length == 5 ? frame[4] : 0;
+        int total = 5 + 4 * nargs + 1;
+
+        if (length < 5 || nargs > DLOG_MAX_ARGS) {
+            bad++;
+            unread(frame, length);
+            continue;
+        }
+        while (length < total && (c = next_byte()) != EOF) {
+            frame[length++] = (unsigned char)c;
+        }
+
+        unsigned char sum = 0;
+        for (int i = 1; i < length; i++) {
+            sum += frame[i];
+        }
+        if (length < total || sum != 0) {
+            bad++;
+            unread(frame, length);
+            continue;
+        }
+
+        int seq = frame[3];
+        if (expected >= 0 && seq != expected) {
+            lost += (seq - expected) & 0xFF;
+            fprintf(out, "[%d frames lost on the link]\n", (seq - expected) & 0xFF);
+        }
+        expected = (seq + 1) & 0xFF;
+
+        uint32_t arg[DLOG_MAX_ARGS];
+        for (int i = 0; i < nargs; i++) {
+            const unsigned char *b = &frame[5 + 4 * i];
+            arg[i] = (uint32_t)b[0] | (uint32_t)b[1] << 8 | (uint32_t)b[2] << 16 | (uint32_t)b[3] << 24;
+        }
+        render(out, (uint16_t)(frame[1] | frame[2] << 8), nargs, arg);
+        frames++;
+        fflush(out);
+    }
+
+    fprintf(stderr, "%lu frames, %lu bad, %lu lost\n", frames, bad, lost);
+}
+
+// --- Self test / benchmark on the host ---
+#define BENCH_RECORDS   (DLOG_DEPTH / 2)
+#define BENCH_PASSES    200000
+
+static unsigned char capture[1 << 20];
+static size_t captured;
+
+void dlog_capture(uint8_t c)
+{
+    if (captured < sizeof(capture)) {
+        capture[captured++] = c;
+    }
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void bench(void)
+{
+    double logging = 0, draining = 0;
+
+    for (int p = 0; p < BENCH_PASSES; p++) {
+        double start = now_ns();
+        for (int i = 0; i < BENCH_RECORDS; i++) {
+            DLOG3(DLOG_ACCEL_G, dlog_f(i * 0.001f), dlog_f(-0.25f), dlog_f(1.0f));
+        }
+        double mid = now_ns();
+        captured = 0;
+        dlog_drain(DLOG_DEPTH);
+        draining += now_ns() - mid;
+        logging += mid - start;
+    }
+
+    fprintf(stderr, "DLOG3 (hot path)  %6.1f ns/record\n", logging / ((double)BENCH_PASSES * BENCH_RECORDS));
+    fprintf(stderr, "dlog_drain        %6.1f ns/record, %zu bytes/record\n",
+            draining / ((double)BENCH_PASSES * BENCH_RECORDS), captured / BENCH_RECORDS);
+
+    // Decode a mixed capture: text, records, a burst that overflows the ring
+    captured = 0;
+    const char *text = "--- plain xil_printf text ---\r\n";
+    for (const char *t = text; *t; t++) {
+        dlog_capture((uint8_t)*t);
+    }
+    DLOG3(DLOG_ACCEL_MG, 12, -250, 1003);
+    DLOG3(DLOG_ACCEL_G, dlog_f(0.012f), dlog_f(-0.25f), dlog_f(1.003f));
+    DLOG3(DLOG_ACCEL_STATS, 100, 0, 0);
+    for (int i = 0; i < DLOG_DEPTH + 5; i++) {
+        DLOG0(DLOG_FFT_ACQUIRE);
+    }
+    dlog_drain(DLOG_DEPTH);
+    dlog_drain(DLOG_DEPTH);
+
+    FILE *in = fmemopen(capture, captured, "rb");
+    decode(in, stdout);
+    fclose(in);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        bench();
+        return 0;
+    }
+
+    FILE *in = stdin;
+    if (argc > 1) {
+        in = fopen(argv[1], "rb");
+        if (in == NULL) {
+            perror(argv[1]);
+            return 1;
+        }
+    }
+
+    decode(in, stdout);
+    return 0;
+}
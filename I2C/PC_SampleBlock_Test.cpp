@@ -0,0 +1,243 @@
+/*
+ * Host Test for SampleBlock<N>
+ * ============================
+ * Checks the batch kernels of Vitis/SampleBlock.hpp (SSE2 on x86 hosts)
+ * against a plain scalar reference on your local PC:
+ *   - fromRaw: deinterleave and scale, including -32768 / 32767 samples,
+ *     for every count 0..N and a count above N (clamped)
+ *   - normalize: in-place scaling, vector body plus the 1..3 sample tail
+ *   - lowPass: the first-order filter, with the state carried from one
+ *     block to the next (the vector path is a 4-sample prefix sum, so it
+ *     matches the reference to float rounding, not bit for bit)
+ * then times fromRaw + normalize and lowPass, each against the reference.
+ *
+ * Build with -U__SSE2__ (or -mno-sse2 on 32-bit x86) to check the scalar
+ * path the MicroBlaze uses the same way.
+ *
+ * To compile: g++ -O2 -IVitis PC_SampleBlock_Test.cpp -o sampleblock_test
+ * To run: ./sampleblock_test
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "SampleBlock.hpp"
+
+#define BLOCK           32          // ADXL345_FIFO_DEPTH
+#define SCALE           0.0039f     // 2 g full resolution, g/LSB
+#define GRAVITY         9.80665f
+#define ALPHA           0.3f
+#define BENCH_PASSES    200000
+
+typedef SampleBlock<BLOCK> Block;
+
+static double nowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void fillRaw(int16_t *xyz, size_t n, unsigned int seed)
+{
+    srand(seed);
+    for (size_t i = 0; i < 3 * n; i++)
+    {
+        xyz[i] = (int16_t)(rand() & 0xFFFF);
+    }
+    // Extremes in the vector body and in the tail
+    if (n > 0)
+    {
+        xyz[0] = -32768;
+        xyz[3 * n - 1] = 32767;
+    }
+}
+
+// Scalar reference, written out as the MicroBlaze build would run it
+static void refFromRaw(const int16_t *xyz, size_t n, float scale, float *x, float *y, float *z)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        x[i] = xyz[3 * i + 0] * scale;
+        y[i] = xyz[3 * i + 1] * scale;
+        z[i] = xyz[3 * i + 2] * scale;
+    }
+}
+
+static void refLowPass(float *s, float *x, float *y, float *z, size_t n, float alpha)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        s[0] += alpha * (x[i] - s[0]);
+        s[1] += alpha * (y[i] - s[1]);
+        s[2] += alpha * (z[i] - s[2]);
+        x[i] = s[0];
+        y[i] = s[1];
+        z[i] = s[2];
+    }
+}
+
+// Largest |a - b| relative to max(|b|, 1)
+static double maxError(const float *a, const float *b, size_t n)
+{
+    double worst = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        double e = fabs((double)a[i] - b[i]) / fmax(fabs((double)b[i]), 1.0);
+        worst = e > worst ? e : worst;
+    }
+    return worst;
+}
+
+static bool testFromRawNormalize(void)
+{
+    int16_t raw[3 * (BLOCK + 5)];
+    float x[BLOCK + 5], y[BLOCK + 5], z[BLOCK + 5];
+    bool exact = true, clamped;
+
+    for (size_t n = 0; n <= BLOCK; n++)
+    {
+        Block block;
+        fillRaw(raw, n, (unsigned int)n);
+        refFromRaw(raw, n, SCALE, x, y, z);
+        block.fromRaw(raw, n, SCALE);
+        exact = exact && block.count == n && maxError(block.x, x, n) == 0 &&
+                maxError(block.y, y, n) == 0 && maxError(block.z, z, n) == 0;
+
+        for (size_t i = 0; i < n; i++)
+        {
+            x[i] *= GRAVITY;
+            y[i] *= GRAVITY;
+            z[i] *= GRAVITY;
+        }
+        block.normalize(GRAVITY);
+        exact = exact && maxError(block.x, x, n) == 0 && maxError(block.y, y, n) == 0 &&
+                maxError(block.z, z, n) == 0;
+    }
+
+    // More samples than the block holds: only the first N are taken
+    Block block;
+    fillRaw(raw, BLOCK + 5, 99);
+    refFromRaw(raw, BLOCK, SCALE, x, y, z);
+    block.fromRaw(raw, BLOCK + 5, SCALE);
+    clamped = block.count == BLOCK && maxError(block.x, x, BLOCK) == 0 && maxError(block.z, z, BLOCK) == 0;
+
+    printf("fromRaw/normalize: counts 0..%d %s the scalar path, %d samples clamped to %s\n", BLOCK,
+           exact ? "match" : "DIFFER from", BLOCK + 5, clamped ? "the block size" : "WRONG COUNT");
+    return exact && clamped;
+}
+
+static bool testLowPass(void)
+{
+    const size_t counts[] = { 1, 3, 5, 7, 13, 31, BLOCK };
+    int16_t raw[3 * BLOCK];
+    float x[BLOCK], y[BLOCK], z[BLOCK];
+    float ref[3] = { 0, 0, 0 };
+    SampleFilterState state;
+    double worst = 0;
+    size_t total = 0;
+
+    // One stream split into odd-sized blocks; the state carries across them
+    for (size_t b = 0; b < sizeof(counts) / sizeof(counts[0]); b++)
+    {
+        size_t n = counts[b];
+        Block block;
+        fillRaw(raw, n, 1000 + (unsigned int)b);
+        refFromRaw(raw, n, SCALE, x, y, z);
+        refLowPass(ref, x, y, z, n, ALPHA);
+
+        block.fromRaw(raw, n, SCALE);
+        block.lowPass(state, ALPHA);
+
+        double e = fmax(maxError(block.x, x, n), fmax(maxError(block.y, y, n), maxError(block.z, z, n)));
+        worst = e > worst ? e : worst;
+        total += n;
+    }
+    double stateError = maxError(state.s, ref, 3);
+
+    // Prefix-sum rounding: a few float ulps of the largest value in the stream
+    bool pass = worst < 1e-5 && stateError < 1e-5;
+    printf("lowPass:           %zu samples in %zu blocks, max error %.2g, state error %.2g\n", total,
+           sizeof(counts) / sizeof(counts[0]), worst, stateError);
+    return pass;
+}
+
+static void report(const char *name, double scalar, double batch)
+{
+    printf("%-18s scalar %.2f ns/sample, SampleBlock %.2f ns/sample (%s)\n", name, scalar, batch,
+#if defined(SAMPLEBLOCK_NEON)
+           "NEON"
+#elif defined(SAMPLEBLOCK_SSE)
+           "SSE2"
+#else
+           "scalar"
+#endif
+           );
+}
+
+static void benchmark(void)
+{
+    int16_t raw[3 * BLOCK];
+    float x[BLOCK], y[BLOCK], z[BLOCK];
+    float ref[3] = { 0, 0, 0 };
+    SampleFilterState state;
+    volatile float sink = 0;
+    Block block;
+
+    fillRaw(raw, BLOCK, 7);
+
+    double t0 = nowNs();
+    for (int p = 0; p < BENCH_PASSES; p++)
+    {
+        refFromRaw(raw, BLOCK, SCALE, x, y, z);
+        for (size_t i = 0; i < BLOCK; i++)
+        {
+            x[i] *= GRAVITY;
+            y[i] *= GRAVITY;
+            z[i] *= GRAVITY;
+        }
+        sink = sink + x[BLOCK - 1] + z[p % BLOCK];
+    }
+    double scalar = (nowNs() - t0) / ((double)BENCH_PASSES * BLOCK);
+
+    t0 = nowNs();
+    for (int p = 0; p < BENCH_PASSES; p++)
+    {
+        block.fromRaw(raw, BLOCK, SCALE);
+        block.normalize(GRAVITY);
+        sink = sink + block.x[BLOCK - 1] + block.z[p % BLOCK];
+    }
+    report("fromRaw+normalize:", scalar, (nowNs() - t0) / ((double)BENCH_PASSES * BLOCK));
+
+    // The filter alone, on the converted block
+    refFromRaw(raw, BLOCK, SCALE, x, y, z);
+    t0 = nowNs();
+    for (int p = 0; p < BENCH_PASSES; p++)
+    {
+        refLowPass(ref, x, y, z, BLOCK, ALPHA);
+        sink = sink + x[BLOCK - 1] + z[p % BLOCK];
+    }
+    scalar = (nowNs() - t0) / ((double)BENCH_PASSES * BLOCK);
+
+    block.fromRaw(raw, BLOCK, SCALE);
+    t0 = nowNs();
+    for (int p = 0; p < BENCH_PASSES; p++)
+    {
+        block.lowPass(state, ALPHA);
+        sink = sink + block.x[BLOCK - 1] + block.z[p % BLOCK];
+    }
+    report("lowPass:", scalar, (nowNs() - t0) / ((double)BENCH_PASSES * BLOCK));
+}
+
+int main()
+{
+    bool pass = true;
+
+    pass &= testFromRawNormalize();
+    pass &= testLowPass();
+    benchmark();
+
+    printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
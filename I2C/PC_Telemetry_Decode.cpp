@@ -0,0 +1,365 @@
+/*
+ * Host Decoder for the Binary Telemetry Stream
+ * ==========================================
+ * Reads the COBS-framed telemetry sent by tlm_send*() (Vitis/telemetry.h)
+ * from a serial port, pty or capture file, checks CRC and sequence numbers,
+ * and writes the samples and spectra to a columnar file: a short text
+ * header listing each column (name, type, count) followed by every column
+ * as one contiguous little-endian array, e.g. for numpy:
+ *   x = np.fromfile(f, '<i2', count=n, offset=data_offset + ...)
+ *
+ * "--loopback" needs no board: it opens a pty pair, streams frames from the
+ * firmware encoder (Vitis/telemetry.c) into one end, including a corrupted
+ * frame, decodes the other end and checks what arrived. With socat the
+ * same pair can be made by hand:
+ *   socat -d -d pty,raw,echo=0 pty,raw,echo=0
+ *
+ * To compile: g++ -O2 -IVitis -DTLM_OUTBYTE=tlm_capture PC_Telemetry_Decode.cpp Vitis/telemetry.c -o telemetry_decode -lpthread
+ * To run: ./telemetry_decode /dev/ttyUSB1 capture.col [baud]
+ *         ./telemetry_decode --loopback capture.col
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <pthread.h>
+#include <string>
+#include <vector>
+#include "telemetry.h"
+
+// --- Columnar output ---
+class Column {
+public:
+    Column(const char *columnName, const char *columnType, size_t elementSize)
+        : name(columnName), type(columnType), size(elementSize), count(0){}
+
+    void add(uint32_t value){
+        for (size_t i = 0; i < size; i++){
+            data.push_back((uint8_t)(value >> (8 * i)));
+        }
+        count++;
+    }
+
+    std::string name;
+    std::string type;
+    size_t size;
+    size_t count;
+    std::vector<uint8_t> data;
+};
+
+class ColumnFile {
+public:
+    ColumnFile() :
+        sampleSeq("sample_seq", "u16", 2), sampleTime("sample_t_us", "u32", 4),
+        x("x", "i16", 2), y("y", "i16", 2), z("z", "i16", 2),
+        spectrumSeq("spectrum_seq", "u16", 2), spectrumTime("spectrum_t_us", "u32", 4),
+        spectrumFirst("spectrum_first_bin", "u16", 2), spectrumBins("spectrum_bins", "u16", 2),
+        spectrumBinMhz("spectrum_bin_mhz", "u32", 4), spectrumPower("spectrum_power", "u32", 4){}
+
+    bool write(const char *path){
+        Column *columns[] = { &sampleSeq, &sampleTime, &x, &y, &z,
+                              &spectrumSeq, &spectrumTime, &spectrumFirst, &spectrumBins,
+                              &spectrumBinMhz, &spectrumPower };
+        const size_t n = sizeof(columns) / sizeof(columns[0]);
+
+        FILE *f = fopen(path, "wb");
+        if (f == NULL){
+            perror(path);
+            return false;
+        }
+
+        fprintf(f, "TLMCOL 1\ncolumns %zu\n", n);
+        for (size_t i = 0; i < n; i++){
+            fprintf(f, "%s %s %zu\n", columns[i]->name.c_str(), columns[i]->type.c_str(), columns[i]->count);
+        }
+        fprintf(f, "end\n");
+        for (size_t i = 0; i < n; i++){
+            if (!columns[i]->data.empty()){
+                fwrite(&columns[i]->data[0], 1, columns[i]->data.size(), f);
+            }
+        }
+        fclose(f);
+        return true;
+    }
+
+    Column sampleSeq, sampleTime, x, y, z;
+    Column spectrumSeq, spectrumTime, spectrumFirst, spectrumBins, spectrumBinMhz, spectrumPower;
+};
+
+// --- Frame decoding ---
+static uint16_t get16(const uint8_t *p){
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+static uint32_t get32(const uint8_t *p){
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+class Decoder {
+public:
+    Decoder(ColumnFile &output) : frames(0), cobsErrors(0), crcErrors(0), formatErrors(0), lost(0),
+                                  out(output), expected(-1){}
+
+    // Feed raw bytes from the link; frames end at each 0x00
+    void feed(const uint8_t *bytes, size_t length){
+        for (size_t i = 0; i < length; i++){
+            if (bytes[i] != 0){
+                if (pending.size() < TLM_MAX_ENCODED){
+                    pending.push_back(bytes[i]);
+                }
+                continue;
+            }
+            if (!pending.empty()){
+                frame(&pending[0], pending.size());
+                pending.clear();
+            }
+        }
+    }
+
+    void report() const {
+        fprintf(stderr, "%lu frames, %lu COBS errors, %lu CRC errors, %lu malformed, %lu lost\n",
+                frames, cobsErrors, crcErrors, formatErrors, lost);
+    }
+
+    unsigned long frames, cobsErrors, crcErrors, formatErrors, lost;
+
+private:
+    void frame(const uint8_t *encoded, size_t length){
+        uint8_t payload[TLM_MAX_ENCODED];
+        size_t n = tlm_cobsDecode(encoded, length, payload);
+
+        if (n == 0 || n > TLM_MAX_PAYLOAD){
+            cobsErrors++;
+            return;
+        }
+        if (n < TLM_HEADER_SIZE + TLM_CRC_SIZE || tlm_crc16(payload, n - TLM_CRC_SIZE) != get16(&payload[n - TLM_CRC_SIZE])){
+            crcErrors++;
+            return;
+        }
+
+        uint16_t seq = get16(&payload[2]);
+        if (expected >= 0 && seq != expected){
+            lost += (uint16_t)(seq - expected);
+        }
+        expected = (uint16_t)(seq + 1);
+
+        uint32_t t = get32(&payload[4]);
+        const uint8_t *body = &payload[TLM_HEADER_SIZE];
+        size_t bodyLength = n - TLM_HEADER_SIZE - TLM_CRC_SIZE;
+
+        if (payload[0] == TLM_TYPE_SAMPLES && bodyLength >= 4){
+            uint16_t count = get16(&body[0]);
+            uint16_t period = get16(&body[2]);
+            if (bodyLength != 4 + 6u * count){
+                formatErrors++;
+                return;
+            }
+            for (uint16_t i = 0; i < count; i++){
+                out.sampleSeq.add(seq);
+                out.sampleTime.add(t + (uint32_t)i * period);
+                out.x.add(get16(&body[4 + 6 * i]));
+                out.y.add(get16(&body[6 + 6 * i]));
+                out.z.add(get16(&body[8 + 6 * i]));
+            }
+        } else if (payload[0] == TLM_TYPE_SPECTRUM && bodyLength >= 8){
+            uint16_t count = get16(&body[2]);
+            if (bodyLength != 8 + 4u * count){
+                formatErrors++;
+                return;
+            }
+            out.spectrumSeq.add(seq);
+            out.spectrumTime.add(t);
+            out.spectrumFirst.add(get16(&body[0]));
+            out.spectrumBins.add(count);
+            out.spectrumBinMhz.add(get32(&body[4]));
+            for (uint16_t i = 0; i < count; i++){
+                out.spectrumPower.add(get32(&body[8 + 4 * i]));
+            }
+        } else {
+            formatErrors++;
+            return;
+        }
+        frames++;
+    }
+
+    ColumnFile &out;
+    std::vector<uint8_t> pending;
+    long expected;
+};
+
+// --- Link ---
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int){
+    stopRequested = 1;
+}
+
+static speed_t baudConstant(long baud){
+    switch (baud){
+        case 9600:      return B9600;
+        case 57600:     return B57600;
+        case 230400:    return B230400;
+        case 460800:    return B460800;
+        case 921600:    return B921600;
+        default:        return B115200;
+    }
+}
+
+static int openLink(const char *path, long baud){
+    int fd = open(path, O_RDONLY | O_NOCTTY);
+    if (fd < 0){
+        perror(path);
+        return -1;
+    }
+    if (isatty(fd)){
+        struct termios tio;
+        tcgetattr(fd, &tio);
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, baudConstant(baud));
+        cfsetospeed(&tio, baudConstant(baud));
+        tio.c_cc[VMIN] = 1;
+        tio.c_cc[VTIME] = 0;
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    return fd;
+}
+
+// Read until EOF, a closed pty peer (EIO) or Ctrl-C
+static void pump(int fd, Decoder &decoder){
+    uint8_t buffer[4096];
+    while (!stopRequested){
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n <= 0){
+            break;
+        }
+        decoder.feed(buffer, (size_t)n);
+    }
+}
+
+// --- Loopback test over a pty pair ---
+#define LOOPBACK_SAMPLE_FRAMES  200
+#define LOOPBACK_SPECTRA        4
+#define LOOPBACK_BINS           512
+
+static std::vector<uint8_t> captured;
+
+// Sink for Vitis/telemetry.c (built as C++ by the g++ line above)
+void tlm_capture(uint8_t c){
+    captured.push_back(c);
+}
+
+static void *loopbackWriter(void *ref){
+    int fd = *(int *)ref;
+    int16_t xyz[3 * 32];
+    uint32_t power[LOOPBACK_BINS];
+
+    // Frames from the firmware encoder, captured and then pushed into the pty
+    for (int f = 0; f < LOOPBACK_SAMPLE_FRAMES; f++){
+        for (int i = 0; i < 32; i++){
+            xyz[3 * i + 0] = (int16_t)(f * 32 + i);
+            xyz[3 * i + 1] = (int16_t)-(f * 32 + i);
+            xyz[3 * i + 2] = 256;
+        }
+        tlm_sendSamples(f * 32 * 1250, 1250, xyz, 32);     // 800 Hz
+        if (f % (LOOPBACK_SAMPLE_FRAMES / LOOPBACK_SPECTRA) == 0){
+            for (int b = 0; b < LOOPBACK_BINS; b++){
+                power[b] = (uint32_t)(b == 10 ? 1000000 : b);
+            }
+            tlm_sendSpectrum(f * 32 * 1250, 0, 781250, power, LOOPBACK_BINS);
+        }
+        if (f == LOOPBACK_SAMPLE_FRAMES / 2){
+            // Line error in the middle of a frame: must cost exactly that frame
+            size_t start = captured.size();
+            tlm_sendSamples(0, 1250, xyz, 32);
+            captured[start + 40] = captured[start + 40] == 0x55 ? 0x56 : 0x55;
+        }
+    }
+
+    size_t off = 0;
+    while (off < captured.size()){
+        ssize_t n = write(fd, &captured[off], captured.size() - off);
+        if (n <= 0){
+            break;
+        }
+        off += (size_t)n;
+    }
+    tcdrain(fd);
+    usleep(100000);
+    close(fd);
+    return NULL;
+}
+
+static int loopback(const char *outputPath){
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0){
+        perror("posix_openpt");
+        return 1;
+    }
+
+    int slave = openLink(ptsname(master), 115200);
+    if (slave < 0){
+        return 1;
+    }
+    struct termios tio;
+    tcgetattr(master, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(master, TCSANOW, &tio);
+
+    ColumnFile file;
+    Decoder decoder(file);
+    pthread_t writer;
+    pthread_create(&writer, NULL, loopbackWriter, &master);
+    pump(slave, decoder);
+    pthread_join(writer, NULL);
+    close(slave);
+
+    decoder.report();
+    file.write(outputPath);
+
+    bool ok = file.x.count == LOOPBACK_SAMPLE_FRAMES * 32
+           && file.spectrumSeq.count == LOOPBACK_SPECTRA
+           && file.spectrumPower.count == LOOPBACK_SPECTRA * LOOPBACK_BINS
+           && decoder.crcErrors + decoder.cobsErrors == 1
+           && decoder.lost == 1;
+    for (size_t i = 0; ok && i < file.x.count; i++){
+        ok = get16(&file.x.data[2 * i]) == (uint16_t)i && get16(&file.z.data[2 * i]) == 256;
+    }
+
+    printf("loopback: %zu samples, %zu spectra -> %s: %s\n",
+           file.x.count, file.spectrumSeq.count, outputPath, ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char **argv){
+    if (argc < 3){
+        fprintf(stderr, "usage: %s <device|file> <output.col> [baud]\n"
+                        "       %s --loopback <output.col>\n", argv[0], argv[0]);
+        return 1;
+    }
+
+    if (strcmp(argv[1], "--loopback") == 0){
+        return loopback(argv[2]);
+    }
+
+    int fd = openLink(argv[1], argc > 3 ? atol(argv[3]) : 115200);
+    if (fd < 0){
+        return 1;
+    }
+
+    // No SA_RESTART, so Ctrl-C also ends a blocking read()
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = onSignal;
+    sigaction(SIGINT, &action, NULL);
+
+    ColumnFile file;
+    Decoder decoder(file);
+    pump(fd, decoder);
+    close(fd);
+
+    decoder.report();
+    return file.write(argv[2]) ? 0 : 1;
+}
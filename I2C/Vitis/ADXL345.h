@@ -22,6 +22,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define ADXL345_h
 
 #include <stdint.h>
+#include <stddef.h>
 #include "axiWire.hpp"
 
 #define ADXL345_ADDRESS              (0x53)
@@ -56,6 +57,17 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define ADXL345_REG_FIFO_CTL         (0x38)
 #define ADXL345_REG_FIFO_STATUS      (0x39)
 
+// Register window mirrored by the configuration shadow (see ADXL345::resync)
+#define ADXL345_SHADOW_FIRST         ADXL345_REG_THRESH_TAP
+#define ADXL345_SHADOW_SIZE          (ADXL345_REG_FIFO_CTL - ADXL345_REG_THRESH_TAP + 1)
+
+// Nominal scale factor: 4 mg/LSB in full resolution; in 10-bit mode it
+// doubles with every range step (2g: 4, 4g: 8, 8g: 16, 16g: 32 mg/LSB)
+#define ADXL345_MG_PER_LSB           4
+
+// Hardware FIFO depth in samples (FIFO_STATUS entries may read 32 + 1 output register)
+#define ADXL345_FIFO_DEPTH           32
+
 #define ADXL345_GRAVITY_SUN          273.95f
 #define ADXL345_GRAVITY_EARTH        9.80665f
 #define ADXL345_GRAVITY_MOON         1.622f
@@ -100,6 +112,14 @@ typedef enum
     ADXL345_OVERRUN            = 0x00
 } adxl345_activity_t;
 
+typedef enum
+{
+    ADXL345_FIFO_TRIGGER       = 0b11,
+    ADXL345_FIFO_STREAM        = 0b10,
+    ADXL345_FIFO_FIFO          = 0b01,
+    ADXL345_FIFO_BYPASS        = 0b00
+} adxl345_fifoMode_t;
+
 typedef enum
 {
     ADXL345_RANGE_16G          = 0b11,
@@ -124,6 +144,71 @@ struct Vectori
 };
 #endif
 
+// Conversion factors for a fixed range/resolution, folded at compile time.
+// Integer (mg, Q16.16) and float paths never touch double, e.g.
+//   typedef ADXL345Scale<ADXL345_RANGE_2G> Scale;
+//   Vectori mg = Scale::toMilliG(mpu.readRaw());
+template <adxl345_range_t Range, bool FullRes = true>
+struct ADXL345Scale
+{
+    // mg per LSB
+    static constexpr int32_t milliGPerLsb() { return FullRes ? ADXL345_MG_PER_LSB : ADXL345_MG_PER_LSB << Range; }
+    // g per LSB in Q16.16 (rounded)
+    static constexpr int32_t gPerLsbQ16() { return ((milliGPerLsb() << 16) + 500) / 1000; }
+    // g per LSB
+    static constexpr float gPerLsb() { return milliGPerLsb() * 0.001f; }
+    // m/s^2 per LSB
+    static constexpr float msPerLsb() { return gPerLsb() * ADXL345_GRAVITY_EARTH; }
+
+    static inline Vectori toMilliG(const Vectori &raw)
+    {
+        Vectori v = { raw.XAxis * milliGPerLsb(), raw.YAxis * milliGPerLsb(), raw.ZAxis * milliGPerLsb() };
+        return v;
+    }
+    static inline Vectori toQ16(const Vectori &raw)
+    {
+        Vectori v = { raw.XAxis * gPerLsbQ16(), raw.YAxis * gPerLsbQ16(), raw.ZAxis * gPerLsbQ16() };
+        return v;
+    }
+    static inline Vector toG(const Vectori &raw)
+    {
+        Vector v = { raw.XAxis * gPerLsb(), raw.YAxis * gPerLsb(), raw.ZAxis * gPerLsb() };
+        return v;
+    }
+    static inline Vector toMs2(const Vectori &raw)
+    {
+        Vector v = { raw.XAxis * msPerLsb(), raw.YAxis * msPerLsb(), raw.ZAxis * msPerLsb() };
+        return v;
+    }
+};
+
+// Complete device configuration, applied in batched register writes by ADXL345::apply
+struct ADXL345Config
+{
+    adxl345_range_t range;
+    adxl345_dataRate_t dataRate;
+    bool fullResolution;
+    uint8_t tapThreshold;           // THRESH_TAP (62.5mg / LSB)
+    int8_t offsetX;                 // OFSX (15.6mg / LSB)
+    int8_t offsetY;                 // OFSY (15.6mg / LSB)
+    int8_t offsetZ;                 // OFSZ (15.6mg / LSB)
+    uint8_t tapDuration;            // DUR (625us / LSB)
+    uint8_t doubleTapLatency;       // LATENT (1.25ms / LSB)
+    uint8_t doubleTapWindow;        // WINDOW (1.25ms / LSB)
+    uint8_t activityThreshold;      // THRESH_ACT (62.5mg / LSB)
+    uint8_t inactivityThreshold;    // THRESH_INACT (62.5mg / LSB)
+    uint8_t timeInactivity;         // TIME_INACT (1s / LSB)
+    uint8_t actInactControl;        // ACT_INACT_CTL (axis enables, AC/DC)
+    uint8_t freeFallThreshold;      // THRESH_FF (62.5mg / LSB)
+    uint8_t freeFallDuration;       // TIME_FF (5ms / LSB)
+    uint8_t tapAxes;                // TAP_AXES (axis enables, suppress)
+    uint8_t intEnable;              // INT_ENABLE
+    uint8_t intMap;                 // INT_MAP (1 = INT2)
+    adxl345_fifoMode_t fifoMode;
+    uint8_t fifoWatermark;
+    adxl345_int_t fifoTrigger;
+};
+
 struct Activites
 {
     bool isOverrun;
@@ -147,15 +232,22 @@ class ADXL345
     public:
 
 	bool begin(AxiWire *axiWire_handler);
+	bool begin(AxiWire *axiWire_handler, const ADXL345Config &config);
 	void clearSettings(void);
+	bool resync(void);
+
+	static ADXL345Config defaultConfig(void);
+	bool apply(const ADXL345Config &config);
 
 	Vectori readRaw(void);
+	size_t readRawInto(int16_t *dst, size_t n);
 	Vector readNormalize(float gravityFactor = ADXL345_GRAVITY_EARTH);
 	Vector readScaled(void);
+	Vectori readMilliG(void);
 
 	Activites readActivites(void);
 
-	Vector lowPassFilter(Vector vector, float alpha = 0.5);
+	Vector lowPassFilter(Vector vector, float alpha = 0.5f);
 
 	void  setRange(adxl345_range_t range);
 	adxl345_range_t getRange(void);
@@ -163,6 +255,12 @@ class ADXL345
 	void  setDataRate(adxl345_dataRate_t dataRate);
 	adxl345_dataRate_t getDataRate(void);
 
+	void setFifoMode(adxl345_fifoMode_t mode, uint8_t watermark = 16, adxl345_int_t trigger = ADXL345_INT1);
+	adxl345_fifoMode_t getFifoMode(void);
+	uint8_t getFifoWatermark(void);
+	uint8_t getFifoEntries(void);
+	size_t drainFifo(int16_t *xyz, size_t max);
+
 	void setTapThreshold(float threshold);
 	float getTapThreshold(void);
 
@@ -217,7 +315,7 @@ class ADXL345
 	void useInterrupt(adxl345_int_t interrupt);
 
     void readADXL345(int16_t *x, int16_t *y, int16_t *z);
-    void writeRegister8(uint8_t reg, uint8_t value);
+    bool writeRegister8(uint8_t reg, uint8_t value);
 
 
     private:
@@ -230,12 +328,24 @@ class ADXL345
 	Vector f;
 	Activites a;
 	adxl345_range_t _range;
+	// current g/LSB and mg/LSB, follow DATA_FORMAT
+	float _scale;
+	int32_t _milliGPerLsb;
+	// write-through copy of the configuration registers
+	uint8_t shadow[ADXL345_SHADOW_SIZE];
+	bool shadowValid;
 
 	uint8_t readRegister8(uint8_t reg);
 	uint8_t fastRegister8(uint8_t reg);
+	bool fastRegister8(uint8_t reg, uint8_t *value);
 	int16_t readRegister16(uint8_t reg);
+	unsigned int readRegisters(uint8_t reg, uint8_t *buffer, unsigned int length);
+	unsigned int writeRegisters(uint8_t reg, const uint8_t *buffer, unsigned int length);
 	void writeRegisterBit(uint8_t reg, uint8_t pos, bool state);
 	bool readRegisterBit(uint8_t reg, uint8_t pos);
+	static bool isShadowed(uint8_t reg);
+	void updateScale(void);
+	static void buildImage(const ADXL345Config &config, uint8_t *image);
 
 
 };
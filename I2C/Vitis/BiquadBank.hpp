@@ -0,0 +1,212 @@
+/*
+BiquadBank.hpp - Cascaded biquad (second-order section) filters for SampleBlock.
+
+Coefficients come either from an offline design tool (scipy.signal
+iirfilter(..., output='sos'), normalised so a0 = 1) or from the constexpr
+RBJ designer below, which folds to constants when its arguments are
+constant:
+    constexpr BiquadCoeffs aa = BiquadDesign::lowPass(3200.0, 400.0, 0.7071);
+
+BiquadCascade<S> runs S sections in transposed direct form II. Each
+section keeps separate state for x, y and z, and the three axes are
+processed together in one 4-lane vector (NEON / SSE2 / scalar, as in
+SampleBlock). A bank is simply several cascades fed from the same block:
+    BiquadCascade<2> dcBlock, antiAlias;
+    SampleBlock<32> hp = block;
+    dcBlock.process(hp);
+    antiAlias.process(block);
+    antiAlias.decimate(block, 4);   // anti-aliased, 4x fewer samples for the FFT
+*/
+
+#ifndef BIQUADBANK_h
+#define BIQUADBANK_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include "SampleBlock.hpp"
+
+// b0 + b1 z^-1 + b2 z^-2 / 1 + a1 z^-1 + a2 z^-2
+struct BiquadCoeffs
+{
+    float b0, b1, b2;
+    float a1, a2;
+};
+
+// RBJ audio-EQ-cookbook designs (f0 and fs in Hz). Evaluated in double at
+// compile time; avoid calling with run-time arguments on the MicroBlaze.
+namespace BiquadDesign
+{
+    constexpr double PI = 3.14159265358979323846;
+
+    constexpr double sinSeries(double x2, double term, int n, double sum)
+    {
+        return n > 12 ? sum : sinSeries(x2, -term * x2 / ((2 * n) * (2 * n + 1)), n + 1, sum + term);
+    }
+    // |x| <= pi
+    constexpr double sin(double x) { return sinSeries(x * x, x, 1, 0.0); }
+    // 0 <= x <= pi
+    constexpr double cos(double x) { return sin(PI / 2 - x); }
+
+    constexpr double omega(double fs, double f0) { return 2.0 * PI * f0 / fs; }
+    constexpr double alpha(double fs, double f0, double q) { return sin(omega(fs, f0)) / (2.0 * q); }
+
+    constexpr BiquadCoeffs normalise(double b0, double b1, double b2, double a0, double a1, double a2)
+    {
+        return BiquadCoeffs{ (float)(b0 / a0), (float)(b1 / a0), (float)(b2 / a0), (float)(a1 / a0), (float)(a2 / a0) };
+    }
+
+    constexpr BiquadCoeffs lowPass(double fs, double f0, double q)
+    {
+        return normalise((1.0 - cos(omega(fs, f0))) / 2.0, 1.0 - cos(omega(fs, f0)), (1.0 - cos(omega(fs, f0))) / 2.0,
+                         1.0 + alpha(fs, f0, q), -2.0 * cos(omega(fs, f0)), 1.0 - alpha(fs, f0, q));
+    }
+
+    constexpr BiquadCoeffs highPass(double fs, double f0, double q)
+    {
+        return normalise((1.0 + cos(omega(fs, f0))) / 2.0, -(1.0 + cos(omega(fs, f0))), (1.0 + cos(omega(fs, f0))) / 2.0,
+                         1.0 + alpha(fs, f0, q), -2.0 * cos(omega(fs, f0)), 1.0 - alpha(fs, f0, q));
+    }
+
+    // Constant 0 dB peak gain at f0
+    constexpr BiquadCoeffs bandPass(double fs, double f0, double q)
+    {
+        return normalise(alpha(fs, f0, q), 0.0, -alpha(fs, f0, q),
+                         1.0 + alpha(fs, f0, q), -2.0 * cos(omega(fs, f0)), 1.0 - alpha(fs, f0, q));
+    }
+
+    constexpr BiquadCoeffs passThrough(void)
+    {
+        return BiquadCoeffs{ 1.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    }
+}
+
+template <size_t Sections>
+class BiquadCascade
+{
+    public:
+
+    BiquadCascade() : phase(0)
+    {
+        for (size_t s = 0; s < Sections; s++)
+        {
+            c[s] = BiquadDesign::passThrough();
+        }
+        reset();
+    }
+
+    void setSection(size_t section, const BiquadCoeffs &coeffs)
+    {
+        c[section] = coeffs;
+    }
+
+    // Clear the filter history and the decimation phase
+    void reset(void)
+    {
+        for (size_t s = 0; s < Sections; s++)
+        {
+            for (int k = 0; k < 4; k++)
+            {
+                z1[s][k] = 0;
+                z2[s][k] = 0;
+            }
+        }
+        phase = 0;
+    }
+
+    // Filter the block in place
+    template <size_t N>
+    void process(SampleBlock<N> &block)
+    {
+        for (size_t i = 0; i < block.count; i++)
+        {
+            alignas(16) float v[4] = { block.x[i], block.y[i], block.z[i], 0.0f };
+            step(v);
+            block.x[i] = v[0];
+            block.y[i] = v[1];
+            block.z[i] = v[2];
+        }
+    }
+
+    // Keep every factor-th sample (in place); the phase carries across blocks.
+    // Returns the new count, or 0 with the block untouched if factor is 0.
+    template <size_t N>
+    size_t decimate(SampleBlock<N> &block, unsigned int factor)
+    {
+        size_t out = 0;
+
+        if (factor == 0)
+        {
+            return 0;
+        }
+
+        for (size_t i = 0; i < block.count; i++)
+        {
+            if (phase == 0)
+            {
+                block.x[out] = block.x[i];
+                block.y[out] = block.y[i];
+                block.z[out] = block.z[i];
+                out++;
+            }
+            phase = (phase + 1) % factor;
+        }
+
+        block.count = out;
+        return out;
+    }
+
+    private:
+
+    // One input sample (x, y, z, pad) through every section, TDF-II:
+    //   y = b0 x + z1;  z1 = b1 x - a1 y + z2;  z2 = b2 x - a2 y
+    void step(float *v)
+    {
+#if defined(SAMPLEBLOCK_NEON)
+        float32x4_t x = vld1q_f32(v);
+        for (size_t s = 0; s < Sections; s++)
+        {
+            float32x4_t s1 = vld1q_f32(z1[s]);
+            float32x4_t s2 = vld1q_f32(z2[s]);
+            float32x4_t y = vmlaq_n_f32(s1, x, c[s].b0);
+            s1 = vmlsq_n_f32(vmlaq_n_f32(s2, x, c[s].b1), y, c[s].a1);
+            s2 = vmlsq_n_f32(vmulq_n_f32(x, c[s].b2), y, c[s].a2);
+            vst1q_f32(z1[s], s1);
+            vst1q_f32(z2[s], s2);
+            x = y;
+        }
+        vst1q_f32(v, x);
+#elif defined(SAMPLEBLOCK_SSE)
+        __m128 x = _mm_load_ps(v);
+        for (size_t s = 0; s < Sections; s++)
+        {
+            __m128 s1 = _mm_load_ps(z1[s]);
+            __m128 s2 = _mm_load_ps(z2[s]);
+            __m128 y = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(c[s].b0)), s1);
+            s1 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(c[s].b1)), s2), _mm_mul_ps(y, _mm_set1_ps(c[s].a1)));
+            s2 = _mm_sub_ps(_mm_mul_ps(x, _mm_set1_ps(c[s].b2)), _mm_mul_ps(y, _mm_set1_ps(c[s].a2)));
+            _mm_store_ps(z1[s], s1);
+            _mm_store_ps(z2[s], s2);
+            x = y;
+        }
+        _mm_store_ps(v, x);
+#else
+        for (size_t s = 0; s < Sections; s++)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                float y = c[s].b0 * v[k] + z1[s][k];
+                z1[s][k] = (c[s].b1 * v[k] + z2[s][k]) - c[s].a1 * y;
+                z2[s][k] = c[s].b2 * v[k] - c[s].a2 * y;
+                v[k] = y;
+            }
+        }
+#endif
+    }
+
+    BiquadCoeffs c[Sections];
+    alignas(16) float z1[Sections][4];
+    alignas(16) float z2[Sections][4];
+    unsigned int phase;
+};
+
+#endif
@@ -0,0 +1,117 @@
+/*
+SampleRing.hpp - Wait-free single-producer / single-consumer ring.
+
+One side (typically an interrupt handler) writes, the other (the main
+loop) reads; neither ever blocks or masks interrupts. The producer only
+writes tail, the consumer only writes head, and each index is published
+with release / read with acquire ordering so the slot contents are visible
+before the index that hands them over (also on the A53, where plain stores
+may be reordered).
+
+N must be a power of two; the indices run freely and wrap at 2^32.
+
+Producer (ISR), either copying:
+    ring.push(sample);
+or filling the slot in place (e.g. as the target of a bus transfer):
+    AccelSample *slot = ring.claim();   // NULL when full, counted as overflow
+    ... fill *slot ...
+    ring.publish();
+Consumer (main loop):
+    AccelSample batch[16];
+    size_t n = ring.pop(batch, 16);
+*/
+
+#ifndef SAMPLERING_h
+#define SAMPLERING_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Raw ADXL345 sample (LSB), as decoded from DATAX0..DATAZ1
+struct AccelSample
+{
+    int16_t x, y, z;
+};
+
+template <class T, size_t N>
+class SampleRing
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SampleRing size must be a power of two");
+
+    public:
+
+    SampleRing() : head(0), tail(0), overflow(0) {}
+
+    // --- Producer side ---
+
+    // Next free slot, or NULL (and one overflow counted) when the ring is full.
+    // Repeated calls without publish() return the same slot.
+    T *claim(void)
+    {
+        uint32_t t = tail;
+        if (t - __atomic_load_n(&head, __ATOMIC_ACQUIRE) >= N)
+        {
+            overflow = overflow + 1;
+            return NULL;
+        }
+        return &slots[t & (N - 1)];
+    }
+
+    // Hand the claimed slot to the consumer
+    void publish(void)
+    {
+        __atomic_store_n(&tail, tail + 1, __ATOMIC_RELEASE);
+    }
+
+    bool push(const T &value)
+    {
+        T *slot = claim();
+        if (slot == NULL)
+        {
+            return false;
+        }
+        *slot = value;
+        publish();
+        return true;
+    }
+
+    // --- Consumer side ---
+
+    // Copy up to max entries out in FIFO order; returns the number copied
+    size_t pop(T *dst, size_t max)
+    {
+        uint32_t h = head;
+        uint32_t n = __atomic_load_n(&tail, __ATOMIC_ACQUIRE) - h;
+
+        if (n > max)
+        {
+            n = (uint32_t)max;
+        }
+        for (uint32_t i = 0; i < n; i++)
+        {
+            dst[i] = slots[(h + i) & (N - 1)];
+        }
+
+        __atomic_store_n(&head, h + n, __ATOMIC_RELEASE);
+        return n;
+    }
+
+    size_t available(void) const
+    {
+        return __atomic_load_n(&tail, __ATOMIC_ACQUIRE) - __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+    }
+
+    static size_t capacity(void) { return N; }
+
+    // Samples refused because the ring was full (written by the producer only)
+    uint32_t overflows(void) const { return overflow; }
+
+    private:
+
+    T slots[N];
+    uint32_t head;
+    uint32_t tail;
+    volatile uint32_t overflow;
+};
+
+#endif
@@ -0,0 +1,91 @@
+/*
+deferLog.c - Drain side of the deferred binary logger (see deferLog.h).
+*/
+
+#include "deferLog.h"
+
+// Byte sink for the frames: the standalone BSP's UART, unless the build
+// names its own function with -DDLOG_OUTBYTE=name
+#ifdef DLOG_OUTBYTE
+void DLOG_OUTBYTE(uint8_t c);
+#else
+#include "xil_printf.h"
+#define DLOG_OUTBYTE(c)     outbyte((char)(c))
+#endif
+
+dlog_state_t dlog_state;
+
+static uint8_t dlog_txSeq;
+static uint32_t dlog_reported;
+
+static void dlog_send(uint16_t id, uint16_t nargs, const uint32_t *arg)
+{
+    uint8_t frame[5 + 4 * DLOG_MAX_ARGS + 1];
+    uint8_t sum = 0;
+    unsigned int length = 0;
+    unsigned int i;
+
+    frame[length++] = DLOG_SYNC;
+    frame[length++] = (uint8_t)id;
+    frame[length++] = (uint8_t)(id >> 8);
+    frame[length++] = dlog_txSeq++;
+    frame[length++] = (uint8_t)nargs;
+
+    for (i = 0; i < nargs; i++)
+    {
+        frame[length++] = (uint8_t)arg[i];
+        frame[length++] = (uint8_t)(arg[i] >> 8);
+        frame[length++] = (uint8_t)(arg[i] >> 16);
+        frame[length++] = (uint8_t)(arg[i] >> 24);
+    }
+
+    for (i = 1; i < length; i++)
+    {
+        sum += frame[i];
+    }
+    frame[length++] = (uint8_t)(0 - sum);
+
+    for (i = 0; i < length; i++)
+    {
+        DLOG_OUTBYTE(frame[i]);
+    }
+}
+
+unsigned int dlog_drain(unsigned int max)
+{
+    uint32_t r = dlog_state.read;
+    unsigned int sent = 0;
+    uint32_t dropped = __atomic_load_n(&dlog_state.dropped, __ATOMIC_RELAXED);
+
+    if (dropped != dlog_reported)
+    {
+        uint32_t lost = dropped - dlog_reported;
+        dlog_reported = dropped;
+        dlog_send(DLOG_LOG_DROPPED, 1, &lost);
+    }
+
+    while (sent < max)
+    {
+        dlog_record_t *rec = &dlog_state.slots[r & (DLOG_DEPTH - 1)];
+
+        // Stop at the first record still being written
+        if (__atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE) != r + 1)
+        {
+            break;
+        }
+
+        dlog_send(rec->id, rec->nargs, rec->arg);
+        r++;
+        sent++;
+
+        // Free the slot for the producers
+        __atomic_store_n(&dlog_state.read, r, __ATOMIC_RELEASE);
+    }
+
+    return sent;
+}
+
+unsigned int dlog_pending(void)
+{
+    return __atomic_load_n(&dlog_state.write, __ATOMIC_ACQUIRE) - __atomic_load_n(&dlog_state.read, __ATOMIC_ACQUIRE);
+}
@@ -3,8 +3,20 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "ADXL345.h"
+#include "deferLog.h"
+#include "telemetry.h"
+#include "xtime_l.h"
+#include "xil_printf.h"
 #include <sleep.h>
 
+// 1: stream every sample as binary telemetry (PC_Telemetry_Decode.cpp)
+// 0: log one sample every 200 ms as text (PC_DeferLog_Decode.c)
+#ifndef EXAMPLE_TELEMETRY
+#define EXAMPLE_TELEMETRY   0
+#endif
+
+#define STREAM_WATERMARK    16
+
 
 // Launch the serial port in setup
 int main() {
@@ -21,29 +33,44 @@ int main() {
   		xil_printf("initialization successful!");
 	}
 
+#if EXAMPLE_TELEMETRY
+	// 800 Hz into the FIFO; one frame per watermark
+	ADXL345Config config = ADXL345::defaultConfig();
+	config.dataRate = ADXL345_DATARATE_800HZ;
+	config.fifoMode = ADXL345_FIFO_STREAM;
+	config.fifoWatermark = STREAM_WATERMARK;
+	mpu.apply(config);
+
+	outbyte(0);	// ends the start-up text, so the first frame decodes
+
+	int16_t xyz[3 * ADXL345_FIFO_DEPTH];
+
+	while(1){
+		if (mpu.getFifoEntries() < STREAM_WATERMARK) {
+			continue;
+		}
+
+		XTime now;
+		XTime_GetTime(&now);
+		size_t n = mpu.drainFifo(xyz, ADXL345_FIFO_DEPTH);
+
+		// Timestamp of the oldest sample in the burst
+		uint32_t t_us = (uint32_t)(now / (COUNTS_PER_SECOND / 1000000)) - (uint32_t)(n - 1) * 1250;
+		tlm_sendSamples(t_us, 1250, xyz, (uint16_t)n);
+	}
+#else
 	// infinite loop
 	while(1){
 	
         vetor = mpu.readScaled();
 
-        int AccelX_int = (int)vetor.XAxis;
-        int AccelX_frac = abs((vetor.XAxis - (int)vetor.XAxis)*1000);
-        int AccelY_int = (int)vetor.YAxis;
-        int AccelY_frac = abs((vetor.YAxis - (int)vetor.YAxis)*1000);
-        int AccelZ_int = (int)vetor.ZAxis;
-        int AccelZ_frac = abs((vetor.ZAxis - (int)vetor.ZAxis)*1000);
-
-		xil_printf("\033[2J");  // Clears the screen
-    	xil_printf("\033[1A");  // Moves the cursor up three lines
-
-		// Send integer and fractional parts using xil_printf
-		xil_printf("AccelX: %d.%03d, AccelY: %d.%03d, AccelZ: %d.%03d\r\n",
-				AccelX_int, AccelX_frac,
-				AccelY_int, AccelY_frac,
-				AccelZ_int, AccelZ_frac);
+		// Queue the sample; the text is rendered on the PC (PC_DeferLog_Decode.c)
+		DLOG3(DLOG_ACCEL_G, dlog_f(vetor.XAxis), dlog_f(vetor.YAxis), dlog_f(vetor.ZAxis));
+		dlog_drain(DLOG_DEPTH);
 
 		usleep(200000);
 
 	}
+#endif
 	return 0;
-}
+}
\ No newline at end of file
@@ -0,0 +1,199 @@
+/*
+telemetry.c - Frame building, CRC and COBS for telemetry.h.
+*/
+
+#include "telemetry.h"
+
+// Byte sink for encoded frames: the standalone BSP's UART, unless the build
+// names its own function with -DTLM_OUTBYTE=name
+#ifdef TLM_OUTBYTE
+void TLM_OUTBYTE(uint8_t c);
+#else
+#include "xil_printf.h"
+#define TLM_OUTBYTE(c)      outbyte((char)(c))
+#endif
+
+static uint16_t tlm_txSeq;
+
+static void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), bitwise to stay table-free
+uint16_t tlm_crc16(const uint8_t *data, size_t length)
+{
+    uint16_t crc = 0xFFFF;
+    size_t i;
+    int b;
+
+    for (i = 0; i < length; i++)
+    {
+        crc ^= (uint16_t)data[i] << 8;
+        for (b = 0; b < 8; b++)
+        {
+            crc = crc & 0x8000 ? (uint16_t)(crc << 1) ^ 0x1021 : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+size_t tlm_cobsEncode(const uint8_t *src, size_t length, uint8_t *dst)
+{
+    size_t code = 0;        // position of the current block's code byte
+    size_t out = 1;
+    uint8_t run = 1;
+    size_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        if (src[i] != 0)
+        {
+            dst[out++] = src[i];
+            run++;
+        }
+
+        if (src[i] == 0 || run == 0xFF)
+        {
+            dst[code] = run;
+            code = out++;
+            run = 1;
+        }
+    }
+
+    dst[code] = run;
+    return out;
+}
+
+size_t tlm_cobsDecode(const uint8_t *src, size_t length, uint8_t *dst)
+{
+    size_t in = 0;
+    size_t out = 0;
+
+    while (in < length)
+    {
+        uint8_t run = src[in++];
+        uint8_t i;
+
+        if (run == 0 || in + run - 1 > length)
+        {
+            return 0;
+        }
+        for (i = 1; i < run; i++)
+        {
+            if (src[in] == 0)
+            {
+                return 0;
+            }
+            dst[out++] = src[in++];
+        }
+
+        // A short block stands for a zero, except at the very end
+        if (run != 0xFF && in < length)
+        {
+            dst[out++] = 0;
+        }
+    }
+
+    return out;
+}
+
+static size_t tlm_header(uint8_t *frame, uint8_t type, uint16_t seq, uint32_t timestamp_us)
+{
+    frame[0] = type;
+    frame[1] = 0;
+    put16(&frame[2], seq);
+    put32(&frame[4], timestamp_us);
+    return TLM_HEADER_SIZE;
+}
+
+static size_t tlm_finish(uint8_t *frame, size_t length)
+{
+    put16(&frame[length], tlm_crc16(frame, length));
+    return length + TLM_CRC_SIZE;
+}
+
+size_t tlm_buildSamples(uint8_t *frame, uint16_t seq, uint32_t timestamp_us, uint16_t period_us,
+                        const int16_t *xyz, uint16_t count)
+{
+    size_t length = tlm_header(frame, TLM_TYPE_SAMPLES, seq, timestamp_us);
+    unsigned int i;
+
+    if (count > TLM_MAX_SAMPLES)
+    {
+        count = TLM_MAX_SAMPLES;
+    }
+
+    put16(&frame[length], count);
+    put16(&frame[length + 2], period_us);
+    length += 4;
+
+    for (i = 0; i < 3u * count; i++)
+    {
+        put16(&frame[length], (uint16_t)xyz[i]);
+        length += 2;
+    }
+
+    return tlm_finish(frame, length);
+}
+
+size_t tlm_buildSpectrum(uint8_t *frame, uint16_t seq, uint32_t timestamp_us, uint16_t first_bin,
+                         uint32_t bin_mhz, const uint32_t *power, uint16_t count)
+{
+    size_t length = tlm_header(frame, TLM_TYPE_SPECTRUM, seq, timestamp_us);
+    unsigned int i;
+
+    if (count > TLM_MAX_BINS)
+    {
+        count = TLM_MAX_BINS;
+    }
+
+    put16(&frame[length], first_bin);
+    put16(&frame[length + 2], count);
+    put32(&frame[length + 4], bin_mhz);
+    length += 8;
+
+    for (i = 0; i < count; i++)
+    {
+        put32(&frame[length], power[i]);
+        length += 4;
+    }
+
+    return tlm_finish(frame, length);
+}
+
+static void tlm_send(const uint8_t *frame, size_t length)
+{
+    static uint8_t encoded[TLM_MAX_ENCODED];
+    size_t n = tlm_cobsEncode(frame, length, encoded);
+    size_t i;
+
+    for (i = 0; i < n; i++)
+    {
+        TLM_OUTBYTE(encoded[i]);
+    }
+    TLM_OUTBYTE(0);
+}
+
+void tlm_sendSamples(uint32_t timestamp_us, uint16_t period_us, const int16_t *xyz, uint16_t count)
+{
+    static uint8_t frame[TLM_MAX_PAYLOAD];
+    tlm_send(frame, tlm_buildSamples(frame, tlm_txSeq++, timestamp_us, period_us, xyz, count));
+}
+
+void tlm_sendSpectrum(uint32_t timestamp_us, uint16_t first_bin, uint32_t bin_mhz,
+                      const uint32_t *power, uint16_t count)
+{
+    static uint8_t frame[TLM_MAX_PAYLOAD];
+    tlm_send(frame, tlm_buildSpectrum(frame, tlm_txSeq++, timestamp_us, first_bin, bin_mhz, power, count));
+}
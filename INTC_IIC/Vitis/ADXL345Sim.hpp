@@ -0,0 +1,304 @@
+/*
+ADXL345Sim.hpp - Host emulation of the ADXL345 for the AXIWIRE_HOST bus.
+
+Models the register file with I2C auto-increment, sample generation at the
+BW_RATE output data rate, the 32-entry FIFO (bypass, FIFO, stream and
+trigger modes), FIFO_STATUS and the DATA_READY / WATERMARK / OVERRUN bits
+of INT_SOURCE. Time comes from the bus model's virtual clock, so bus time
+spent by the driver shows up as elapsed sensor time.
+
+Usage:
+    SimADXL345 sensor;
+    simIicBus(0).attach(&sensor);
+    AxiWire wire(0);
+    ADXL345 mpu;
+    mpu.begin(&wire);
+*/
+
+#ifndef ADXL345SIM_h
+#define ADXL345SIM_h
+
+#include <stdint.h>
+#include <math.h>
+#include "ADXL345.h"
+#include "axiWireSim.hpp"
+
+// FIFO plus the output data registers
+#define ADXL345_SIM_FIFO_SLOTS       (ADXL345_FIFO_DEPTH + 1)
+
+class SimADXL345 : public SimIicDevice
+{
+    public:
+
+    // Produces the raw (LSB) x, y, z sample for time t_ns
+    typedef void (*Source)(void *ref, uint64_t t_ns, int16_t *xyz);
+
+    SimADXL345(unsigned int address = ADXL345_ADDRESS)
+        : _address(address), source(defaultSource), sourceRef(NULL)
+    {
+        powerOn();
+    }
+
+    // Register reset values, empty FIFO
+    void powerOn(void)
+    {
+        for (unsigned int i = 0; i < sizeof(regs); i++)
+        {
+            regs[i] = 0;
+        }
+        regs[ADXL345_REG_DEVID] = 0xE5;
+        regs[ADXL345_REG_BW_RATE] = ADXL345_DATARATE_100HZ;
+
+        for (unsigned int i = 0; i < ADXL345_SIM_FIFO_SLOTS; i++)
+        {
+            fifo[i][0] = 0;
+            fifo[i][1] = 0;
+            fifo[i][2] = 0;
+        }
+
+        pointer = 0;
+        fifoHead = 0;
+        fifoCount = 0;
+        overrun = false;
+        nextSample = 0;
+        generated = 0;
+        dropped = 0;
+        consumed = 0;
+    }
+
+    void setSource(Source callback, void *ref)
+    {
+        source = callback;
+        sourceRef = ref;
+    }
+
+    unsigned int address() const
+    {
+        return _address;
+    }
+
+    unsigned int write(const unsigned char *buffer, unsigned int length, uint64_t now_ns)
+    {
+        update(now_ns);
+
+        if (length == 0)
+        {
+            return 0;
+        }
+
+        pointer = buffer[0] & 0x3F;
+
+        for (unsigned int i = 1; i < length; i++)
+        {
+            writeRegister(pointer, buffer[i], now_ns);
+            pointer = (pointer + 1) & 0x3F;
+        }
+
+        return length;
+    }
+
+    unsigned int read(unsigned char *buffer, unsigned int length, uint64_t now_ns)
+    {
+        bool touchedData = false;
+
+        update(now_ns);
+
+        for (unsigned int i = 0; i < length; i++)
+        {
+            buffer[i] = readRegister(pointer);
+            touchedData = touchedData || (pointer >= ADXL345_REG_DATAX0 && pointer <= ADXL345_REG_DATAZ1);
+            pointer = (pointer + 1) & 0x3F;
+        }
+
+        // Reading the data registers pops the oldest entry (and clears OVERRUN)
+        if (touchedData && fifoCount > 0)
+        {
+            fifoHead = (fifoHead + 1) % ADXL345_SIM_FIFO_SLOTS;
+            fifoCount--;
+            consumed++;
+            overrun = false;
+        }
+
+        return length;
+    }
+
+    // Generate every sample due up to now_ns
+    void update(uint64_t now_ns)
+    {
+        if (!measuring())
+        {
+            return;
+        }
+
+        while (nextSample <= now_ns)
+        {
+            int16_t xyz[3];
+            source(sourceRef, nextSample, xyz);
+            push(xyz);
+            nextSample += period();
+        }
+    }
+
+    // Output data rate period for the current BW_RATE
+    uint64_t period(void) const
+    {
+        // 3200 Hz = 312.5 us, halving per rate code step
+        return 312500ull << (ADXL345_DATARATE_3200HZ - (regs[ADXL345_REG_BW_RATE] & 0x0F));
+    }
+
+    uint64_t samplesGenerated(void) const { return generated; }
+    uint64_t samplesDropped(void) const { return dropped; }
+    uint64_t samplesConsumed(void) const { return consumed; }
+    unsigned int fifoEntries(void) const { return fifoCount; }
+
+    // 10 Hz, 0.25 g sine on X and 1 g on Z (4 mg/LSB)
+    static void defaultSource(void *ref, uint64_t t_ns, int16_t *xyz)
+    {
+        (void)ref;
+        xyz[0] = (int16_t)(64.0 * sin(2.0 * M_PI * 10.0 * (double)t_ns * 1e-9));
+        xyz[1] = 0;
+        xyz[2] = 256;
+    }
+
+    private:
+
+    bool measuring(void) const
+    {
+        return (regs[ADXL345_REG_POWER_CTL] & 0x08) != 0;
+    }
+
+    uint8_t fifoMode(void) const
+    {
+        return (regs[ADXL345_REG_FIFO_CTL] >> 6) & 0x03;
+    }
+
+    unsigned int depth(void) const
+    {
+        // Bypass keeps only the data registers
+        return fifoMode() == ADXL345_FIFO_BYPASS ? 1 : ADXL345_SIM_FIFO_SLOTS;
+    }
+
+    void push(const int16_t *xyz)
+    {
+        generated++;
+
+        if (fifoCount >= depth())
+        {
+            overrun = true;
+            dropped++;
+
+            // FIFO mode stops collecting; bypass/stream/trigger overwrite the oldest
+            if (fifoMode() == ADXL345_FIFO_FIFO)
+            {
+                return;
+            }
+
+            fifoHead = (fifoHead + 1) % ADXL345_SIM_FIFO_SLOTS;
+            fifoCount--;
+        }
+
+        unsigned int slot = (fifoHead + fifoCount) % ADXL345_SIM_FIFO_SLOTS;
+        fifo[slot][0] = xyz[0];
+        fifo[slot][1] = xyz[1];
+        fifo[slot][2] = xyz[2];
+        fifoCount++;
+    }
+
+    uint8_t readRegister(uint8_t reg) const
+    {
+        if (reg >= ADXL345_REG_DATAX0 && reg <= ADXL345_REG_DATAZ1)
+        {
+            // Data registers show the oldest entry (last value when empty)
+            unsigned int slot = fifoCount > 0 ? fifoHead : (fifoHead + ADXL345_SIM_FIFO_SLOTS - 1) % ADXL345_SIM_FIFO_SLOTS;
+            uint16_t value = (uint16_t)fifo[slot][(reg - ADXL345_REG_DATAX0) / 2];
+            return (reg - ADXL345_REG_DATAX0) & 1 ? (uint8_t)(value >> 8) : (uint8_t)value;
+        }
+
+        if (reg == ADXL345_REG_FIFO_STATUS)
+        {
+            return fifoMode() == ADXL345_FIFO_BYPASS ? 0 : (uint8_t)fifoCount;
+        }
+
+        if (reg == ADXL345_REG_INT_SOURCE)
+        {
+            uint8_t value = 0;
+            if (fifoCount > 0)
+            {
+                value |= 1 << ADXL345_DATA_READY;
+            }
+            if (fifoMode() != ADXL345_FIFO_BYPASS && fifoCount >= (unsigned int)(regs[ADXL345_REG_FIFO_CTL] & 0x1F))
+            {
+                value |= 1 << ADXL345_WATERMARK;
+            }
+            if (overrun)
+            {
+                value |= 1 << ADXL345_OVERRUN;
+            }
+            return value;
+        }
+
+        return regs[reg];
+    }
+
+    void writeRegister(uint8_t reg, uint8_t value, uint64_t now_ns)
+    {
+        switch (reg)
+        {
+            // Read-only registers
+            case ADXL345_REG_DEVID:
+            case ADXL345_REG_ACT_TAP_STATUS:
+            case ADXL345_REG_INT_SOURCE:
+            case ADXL345_REG_DATAX0:
+            case ADXL345_REG_DATAX1:
+            case ADXL345_REG_DATAY0:
+            case ADXL345_REG_DATAY1:
+            case ADXL345_REG_DATAZ0:
+            case ADXL345_REG_DATAZ1:
+            case ADXL345_REG_FIFO_STATUS:
+                return;
+
+            case ADXL345_REG_POWER_CTL:
+                // First sample one ODR period after entering measurement mode
+                if (!measuring() && (value & 0x08))
+                {
+                    regs[reg] = value;
+                    nextSample = now_ns + period();
+                    return;
+                }
+                break;
+
+            case ADXL345_REG_FIFO_CTL:
+                // Changing to bypass flushes the FIFO
+                if (((value >> 6) & 0x03) == ADXL345_FIFO_BYPASS && fifoCount > 1)
+                {
+                    fifoHead = (fifoHead + fifoCount - 1) % ADXL345_SIM_FIFO_SLOTS;
+                    fifoCount = 1;
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        regs[reg] = value;
+    }
+
+    unsigned int _address;
+    Source source;
+    void *sourceRef;
+
+    uint8_t regs[0x40];
+    uint8_t pointer;
+
+    int16_t fifo[ADXL345_SIM_FIFO_SLOTS][3];
+    unsigned int fifoHead;
+    unsigned int fifoCount;
+    bool overrun;
+
+    uint64_t nextSample;
+    uint64_t generated;
+    uint64_t dropped;
+    uint64_t consumed;
+};
+
+#endif
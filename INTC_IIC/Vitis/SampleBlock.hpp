@@ -0,0 +1,213 @@
+/*
+SampleBlock.hpp - Structure-of-arrays block of accelerometer samples.
+
+Holds up to N samples as separate, 16-byte aligned x[], y[], z[] arrays so
+the batch kernels below can run 4 consecutive samples per instruction:
+    NEON      on the Cortex-A53 (__ARM_NEON)
+    SSE2      on x86 hosts (__SSE2__)
+    scalar    everywhere else (MicroBlaze)
+
+Typical use with a FIFO burst:
+    int16_t raw[3 * ADXL345_FIFO_DEPTH];
+    SampleBlock<ADXL345_FIFO_DEPTH> block;
+    SampleFilterState lpf;
+    size_t n = mpu.drainFifo(raw, ADXL345_FIFO_DEPTH);
+    block.fromRaw(raw, n, ADXL345Scale<ADXL345_RANGE_2G>::gPerLsb());
+    block.normalize(ADXL345_GRAVITY_EARTH);
+    block.lowPass(lpf, 0.5f);
+
+The low-pass is a recurrence, so it is vectorised along each axis as a
+prefix sum over 4 samples rather than across the three axes; its rounding
+differs from the scalar loop in the last bits.
+*/
+
+#ifndef SAMPLEBLOCK_h
+#define SAMPLEBLOCK_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SAMPLEBLOCK_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SAMPLEBLOCK_SSE
+#endif
+
+// Per-stream state of the first-order low-pass (x, y, z, pad)
+struct SampleFilterState
+{
+    alignas(16) float s[4];
+
+    SampleFilterState() { reset(); }
+    void reset(void) { s[0] = 0; s[1] = 0; s[2] = 0; s[3] = 0; }
+};
+
+template <size_t N>
+struct SampleBlock
+{
+    alignas(16) float x[N];
+    alignas(16) float y[N];
+    alignas(16) float z[N];
+    size_t count;
+
+    SampleBlock() : count(0) {}
+
+    static size_t capacity(void) { return N; }
+
+    // Deinterleave n raw x, y, z samples (as from readRawInto/drainFifo) and scale them
+    void fromRaw(const int16_t *xyz, size_t n, float scale)
+    {
+        size_t i = 0;
+
+        count = n < N ? n : N;
+
+#if defined(SAMPLEBLOCK_NEON)
+        for (; i + 4 <= count; i += 4)
+        {
+            int16x4x3_t v = vld3_s16(&xyz[3 * i]);
+            vst1q_f32(&x[i], vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(v.val[0])), scale));
+            vst1q_f32(&y[i], vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(v.val[1])), scale));
+            vst1q_f32(&z[i], vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(v.val[2])), scale));
+        }
+#elif defined(SAMPLEBLOCK_SSE)
+        __m128 k = _mm_set1_ps(scale);
+        for (; i + 4 <= count; i += 4)
+        {
+            // e0..e7 and e4..e11 of the 12 values; sign-extend, convert, then transpose
+            __m128i lo = _mm_loadu_si128((const __m128i *)&xyz[3 * i]);
+            __m128i hi = _mm_loadu_si128((const __m128i *)&xyz[3 * i + 4]);
+            __m128 a = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 16));     // e0..e3
+            __m128 b = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 16));     // e4..e7
+            __m128 c = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(hi, hi), 16));     // e8..e11
+
+            __m128 e6e9 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2));
+            __m128 e1e4 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+            __m128 e7e10 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));
+            __m128 e2e5 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+            __m128 vx = _mm_shuffle_ps(a, e6e9, _MM_SHUFFLE(2, 0, 3, 0));
+            __m128 vy = _mm_shuffle_ps(e1e4, e7e10, _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 vz = _mm_shuffle_ps(e2e5, c, _MM_SHUFFLE(3, 0, 2, 0));
+
+            _mm_store_ps(&x[i], _mm_mul_ps(vx, k));
+            _mm_store_ps(&y[i], _mm_mul_ps(vy, k));
+            _mm_store_ps(&z[i], _mm_mul_ps(vz, k));
+        }
+#endif
+        for (; i < count; i++)
+        {
+            x[i] = xyz[3 * i + 0] * scale;
+            y[i] = xyz[3 * i + 1] * scale;
+            z[i] = xyz[3 * i + 2] * scale;
+        }
+    }
+
+    // Multiply every sample by factor (e.g. g -> m/s^2)
+    void normalize(float factor)
+    {
+        scaleArray(x, count, factor);
+        scaleArray(y, count, factor);
+        scaleArray(z, count, factor);
+    }
+
+    // First-order low-pass, s += alpha * (v - s)
+    void lowPass(SampleFilterState &state, float alpha)
+    {
+#if defined(SAMPLEBLOCK_NEON) || defined(SAMPLEBLOCK_SSE)
+        state.s[0] = lowPassArray(x, count, state.s[0], alpha);
+        state.s[1] = lowPassArray(y, count, state.s[1], alpha);
+        state.s[2] = lowPassArray(z, count, state.s[2], alpha);
+#else
+        // Three independent recurrences interleaved
+        float sx = state.s[0], sy = state.s[1], sz = state.s[2];
+        for (size_t i = 0; i < count; i++)
+        {
+            sx += alpha * (x[i] - sx);
+            sy += alpha * (y[i] - sy);
+            sz += alpha * (z[i] - sz);
+            x[i] = sx;
+            y[i] = sy;
+            z[i] = sz;
+        }
+        state.s[0] = sx;
+        state.s[1] = sy;
+        state.s[2] = sz;
+#endif
+    }
+
+    private:
+
+    static void scaleArray(float *a, size_t n, float factor)
+    {
+        size_t i = 0;
+#if defined(SAMPLEBLOCK_NEON)
+        for (; i + 4 <= n; i += 4)
+        {
+            vst1q_f32(&a[i], vmulq_n_f32(vld1q_f32(&a[i]), factor));
+        }
+#elif defined(SAMPLEBLOCK_SSE)
+        __m128 k = _mm_set1_ps(factor);
+        for (; i + 4 <= n; i += 4)
+        {
+            _mm_store_ps(&a[i], _mm_mul_ps(_mm_load_ps(&a[i]), k));
+        }
+#endif
+        for (; i < n; i++)
+        {
+            a[i] *= factor;
+        }
+    }
+
+#if defined(SAMPLEBLOCK_NEON) || defined(SAMPLEBLOCK_SSE)
+    // One axis of the low-pass; returns the new state. With b = 1 - alpha and
+    // u = alpha * v, four outputs are s[i] = u[i] + b u[i-1] + b^2 u[i-2] +
+    // b^3 u[i-3] + b^(i+1) s, built as a two-step prefix sum
+    static float lowPassArray(float *a, size_t n, float s, float alpha)
+    {
+        size_t i = 0;
+        float b = 1.0f - alpha;
+        float b2 = b * b;
+#if defined(SAMPLEBLOCK_NEON)
+        const float carry[4] = { b, b2, b2 * b, b2 * b2 };
+        float32x4_t w = vld1q_f32(carry);
+        float32x4_t zero = vdupq_n_f32(0.0f);
+        float32x4_t sv = vdupq_n_f32(s);
+        for (; i + 4 <= n; i += 4)
+        {
+            float32x4_t u = vmulq_n_f32(vld1q_f32(&a[i]), alpha);
+            u = vmlaq_n_f32(u, vextq_f32(zero, u, 3), b);       // + b u[i-1]
+            u = vmlaq_n_f32(u, vextq_f32(zero, u, 2), b2);      // + b^2 (u[i-2] + b u[i-3])
+            u = vmlaq_f32(u, sv, w);
+            vst1q_f32(&a[i], u);
+            sv = vdupq_n_f32(vgetq_lane_f32(u, 3));
+        }
+        s = vgetq_lane_f32(sv, 0);
+#elif defined(SAMPLEBLOCK_SSE)
+        __m128 w = _mm_setr_ps(b, b2, b2 * b, b2 * b2);
+        __m128 k = _mm_set1_ps(alpha);
+        __m128 kb = _mm_set1_ps(b);
+        __m128 kb2 = _mm_set1_ps(b2);
+        __m128 sv = _mm_set1_ps(s);
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128 u = _mm_mul_ps(_mm_load_ps(&a[i]), k);
+            u = _mm_add_ps(u, _mm_mul_ps(kb, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(u), 4))));
+            u = _mm_add_ps(u, _mm_mul_ps(kb2, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(u), 8))));
+            u = _mm_add_ps(u, _mm_mul_ps(sv, w));
+            _mm_store_ps(&a[i], u);
+            sv = _mm_shuffle_ps(u, u, _MM_SHUFFLE(3, 3, 3, 3));
+        }
+        s = _mm_cvtss_f32(sv);
+#endif
+        for (; i < n; i++)
+        {
+            s += alpha * (a[i] - s);
+            a[i] = s;
+        }
+        return s;
+    }
+#endif
+};
+
+#endif
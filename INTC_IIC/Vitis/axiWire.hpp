@@ -20,28 +20,83 @@
 #ifndef _AXI_WIRE_H_
 #define _AXI_WIRE_H_
 
+#ifdef AXIWIRE_HOST
+#include "axiWireSim.hpp"
+#else
 #include <xparameters.h>
 #include "xiic.h"
 #include "xiic_l.h"
+#endif
 
-class AxiWire {
+/*
+ * AxiWire is BasicAxiWire over a bus policy chosen at compile time, so the
+ * embedded build calls XIic_Send/XIic_Recv directly:
+ *   XIicBus   - AXI IIC through the XIic low-level driver (default)
+ *   SimIicBus - host emulation from axiWireSim.hpp (build with -DAXIWIRE_HOST)
+ * A bus provides send()/recv() with an XIIC_STOP / XIIC_REPEATED_START
+ * option, reset(), clearStats() and numDevices().
+ */
+template <class Bus>
+class BasicAxiWire {
 public:
-    AxiWire(unsigned int device){
-            XIic_Initialize(&xi2c, device);
+    BasicAxiWire(unsigned int device) : bus(device){
     }
     int read(unsigned int slave_address, unsigned char* buffer, unsigned int length){
-        return XIic_Recv(xi2c.BaseAddress, slave_address, buffer, length, XIIC_STOP);
+        return bus.recv(slave_address, buffer, length, XIIC_STOP);
     }
     int write(unsigned int slave_address, unsigned char* buffer, unsigned int length){
-        return XIic_Send(xi2c.BaseAddress, slave_address, buffer, length, XIIC_STOP);
+        return bus.send(slave_address, buffer, length, XIIC_STOP);
+    }
+    // Combined write-then-read: the write ends in a repeated START instead of
+    // a STOP, so the bus is held for the read (e.g. register pointer + data)
+    int writeRead(unsigned int slave_address, unsigned char* tx, unsigned int tx_length,
+                  unsigned char* rx, unsigned int rx_length){
+        if ((unsigned int)bus.send(slave_address, tx, tx_length, XIIC_REPEATED_START) != tx_length){
+            return 0;
+        }
+        return bus.recv(slave_address, rx, rx_length, XIIC_STOP);
     }
     void reset(){
-        XIic_Reset(&xi2c);
+        bus.reset();
     }
     void close(){
-        XIic_ClearStats(&xi2c);
+        bus.clearStats();
     }
     static unsigned int getNumDevices(){
+        return Bus::numDevices();
+    }
+    Bus &getBus(){
+        return bus;
+    }
+
+private:
+    Bus bus;
+};
+
+#ifdef AXIWIRE_HOST
+
+typedef BasicAxiWire<SimIicBus> AxiWire;
+
+#else
+
+class XIicBus {
+public:
+    XIicBus(unsigned int device){
+            XIic_Initialize(&xi2c, device);
+    }
+    int recv(unsigned int slave_address, unsigned char* buffer, unsigned int length, unsigned char option){
+        return XIic_Recv(xi2c.BaseAddress, slave_address, buffer, length, option);
+    }
+    int send(unsigned int slave_address, unsigned char* buffer, unsigned int length, unsigned char option){
+        return XIic_Send(xi2c.BaseAddress, slave_address, buffer, length, option);
+    }
+    void reset(){
+        XIic_Reset(&xi2c);
+    }
+    void clearStats(){
+        XIic_ClearStats(&xi2c);
+    }
+    static unsigned int numDevices(){
         return XPAR_XIIC_NUM_INSTANCES;
     }
 
@@ -49,5 +104,9 @@ private:
     XIic xi2c;
 };
 
+typedef BasicAxiWire<XIicBus> AxiWire;
+
+#endif // AXIWIRE_HOST
+
 
 #endif // _AXI_WIRE_H_
@@ -0,0 +1,223 @@
+/******************************************************************************
+ *
+ *
+ * @file axiWireSim.hpp
+ *
+ * Host (Linux) stand-in for the AXI IIC, selected with AXIWIRE_HOST.
+ *
+ * SimIicBusModel keeps a virtual clock and charges every bus phase its
+ * wire time at the configured SCL rate (100/400 kHz); devices attached to
+ * it implement SimIicDevice (see ADXL345Sim.hpp).
+ * SimIicBus is the polled bus policy for AxiWire: each call blocks, i.e.
+ * moves the clock past the end of the phase.
+ * SimIicAsyncPort is the simulated completion source for AxiWireAsync:
+ * data moves when a phase starts, and the completion "interrupt" is raised
+ * once advance() has moved the clock past the phase's end.
+ *
+ *****************************************************************************/
+#ifndef _AXI_WIRE_SIM_H_
+#define _AXI_WIRE_SIM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef XIIC_STOP
+#define XIIC_STOP               0x00
+#define XIIC_REPEATED_START     0x01
+#endif
+
+#ifndef AXIWIRE_SIM_DEVICES
+#define AXIWIRE_SIM_DEVICES     2
+#endif
+
+// Simulated I2C slave
+class SimIicDevice {
+public:
+    virtual ~SimIicDevice(){}
+    virtual unsigned int address() const = 0;
+    // Bytes written by the master after the address phase; returns bytes ACKed
+    virtual unsigned int write(const unsigned char *buffer, unsigned int length, uint64_t now_ns) = 0;
+    // Bytes requested by the master; returns bytes supplied
+    virtual unsigned int read(unsigned char *buffer, unsigned int length, uint64_t now_ns) = 0;
+};
+
+class SimIicBusModel {
+public:
+    SimIicBusModel() : clock_hz(400000), now_ns(0), busy_ns(0), transactions(0), phases(0), bytes(0), device(NULL){}
+
+    void attach(SimIicDevice *slave){
+        device = slave;
+    }
+    void setClock(uint32_t hz){
+        clock_hz = hz;
+    }
+
+    // Wire time of one phase: START, address byte, data bytes (9 bits each
+    // with ACK) and the closing STOP or repeated START
+    uint64_t phaseTime(unsigned int length) const {
+        uint64_t bits = 1 + 9 * (uint64_t)(length + 1) + 1;
+        return bits * 1000000000ull / clock_hz;
+    }
+
+    // Perform one phase without moving the clock; returns bytes transferred.
+    // A phase ending in STOP closes a transaction.
+    unsigned int transfer(unsigned int slave_address, unsigned char *buffer, unsigned int length,
+                          bool isRead, bool stop, uint64_t *duration_ns){
+        phases++;
+        if (stop){
+            transactions++;
+        }
+
+        if (device == NULL || device->address() != slave_address){
+            // address NACK: only the address byte goes out
+            *duration_ns = phaseTime(0);
+            busy_ns += *duration_ns;
+            bytes += 1;
+            return 0;
+        }
+
+        *duration_ns = phaseTime(length);
+        busy_ns += *duration_ns;
+        bytes += length + 1;
+        return isRead ? device->read(buffer, length, now_ns) : device->write(buffer, length, now_ns);
+    }
+
+    void advance(uint64_t ns){
+        now_ns += ns;
+    }
+    uint64_t now() const {
+        return now_ns;
+    }
+
+    void clearStats(){
+        busy_ns = 0;
+        transactions = 0;
+        phases = 0;
+        bytes = 0;
+    }
+    uint64_t busyTime() const {
+        return busy_ns;
+    }
+    uint64_t transactionCount() const {
+        return transactions;
+    }
+    uint64_t phaseCount() const {
+        return phases;
+    }
+    uint64_t byteCount() const {
+        return bytes;
+    }
+
+private:
+    uint32_t clock_hz;
+    uint64_t now_ns;
+    uint64_t busy_ns;
+    uint64_t transactions;
+    uint64_t phases;
+    uint64_t bytes;
+    SimIicDevice *device;
+};
+
+// One bus model per simulated AXI IIC instance
+inline SimIicBusModel &simIicBus(unsigned int device){
+    static SimIicBusModel buses[AXIWIRE_SIM_DEVICES];
+    return buses[device % AXIWIRE_SIM_DEVICES];
+}
+
+// Polled bus policy for AxiWire (XIic_Send/XIic_Recv stand-in)
+class SimIicBus {
+public:
+    SimIicBus(unsigned int device) : bus(simIicBus(device)){}
+
+    int recv(unsigned int slave_address, unsigned char *buffer, unsigned int length, unsigned char option){
+        return transfer(slave_address, buffer, length, true, option);
+    }
+    int send(unsigned int slave_address, unsigned char *buffer, unsigned int length, unsigned char option){
+        return transfer(slave_address, buffer, length, false, option);
+    }
+    void reset(){}
+    void clearStats(){
+        bus.clearStats();
+    }
+    static unsigned int numDevices(){
+        return AXIWIRE_SIM_DEVICES;
+    }
+    SimIicBusModel &getModel(){
+        return bus;
+    }
+
+private:
+    int transfer(unsigned int slave_address, unsigned char *buffer, unsigned int length,
+                 bool isRead, unsigned char option){
+        uint64_t duration;
+        unsigned int moved = bus.transfer(slave_address, buffer, length, isRead,
+                                          option == XIIC_STOP, &duration);
+        bus.advance(duration);
+        return moved;
+    }
+
+    SimIicBusModel &bus;
+};
+
+// Simulated completion source for AxiWireAsync
+class SimIicAsyncPort {
+public:
+    SimIicAsyncPort(unsigned int device) : bus(simIicBus(device)), done(NULL), doneRef(NULL),
+                                           pending(false), pendingStatus(0), pendingAt(0){}
+
+    void bind(void (*callback)(void *, int), void *ref){
+        done = callback;
+        doneRef = ref;
+    }
+    int startWrite(unsigned int slave_address, unsigned char *buffer, unsigned int length, bool hold){
+        return start(slave_address, buffer, length, false, !hold);
+    }
+    int startRead(unsigned int slave_address, unsigned char *buffer, unsigned int length){
+        return start(slave_address, buffer, length, true, true);
+    }
+    // Interrupt service: deliver the completion if the phase has ended
+    void service(){
+        if (pending && bus.now() >= pendingAt){
+            pending = false;
+            done(doneRef, pendingStatus);
+        }
+    }
+    void lock(){}
+    void unlock(){}
+
+    // Move the virtual clock forward, raising completions as they fall due
+    void advance(uint64_t ns){
+        uint64_t end = bus.now() + ns;
+        while (pending && pendingAt <= end){
+            bus.advance(pendingAt - bus.now());
+            service();
+        }
+        bus.advance(end - bus.now());
+    }
+    bool inFlight() const {
+        return pending;
+    }
+    SimIicBusModel &getBus(){
+        return bus;
+    }
+
+private:
+    int start(unsigned int slave_address, unsigned char *buffer, unsigned int length, bool isRead, bool stop){
+        uint64_t duration;
+        unsigned int moved = bus.transfer(slave_address, buffer, length, isRead, stop, &duration);
+
+        pending = true;
+        pendingAt = bus.now() + duration;
+        pendingStatus = moved == length ? 0 : 1;    // AXIWIRE_OK / AXIWIRE_NACK
+        return 0;
+    }
+
+    SimIicBusModel &bus;
+    void (*done)(void *, int);
+    void *doneRef;
+    bool pending;
+    int pendingStatus;
+    uint64_t pendingAt;
+};
+
+#endif // _AXI_WIRE_SIM_H_
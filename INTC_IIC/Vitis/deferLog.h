@@ -0,0 +1,120 @@
+/*
+deferLog.h - Deferred binary logger for C and C++ applications.
+
+Logging a message only stores its catalogue id (logFormats.h) and up to
+four raw 32-bit arguments in a RAM ring; nothing is formatted on the
+target. dlog_drain() later sends the records as short binary frames from
+the main loop, and the host decoder (PC_DeferLog_Decode.c) turns them back
+into text. The DLOGn() macros are safe from interrupt handlers and cost a
+compare-and-swap plus a handful of stores, instead of the milliseconds a
+formatted xil_printf line takes at 115200 baud.
+
+    DLOG3(DLOG_ACCEL_G, dlog_f(v.XAxis), dlog_f(v.YAxis), dlog_f(v.ZAxis));
+    ...
+    dlog_drain(DLOG_DEPTH);     // main loop, when there is time
+
+Frame on the UART (little-endian, sum of all bytes after the sync is 0):
+    0xD1 | id (2) | seq (1) | nargs (1) | args (4 * nargs) | checksum (1)
+Plain text written with xil_printf may be mixed in; the decoder passes it
+through unchanged.
+
+Records that do not fit in the ring are dropped and counted; the next
+dlog_drain() reports them as a DLOG_LOG_DROPPED record.
+*/
+
+#ifndef DEFERLOG_h
+#define DEFERLOG_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef DLOG_DEPTH
+#define DLOG_DEPTH          64      // records, must be a power of two
+#endif
+
+#define DLOG_MAX_ARGS       4
+#define DLOG_SYNC           0xD1
+
+// Message ids
+#define DLOG_FORMAT(id, format) id,
+typedef enum
+{
+#include "logFormats.h"
+    DLOG_FORMAT_COUNT
+} dlog_id_t;
+#undef DLOG_FORMAT
+
+typedef struct
+{
+    volatile uint32_t seq;          // write index + 1 once the record is complete
+    uint16_t id;
+    uint16_t nargs;
+    uint32_t arg[DLOG_MAX_ARGS];
+} dlog_record_t;
+
+typedef struct
+{
+    dlog_record_t slots[DLOG_DEPTH];
+    uint32_t write;                 // next index to claim (producers)
+    uint32_t read;                  // next index to send (dlog_drain)
+    uint32_t dropped;
+} dlog_state_t;
+
+extern dlog_state_t dlog_state;
+
+// Queue one record. Several producers (task and interrupt handlers) may log
+// concurrently; a record is claimed with a compare-and-swap and becomes
+// visible to dlog_drain() when its seq is published.
+static inline void dlog_write(uint16_t id, uint16_t nargs, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3)
+{
+    uint32_t w = __atomic_load_n(&dlog_state.write, __ATOMIC_RELAXED);
+    dlog_record_t *r;
+
+    do
+    {
+        if (w - __atomic_load_n(&dlog_state.read, __ATOMIC_ACQUIRE) >= DLOG_DEPTH)
+        {
+            __atomic_fetch_add(&dlog_state.dropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(&dlog_state.write, &w, w + 1, 1, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+
+    r = &dlog_state.slots[w & (DLOG_DEPTH - 1)];
+    r->id = id;
+    r->nargs = nargs;
+    r->arg[0] = a0;
+    r->arg[1] = a1;
+    r->arg[2] = a2;
+    r->arg[3] = a3;
+    __atomic_store_n(&r->seq, w + 1, __ATOMIC_RELEASE);
+}
+
+// Bit pattern of a float argument (for %f / %e / %g)
+static inline uint32_t dlog_f(float value)
+{
+    union { float f; uint32_t u; } v;
+    v.f = value;
+    return v.u;
+}
+
+#define DLOG0(id)                   dlog_write((id), 0, 0, 0, 0, 0)
+#define DLOG1(id, a)                dlog_write((id), 1, (uint32_t)(a), 0, 0, 0)
+#define DLOG2(id, a, b)             dlog_write((id), 2, (uint32_t)(a), (uint32_t)(b), 0, 0)
+#define DLOG3(id, a, b, c)          dlog_write((id), 3, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c), 0)
+#define DLOG4(id, a, b, c, d)       dlog_write((id), 4, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c), (uint32_t)(d))
+
+// Send up to max completed records; returns the number sent.
+// Call from a single context (the main loop), never from an interrupt.
+unsigned int dlog_drain(unsigned int max);
+
+// Records queued but not yet sent
+unsigned int dlog_pending(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
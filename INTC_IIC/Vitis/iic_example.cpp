@@ -1,8 +1,13 @@
+
 #include <stdio.h>
 #include <stdlib.h>
 #include "xparameters.h"
 #include "ADXL345.h"
+#include "axiWireAsync.hpp"
+#include "SampleRing.hpp"
+#include "deferLog.h"
 #include "xintc_l.h"
+#include "xscugic.h"
 #include <xil_exception.h>
 #include <xil_types.h>
 #include "xil_printf.h"
@@ -10,68 +15,115 @@
 
 #define	XIIC_BASEADDRESS	XPAR_XIIC_0_BASEADDR
 #define INTC_BASEADDR		XPAR_XINTC_0_BASEADDR
-#define INTC_DEVICE_INTR_ID	0x0U
-#define INTC_DEVICE_INT_MASK	0x1U
+#define GIC_DEVICE_ID		XPAR_SCUGIC_SINGLE_DEVICE_ID
+
+// axi_intc_0/irq drives pl_ps_irq0[0], GIC SPI 121 (active-high level)
+#ifdef XPAR_FABRIC_AXI_INTC_0_IRQ_INTR
+#define INTC_GIC_INT_ID		XPAR_FABRIC_AXI_INTC_0_IRQ_INTR
+#else
+#define INTC_GIC_INT_ID		121U
+#endif
+#define INTC_GIC_PRIORITY	0xA0
+
+// AXI INTC inputs (xlconcat in design_1.tcl)
+#define IIC_INTR_ID		0x0U	// axi_iic_0/iic2intc_irpt
+#define IIC_INT_MASK		0x1U
+#define DATA_READY_INTR_ID	0x1U	// ADXL345 INT1, rising edge
+#define DATA_READY_INT_MASK	0x2U
 
-void DeviceDriverHandler(void *CallbackRef);
-void Rafael_ExceptionHandler(void *Data);
+#define SAMPLE_RING_SIZE	64	// 640 ms of samples at 100 Hz
+#define DRAIN_BATCH		16
 
-volatile static int InterruptProcessed = FALSE;
-void *callback_ref = NULL;
+typedef ADXL345Scale<ADXL345_RANGE_2G> Scale;
 
-Vector vetor;
-XIic Iic;
+void DataReadyHandler(void *CallbackRef);
+static int SetupInterruptSystem(void);
+void SampleReadDone(AxiWireTransaction *transaction, void *ref);
+static void StartSampleRead(void);
+
+static XScuGic Gic;
 ADXL345 mpu;
+AxiWireAsync *iicAsync;
+SampleRing<AccelSample, SAMPLE_RING_SIZE> samples;
+
+// DATAX0..DATAZ1 in one write + repeated START + read transaction
+static unsigned char dataRegister = ADXL345_REG_DATAX0;
+static unsigned char dataBytes[6];
+static AxiWireTransaction sampleRead;
+
+static volatile bool readInFlight = false;
+static volatile bool readPending = false;
+static volatile u32 busErrors = 0;
 
 int main(void)
 {
 
 	// initiallize i2c
 	AxiWire i2cDevice(XIIC_BASEADDRESS); // Initialize an AxiWire object for device 0
-	// initialize mpu
 
-	if(mpu.begin(&i2cDevice)){
-		xil_printf("initialization sucessful");
+	// DATA_READY on INT1; reading the data registers clears it
+	ADXL345Config config = ADXL345::defaultConfig();
+	config.intEnable = 1 << ADXL345_DATA_READY;
+	config.intMap = 0;
+
+	if(mpu.begin(&i2cDevice, config)){
+		xil_printf("initialization sucessful\r\n");
   	}else{
-  		xil_printf("initialization failed!");
+  		xil_printf("initialization failed!\r\n");
+  		return XST_FAILURE;
 	}
 
-    XIntc_RegisterHandler((u32) INTC_BASEADDR, INTC_DEVICE_INTR_ID,
-		      (XInterruptHandler)DeviceDriverHandler,
+	// From here on the sensor is read from interrupt context only
+	static AxiWireAsync async(XIIC_BASEADDRESS);
+	iicAsync = &async;
+
+	sampleRead.slave_address = ADXL345_ADDRESS;
+	sampleRead.tx = &dataRegister;
+	sampleRead.tx_length = 1;
+	sampleRead.rx = dataBytes;
+	sampleRead.rx_length = sizeof(dataBytes);
+
+    XIntc_RegisterHandler((u32) INTC_BASEADDR, IIC_INTR_ID,
+		      (XInterruptHandler)AxiWireAsync::interruptHandler,
+		      (void *)iicAsync);
+    XIntc_RegisterHandler((u32) INTC_BASEADDR, DATA_READY_INTR_ID,
+		      (XInterruptHandler)DataReadyHandler,
 		      (void *)0);
-    XIntc_EnableIntr((u32) INTC_BASEADDR, INTC_DEVICE_INT_MASK);
-    XIntc_Out32((u32) INTC_BASEADDR + XIN_MER_OFFSET, XIN_INT_MASTER_ENABLE_MASK);
-
-    void* ptr = (void*)(u32)INTC_BASEADDR;
-    Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_INT,
-				     (Xil_ExceptionHandler)XIntc_DeviceInterruptHandler,
-				     ptr);
-    Xil_ExceptionEnable();
-    XIntc_Out32(INTC_BASEADDR + XIN_ISR_OFFSET, INTC_DEVICE_INT_MASK);
-
-    int counter = 1;
 
-    void* Data;
+    XIntc_Out32(INTC_BASEADDR + XIN_IAR_OFFSET, IIC_INT_MASK | DATA_READY_INT_MASK);
+    XIntc_EnableIntr((u32) INTC_BASEADDR, IIC_INT_MASK);
+    XIntc_Out32((u32) INTC_BASEADDR + XIN_MER_OFFSET, XIN_INT_MASTER_ENABLE_MASK | XIN_INT_HARDWARE_ENABLE_MASK);
 
-    Xil_ExceptionInit();
+    if (SetupInterruptSystem() != XST_SUCCESS) {
+        xil_printf("interrupt setup failed!\r\n");
+        return XST_FAILURE;
+    }
 
-    Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_INT, (Xil_ExceptionHandler)Rafael_ExceptionHandler, callback_ref);
+    // INT1 may already be high (no edge to come): fetch that sample first,
+    // then let the edges through
+    StartSampleRead();
+    XIntc_EnableIntr((u32) INTC_BASEADDR, IIC_INT_MASK | DATA_READY_INT_MASK);
 
-    Xil_ExceptionEnable();
+    AccelSample batch[DRAIN_BATCH];
+    u32 received = 0;
+    int counter = 1;
 
 	while (1) {
 		/*
-		 * If the interrupt occurred which is indicated by the global
-		 * variable which is set in the device driver handler, then
-		 * stop waiting.
+		 * Drain whatever the interrupts have queued since the last pass;
+		 * log output (rendered on the PC) cannot stall the acquisition.
 		 */
+        size_t n;
+        while ((n = samples.pop(batch, DRAIN_BATCH)) > 0) {
+            received += n;
+
+            Vectori raw = { batch[n - 1].x, batch[n - 1].y, batch[n - 1].z };
+            Vectori mg = Scale::toMilliG(raw);
 
-        if (counter % 100 == 0){
-            // InterruptProcessed = !InterruptProcessed;
-            // DeviceDriverHandler(callback_ref);
-            // xil_printf("Bool value: %d\r\n", InterruptProcessed);
-            Rafael_ExceptionHandler(Data);
+            DLOG3(DLOG_ACCEL_MG, mg.XAxis, mg.YAxis, mg.ZAxis);
+            DLOG3(DLOG_ACCEL_STATS, received, samples.overflows(), busErrors);
         }
+        dlog_drain(DLOG_DEPTH);
 
         counter++;
         usleep(20000);
@@ -81,48 +133,84 @@ int main(void)
         }
 	}
 
+    XIntc_DisableIntr((u32) INTC_BASEADDR, IIC_INT_MASK | DATA_READY_INT_MASK);
+
     xil_printf("Successfully ran Example\r\n");
 	return XST_SUCCESS;
 
 }
 
-void Rafael_ExceptionHandler(void *Data)
+// The AXI INTC reaches the A53 through the GIC: the GIC dispatches SPI 121
+// to XIntc_DeviceInterruptHandler, which calls the handlers registered above
+static int SetupInterruptSystem(void)
 {
+	XScuGic_Config *config = XScuGic_LookupConfig(GIC_DEVICE_ID);
+	if (config == NULL) {
+		return XST_FAILURE;
+	}
+	if (XScuGic_CfgInitialize(&Gic, config, config->CpuBaseAddress) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
 
-    callback_ref = Data;
+	Xil_ExceptionInit();
+	Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_INT, (Xil_ExceptionHandler)XScuGic_InterruptHandler, &Gic);
 
-    // Your exception handler logic here
-    // For example, print or handle the exception.
-    xil_printf("Exception occurred! Handling...\n");
+	XScuGic_SetPriorityTriggerType(&Gic, INTC_GIC_INT_ID, INTC_GIC_PRIORITY, 0x1);	// level
+	if (XScuGic_Connect(&Gic, INTC_GIC_INT_ID, (Xil_InterruptHandler)XIntc_DeviceInterruptHandler,
+			    (void *)(UINTPTR)INTC_BASEADDR) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	XScuGic_Enable(&Gic, INTC_GIC_INT_ID);
+
+	Xil_ExceptionEnable();
+	return XST_SUCCESS;
+}
 
-    InterruptProcessed = !InterruptProcessed;
+// Queue the data register read; runs in interrupt context (or before
+// DATA_READY is enabled), so only one read is ever outstanding
+static void StartSampleRead(void)
+{
+    readInFlight = true;
+    if (!iicAsync->submit(&sampleRead, SampleReadDone, NULL)) {
+        readInFlight = false;
+        busErrors = busErrors + 1;
+    }
+}
 
-    // If you need to call the DeviceDriverHandler function within the handler
-    DeviceDriverHandler(callback_ref);
+// ADXL345 INT1 (DATA_READY) rising edge: start the read and return
+void DataReadyHandler(void *CallbackRef)
+{
+    (void)CallbackRef;
+
+    if (readInFlight) {
+        // The current read may have fetched the older sample; read again after it
+        readPending = true;
+        return;
+    }
+    StartSampleRead();
 }
 
-void DeviceDriverHandler(void *CallbackRef)
+// IIC completion: decode straight into the ring
+void SampleReadDone(AxiWireTransaction *transaction, void *ref)
 {
-	/*
-	 * Indicate the interrupt has been processed using a shared variable.
-	 */
-    // xil_printf("Bool value: %d\r\n", InterruptProcessed);
-
-    vetor = mpu.readScaled();
-
-        int AccelX_int = (int)vetor.XAxis;
-        int AccelX_frac = abs((vetor.XAxis - (int)vetor.XAxis)*1000);
-        int AccelY_int = (int)vetor.YAxis;
-        int AccelY_frac = abs((vetor.YAxis - (int)vetor.YAxis)*1000);
-        int AccelZ_int = (int)vetor.ZAxis;
-        int AccelZ_frac = abs((vetor.ZAxis - (int)vetor.ZAxis)*1000);
-
-		// xil_printf("\033[2J");  // Clears the screen
-    	xil_printf("\033[1A");  // Moves the cursor up three lines
-
-		// Send integer and fractional parts using xil_printf
-		xil_printf("AccelX: %d.%03d, AccelY: %d.%03d, AccelZ: %d.%03d\r\n",
-				AccelX_int, AccelX_frac,
-				AccelY_int, AccelY_frac,
-				AccelZ_int, AccelZ_frac);
-}
\ No newline at end of file
+    (void)ref;
+    readInFlight = false;
+
+    if (transaction->status == AXIWIRE_OK) {
+        AccelSample *slot = samples.claim();
+        if (slot != NULL) {
+            // Data registers are little-endian (DATAx0 is the LSB)
+            slot->x = (int16_t)(dataBytes[1] << 8 | dataBytes[0]);
+            slot->y = (int16_t)(dataBytes[3] << 8 | dataBytes[2]);
+            slot->z = (int16_t)(dataBytes[5] << 8 | dataBytes[4]);
+            samples.publish();
+        }
+    } else {
+        busErrors = busErrors + 1;
+    }
+
+    if (readPending) {
+        readPending = false;
+        StartSampleRead();
+    }
+}
@@ -0,0 +1,33 @@
+/*
+logFormats.h - Message catalogue for the deferred logger (deferLog.h).
+
+Each entry is DLOG_FORMAT(id, format). The firmware only ever sends the id
+and up to DLOG_MAX_ARGS 32-bit arguments; the host decoder
+(PC_DeferLog_Decode.c) renders the text with the same table, so both sides
+must be built from the same copy of this file. Append new entries at the
+end to keep old captures decodable.
+
+Conversions: %d %i %u %x %X %c take the argument as an integer,
+%f %e %g as a float sent with dlog_f(). No %s.
+*/
+
+DLOG_FORMAT(DLOG_LOG_DROPPED,       "[%u log records dropped]\r\n")
+DLOG_FORMAT(DLOG_ACCEL_G,           "\033[1AAccelX: %.3f, AccelY: %.3f, AccelZ: %.3f\r\n")
+DLOG_FORMAT(DLOG_ACCEL_MG,          "\033[1AAccelX: %d mg, AccelY: %d mg, AccelZ: %d mg\r\n")
+DLOG_FORMAT(DLOG_ACCEL_STATS,       "%u samples, %u lost, %u bus errors\r\n")
+DLOG_FORMAT(DLOG_FFT_ACQUIRE,       "Acquiring Data...\r\n")
+DLOG_FORMAT(DLOG_FFT_RUN,           "Running FFT Acceleration...\r\n")
+DLOG_FORMAT(DLOG_FFT_SIGNAL,        "Data Ready. Signaling PS...\r\n")
+DLOG_FORMAT(DLOG_FFT_DMA_FAILED,    "DMA Transfer Failed\r\n")
+DLOG_FORMAT(DLOG_FFT_FRAME,         "Frame %u Received! Peak Frequency Bin: %d, Peak Power: %u\r\n")
+DLOG_FORMAT(DLOG_DOORBELL_WAKEUPS,  "doorbell: %u wakeups, %u interrupts, %u messages\r\n")
+DLOG_FORMAT(DLOG_DOORBELL_LATENCY,  "doorbell latency: min %u ns, avg %u ns, max %u ns\r\n")
+DLOG_FORMAT(DLOG_FFT_RATE,          "%u.%u frames/s (%u frames)\r\n")
+DLOG_FORMAT(DLOG_FFT_DMA_RECOVERED,  "DMA frame %u failed (status %u), core reset (%u resets)\r\n")
+DLOG_FORMAT(DLOG_FFT_ACQ_STATS,     "Acquired %u samples at %u Hz ODR, %u FIFO overruns\r\n")
+DLOG_FORMAT(DLOG_FFT_ACQ_BUS,       "I2C bus %u.%u%% busy (%u.%u%% sample reads)\r\n")
+DLOG_FORMAT(DLOG_FFT_FRAME_DROPPED, "Frame %u dropped by the MicroBlaze (%u dropped)\r\n")
+DLOG_FORMAT(DLOG_FFT_SW_ACQUIRE,   "Acquiring %u samples...\r\n")
+DLOG_FORMAT(DLOG_FFT_SW_COMPUTE,   "Computing FFT...\r\n")
+DLOG_FORMAT(DLOG_FFT_SW_DONE,      "Frame Done. Results in BRAM.\r\n")
+DLOG_FORMAT(DLOG_FFT_DMA_HALTED,   "DMA stuck in reset after %u resets, FFT stopped\r\n")
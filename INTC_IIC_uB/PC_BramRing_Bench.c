@@ -0,0 +1,177 @@
+/*
+ * Host Benchmark for the Shared BRAM Ring
+ * ======================================
+ * Runs Vitis/microblaze_app/bramRing.h on your local PC. A producer thread
+ * (the MicroBlaze) queues 16-sample batches, with an FFT-frame message every
+ * 8th, into a shared-memory page standing in for the 8 KB BRAM, while a
+ * consumer thread (the A53) pops them. Every message carries its producer
+ * sequence number and a payload derived from it, so the consumer checks
+ * order, type, length and content, and that the gaps it sees add up to the
+ * ring's dropped count.
+ *
+ * Two runs: a free-running consumer (throughput; few or no drops on a
+ * multi-core host) and a slow consumer that sleeps between passes like
+ * main_cortex.cpp (expect drops, but still 0 errors).
+ *
+ * To compile: gcc -O2 -IVitis/microblaze_app PC_BramRing_Bench.c -o bramring_bench -lpthread
+ * To run: ./bramring_bench [messages]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include "bramRing.h"
+
+#define BRAM_BYTES      8192
+#define RING_SLOTS      16
+#define SAMPLE_WORDS    96          // 16 samples x 6 words, as main_ub.cpp
+#define FFT_WORDS       64
+#define RING_SLOT_WORDS (1 + SAMPLE_WORDS)
+
+#define MSG_SAMPLES     1
+#define MSG_FFT_FRAME   2
+
+static volatile uint32_t *bram;
+static unsigned long messages;
+static volatile int producerDone;
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint32_t messageType(uint32_t seq)
+{
+    return (seq % 8) == 7 ? MSG_FFT_FRAME : MSG_SAMPLES;
+}
+
+static uint32_t messageWords(uint32_t type)
+{
+    return type == MSG_FFT_FRAME ? FFT_WORDS : SAMPLE_WORDS;
+}
+
+static void *producer(void *arg)
+{
+    bram_ring_t ring;
+    uint32_t payload[SAMPLE_WORDS];
+
+    (void)arg;
+    bramring_init(&ring, bram, RING_SLOTS, RING_SLOT_WORDS);
+
+    for (uint32_t seq = 0; seq < messages; seq++) {
+        uint32_t type = messageType(seq);
+        uint32_t words = messageWords(type);
+
+        payload[0] = seq;
+        for (uint32_t i = 1; i < words; i++) {
+            payload[i] = seq * 31u + i;
+        }
+
+        // A full ring drops the message; keep going like the MicroBlaze does
+        if (!bramring_push(&ring, type, payload, words)) {
+            sched_yield();
+        }
+    }
+
+    producerDone = 1;
+    return NULL;
+}
+
+static int run(const char *name, unsigned int pauseUs)
+{
+    bram_ring_t ring;
+    uint32_t payload[SAMPLE_WORDS];
+    unsigned long received = 0, errors = 0, gaps = 0, bytes = 0;
+    uint32_t expected = 0;
+    pthread_t thread;
+
+    bram[BRAMRING_ID] = 0;
+    producerDone = 0;
+    double start = now();
+    pthread_create(&thread, NULL, producer, NULL);
+
+    while (!bramring_attach(&ring, bram)) {
+        sched_yield();
+    }
+
+    for (;;) {
+        uint32_t type, words;
+        int done = producerDone;
+
+        while ((words = bramring_pop(&ring, payload, SAMPLE_WORDS, &type)) > 0) {
+            uint32_t seq = payload[0];
+
+            received++;
+            bytes += 4 * words;
+            if (seq < expected) {
+                errors++;                           // out of order / repeated
+            }
+            gaps += seq > expected ? seq - expected : 0;
+            expected = seq + 1;
+
+            if (type != messageType(seq) || words != messageWords(type)) {
+                errors++;
+                continue;
+            }
+            for (uint32_t i = 1; i < words; i++) {
+                if (payload[i] != seq * 31u + i) {
+                    errors++;
+                    break;
+                }
+            }
+        }
+
+        // Drain once more after the producer finished, then stop
+        if (done) {
+            break;
+        }
+        if (pauseUs != 0) {
+            usleep(pauseUs);
+        } else {
+            sched_yield();
+        }
+    }
+
+    pthread_join(thread, NULL);
+    double elapsed = now() - start;
+    gaps += messages - expected;
+    uint32_t dropped = bramring_dropped(&ring);
+
+    printf("%-14s %lu/%lu messages, %.1f Mmsg/s, %.1f MB/s, %u dropped, %lu missing, %lu errors\n",
+           name, received, messages, received / elapsed * 1e-6, bytes / elapsed * 1e-6,
+           dropped, gaps, errors);
+
+    return errors == 0 && gaps == dropped && received + dropped == messages;
+}
+
+int main(int argc, char **argv)
+{
+    messages = argc > 1 ? strtoul(argv[1], NULL, 0) : 1000000;
+
+    if (BRAMRING_BYTES(RING_SLOTS, RING_SLOT_WORDS) > BRAM_BYTES) {
+        fprintf(stderr, "Ring does not fit in %d bytes of BRAM\n", BRAM_BYTES);
+        return 1;
+    }
+
+    bram = mmap(NULL, BRAM_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (bram == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+
+    printf("Ring: %d slots x %d words, %d of %d BRAM bytes\n", RING_SLOTS, RING_SLOT_WORDS,
+           (int)BRAMRING_BYTES(RING_SLOTS, RING_SLOT_WORDS), BRAM_BYTES);
+
+    int ok = run("free-running", 0);
+    ok &= run("slow consumer", 200);
+
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+/*
+ * Host Test for the Packed Sample Format
+ * ======================================
+ * Round-trips Vitis/microblaze_app/packedSample.h on your local PC:
+ *   - packedsample_pack() of the int16 extremes (-32768, -1, 0, 1, 32767 on
+ *     every axis) gives the documented layout, x, y, z, seq as four int16
+ *     values in memory
+ *   - packedsample_decode() returns exactly raw * gPerLsb for every sample,
+ *     for counts 1..40 (the 8-sample NEON body and every tail length)
+ *   - lost-sample accounting: consecutive sequence numbers, gaps inside and
+ *     between 8-sample groups, and the 16-bit wrap from 0xFFFF to 0
+ *
+ * On x86 this runs the plain C decoder. Built for the A53 (aarch64, e.g.
+ * aarch64-linux-gnu-gcc and qemu-aarch64) the same checks run the NEON path.
+ *
+ * To compile: gcc -O2 -IVitis/microblaze_app PC_PackedSample_Test.c -o packedsample_test
+ * To run: ./packedsample_test
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "packedSample.h"
+
+#define MAX_SAMPLES     40
+#define G_PER_LSB       0.0039f
+
+static const int16_t extremes[] = { -32768, -1, 0, 1, 32767 };
+#define EXTREMES        (sizeof(extremes) / sizeof(extremes[0]))
+
+// Sample i of a test buffer: walks every extreme combination, then pseudo-random values
+static void sample(uint32_t i, int16_t *x, int16_t *y, int16_t *z)
+{
+    if (i < EXTREMES * EXTREMES * EXTREMES) {
+        *x = extremes[i % EXTREMES];
+        *y = extremes[i / EXTREMES % EXTREMES];
+        *z = extremes[i / (EXTREMES * EXTREMES)];
+    } else {
+        *x = (int16_t)(i * 40503u);
+        *y = (int16_t)(i * 12345u + 7);
+        *z = (int16_t)~(i * 2654435761u >> 8);
+    }
+}
+
+static int testLayout(void)
+{
+    uint32_t words[PACKEDSAMPLE_WORDS * EXTREMES * EXTREMES * EXTREMES];
+    int16_t halves[4];
+    int pass = 1;
+
+    for (uint32_t i = 0; i < EXTREMES * EXTREMES * EXTREMES; i++) {
+        int16_t x, y, z;
+        uint16_t seq = (uint16_t)(0xFFF0 + i);
+
+        sample(i, &x, &y, &z);
+        packedsample_pack(&words[PACKEDSAMPLE_WORDS * i], x, y, z, seq);
+
+        memcpy(halves, &words[PACKEDSAMPLE_WORDS * i], sizeof(halves));
+        pass &= halves[0] == x && halves[1] == y && halves[2] == z && (uint16_t)halves[3] == seq;
+        pass &= packedsample_seq(words, i) == seq;
+    }
+
+    printf("layout:     %d extreme samples pack as x, y, z, seq: %s\n",
+           (int)(EXTREMES * EXTREMES * EXTREMES), pass ? "ok" : "WRONG");
+    return pass;
+}
+
+static int testDecode(void)
+{
+    uint32_t words[PACKEDSAMPLE_WORDS * MAX_SAMPLES];
+    float xyz[3 * MAX_SAMPLES];
+    uint32_t mismatches = 0, lostErrors = 0;
+
+    for (uint32_t count = 1; count <= MAX_SAMPLES; count++) {
+        uint16_t base = (uint16_t)(0xFFFF - count / 2);     // wraps in the middle
+        uint16_t expected = base;
+
+        for (uint32_t i = 0; i < count; i++) {
+            int16_t x, y, z;
+            sample(i, &x, &y, &z);
+            packedsample_pack(&words[PACKEDSAMPLE_WORDS * i], x, y, z, (uint16_t)(base + i));
+        }
+
+        memset(xyz, 0, sizeof(xyz));
+        lostErrors += packedsample_decode(words, count, G_PER_LSB, xyz, &expected) != 0;
+        lostErrors += expected != (uint16_t)(base + count);
+
+        for (uint32_t i = 0; i < count; i++) {
+            int16_t x, y, z;
+            sample(i, &x, &y, &z);
+            mismatches += xyz[3 * i + 0] != x * G_PER_LSB;
+            mismatches += xyz[3 * i + 1] != y * G_PER_LSB;
+            mismatches += xyz[3 * i + 2] != z * G_PER_LSB;
+        }
+    }
+
+    printf("decode:     counts 1..%d, %u values differ from raw * gPerLsb, %u sequence errors\n",
+           MAX_SAMPLES, mismatches, lostErrors);
+    return mismatches == 0 && lostErrors == 0;
+}
+
+static int testLost(void)
+{
+    uint32_t words[PACKEDSAMPLE_WORDS * MAX_SAMPLES];
+    float xyz[3 * MAX_SAMPLES];
+    uint16_t seq = 0xFFF8, expected = 0xFFF8;
+    uint32_t dropped = 0, lost = 0;
+
+    // Skip 3 after sample 5 (inside the first group of 8), 1 after sample 8
+    // (between groups), 10 after sample 29 (in the tail); crosses 0xFFFF -> 0
+    for (uint32_t i = 0; i < MAX_SAMPLES - 3; i++) {
+        uint32_t skip = i == 5 ? 3 : i == 8 ? 1 : i == 29 ? 10 : 0;
+
+        packedsample_pack(&words[PACKEDSAMPLE_WORDS * i], (int16_t)i, 0, 0, seq);
+        seq = (uint16_t)(seq + 1 + skip);
+        dropped += skip;
+    }
+
+    lost += packedsample_decode(words, 20, G_PER_LSB, xyz, &expected);
+    lost += packedsample_decode(words + PACKEDSAMPLE_WORDS * 20, MAX_SAMPLES - 3 - 20, G_PER_LSB,
+                                xyz + 3 * 20, &expected);
+
+    int pass = lost == dropped && expected == seq;
+    printf("lost:       %u lost over two batches (expected %u), next seq 0x%04X (expected 0x%04X)\n",
+           lost, dropped, expected, seq);
+    return pass;
+}
+
+int main(void)
+{
+    int pass = 1;
+
+    printf("decoder:    %s\n",
+#if defined(__ARM_NEON)
+           "NEON"
+#else
+           "plain C"
+#endif
+           );
+    pass &= testLayout();
+    pass &= testDecode();
+    pass &= testLost();
+
+    printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
@@ -1,66 +1,89 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "xparameters.h"
-#include "xintc_l.h"
-#include <xil_exception.h>
 #include <xil_types.h>
 #include "xil_printf.h"
+#include "xscugic.h"
+#include "xil_exception.h"
+#include "deferLog.h"
+#include "bramRing.h"
+#include "packedSample.h"
+#include "doorbell.h"
 #include <sleep.h>
 
-#define INTC_BASEADDR		XPAR_XINTC_0_BASEADDR
-#define INTC_DEVICE_INTR_ID	0x0U
-#define INTC_DEVICE_INT_MASK	0x1U
-#define VECTOR_SIZE 6
 #define BRAM_BASE_ADDRESS XPAR_AXI_BRAM_0_BASEADDRESS
+#define INTC_DEVICE_ID XPAR_SCUGIC_SINGLE_DEVICE_ID
+#define STATS_EVERY 64		// wakeups between doorbell reports
 
-void DeviceDriverHandler(void *CallbackRef);
-void Rafael_ExceptionHandler(void *Data);
+// Message types (must match main_ub.cpp)
+#define MSG_RAW_SAMPLES		2
+#define BATCH_SAMPLES		48
+#define BATCH_WORDS		PACKEDSAMPLE_MESSAGE_WORDS(BATCH_SAMPLES)
 
-volatile static int InterruptProcessed = FALSE;
-void *callback_ref = NULL;
+static float accel[3 * BATCH_SAMPLES];	// latest batch in g, interleaved x, y, z
+
+static XScuGic Gic;
+static doorbell_t Bell;
+
+static int SetupInterruptSystem(void);
+static u32 ProcessBatch(const u32 *words, u32 count, u16 *expectedSeq);
 
 int main(void)
 {
+    bram_ring_t ring;
 
-    XIntc_RegisterHandler((u32) INTC_BASEADDR, INTC_DEVICE_INTR_ID,
-		      (XInterruptHandler)DeviceDriverHandler,
-		      (void *)0);
-    XIntc_EnableIntr((u32) INTC_BASEADDR, INTC_DEVICE_INT_MASK);
-    XIntc_Out32((u32) INTC_BASEADDR + XIN_MER_OFFSET, XIN_INT_MASTER_ENABLE_MASK);
+    // The MicroBlaze formats the ring once it is up
+    while (!bramring_attach(&ring, (volatile void *)BRAM_BASE_ADDRESS)) {
+        usleep(1000);
+    }
 
-    void* ptr = (void*)(u32)INTC_BASEADDR;
-    Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_INT,
-				     (Xil_ExceptionHandler)XIntc_DeviceInterruptHandler,
-				     ptr);
-    Xil_ExceptionEnable();
-    XIntc_Out32(INTC_BASEADDR + XIN_ISR_OFFSET, INTC_DEVICE_INT_MASK);
+    if (SetupInterruptSystem() != XST_SUCCESS) {
+        xil_printf("Doorbell interrupt setup failed\r\n");
+        return XST_FAILURE;
+    }
 
+    u32 batch[BATCH_WORDS];
+    u32 received = 0;
+    u32 lost = 0;
+    u32 messages = 0;
+    u16 expectedSeq = 0;
+    bool synced = false;
     int counter = 1;
 
-    void* Data;
-
-    Xil_ExceptionInit();
-
-    Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_INT, (Xil_ExceptionHandler)Rafael_ExceptionHandler, callback_ref);
-
-    Xil_ExceptionEnable();
-
 	while (1) {
 		/*
-		 * If the interrupt occurred which is indicated by the global
-		 * variable which is set in the device driver handler, then
-		 * stop waiting.
+		 * Sleep until the MicroBlaze rings, then take every batch queued
+		 * so far. The doorbell stays masked while draining, so under load
+		 * one interrupt covers many batches; nothing is lost unless the
+		 * ring fills up (seen as gaps in the sample sequence numbers).
 		 */
+        doorbell_wait(&Bell);
+
+        u32 type, words;
+        while ((words = bramring_pop(&ring, batch, BATCH_WORDS, &type)) > 0) {
+            messages++;
+            if (type == MSG_RAW_SAMPLES && words > 1) {
+                u32 count = (words - 1) / PACKEDSAMPLE_WORDS;
+                if (!synced) {
+                    expectedSeq = packedsample_seq(&batch[1], 0);
+                    synced = true;
+                }
+                lost += ProcessBatch(batch, count, &expectedSeq);
+                received += count;
+            }
+        }
 
-        if (counter % 100 == 0){
-            // InterruptProcessed = !InterruptProcessed;
-            // DeviceDriverHandler(callback_ref);
-            // xil_printf("Bool value: %d\r\n", InterruptProcessed);
-            Rafael_ExceptionHandler(Data);
+        doorbell_rearm(&Bell);
+
+        DLOG3(DLOG_ACCEL_STATS, received, lost, 0);
+        if (Bell.stats.wakeups % STATS_EVERY == 0) {
+            DLOG3(DLOG_DOORBELL_WAKEUPS, Bell.stats.wakeups, Bell.stats.rings, messages);
+            DLOG3(DLOG_DOORBELL_LATENCY, Bell.stats.latencyMinNs, doorbell_latencyAvgNs(&Bell.stats),
+                  Bell.stats.latencyMaxNs);
         }
+        dlog_drain(DLOG_DEPTH);
 
         counter++;
-        usleep(20000);
 
         if (counter == 1000) {
             break; // Return successful exit
@@ -72,39 +95,38 @@ int main(void)
 
 }
 
-void Rafael_ExceptionHandler(void *Data)
+static int SetupInterruptSystem(void)
 {
+	XScuGic_Config *config = XScuGic_LookupConfig(INTC_DEVICE_ID);
+	if (config == NULL) {
+		return XST_FAILURE;
+	}
+	if (XScuGic_CfgInitialize(&Gic, config, config->CpuBaseAddress) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
 
-    callback_ref = Data;
-
-    // Your exception handler logic here
-    // For example, print or handle the exception.
-    xil_printf("Exception occurred! Handling...\n");
+	Xil_ExceptionInit();
+	Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_INT, (Xil_ExceptionHandler)XScuGic_InterruptHandler, &Gic);
 
-    InterruptProcessed = !InterruptProcessed;
+	if (doorbell_attach(&Bell, &Gic, DOORBELL_INT_ID) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
 
-    // If you need to call the DeviceDriverHandler function within the handler
-    DeviceDriverHandler(callback_ref);
+	Xil_ExceptionEnable();
+	return XST_SUCCESS;
 }
 
-void DeviceDriverHandler(void *CallbackRef)
+static u32 ProcessBatch(const u32 *words, u32 count, u16 *expectedSeq)
 {
-	/*
-	 * Indicate the interrupt has been processed using a shared variable.
-	 */
-    int read_data[VECTOR_SIZE];
-    // Read data from BRAM
-       for (int i = 0; i < VECTOR_SIZE; i++) {
-        u32 address = BRAM_BASE_ADDRESS + (i * 4); // Calculate address for each element
-        read_data[i] = Xil_In32(address);
-    }
+	if (count == 0) {
+		return 0;
+	}
 
-	// xil_printf("\033[2J");  // Clears the screen
-	xil_printf("\033[1A");  // Moves the cursor up three lines
+	// words[0] is the sensor scale in mg/LSB, then the packed samples
+	float gPerLsb = words[0] * 0.001f;
+	u32 lost = packedsample_decode(&words[1], count, gPerLsb, accel, expectedSeq);
 
-	// Send integer and fractional parts using xil_printf
-	xil_printf("AccelX: %d.%03d, AccelY: %d.%03d, AccelZ: %d.%03d\r\n",
-			read_data[0], read_data[1],
-			read_data[2], read_data[3],
-			read_data[4], read_data[5]);
-}
\ No newline at end of file
+	const float *last = &accel[3 * (count - 1)];
+	DLOG3(DLOG_ACCEL_G, dlog_f(last[0]), dlog_f(last[1]), dlog_f(last[2]));
+	return lost;
+}
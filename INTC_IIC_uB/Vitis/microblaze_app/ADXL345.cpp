@@ -31,6 +31,11 @@ int constrain(int value, int minVal, int maxVal) {
 }
 
 bool ADXL345::begin(AxiWire *axiWire_handler)
+{
+    return begin(axiWire_handler, defaultConfig());
+}
+
+bool ADXL345::begin(AxiWire *axiWire_handler, const ADXL345Config &config)
 {
     f.XAxis = 0;
     f.YAxis = 0;
@@ -38,18 +43,18 @@ bool ADXL345::begin(AxiWire *axiWire_handler)
 
     Wire = axiWire_handler;
 
+    shadowValid = false;
+    _milliGPerLsb = ADXL345_MG_PER_LSB;
+    _scale = ADXL345_MG_PER_LSB * 0.001f;
+
     // Check ADXL345 REG DEVID
     if (fastRegister8(ADXL345_REG_DEVID) != 0xE5)
     {
         return false;
     }
 
-    // Enable measurement mode (0b00001000)
-    writeRegister8(ADXL345_REG_POWER_CTL, 0x08);
-
-    clearSettings();
-
-    return true;
+    // Verify-then-write; also loads the configuration shadow
+    return apply(config);
 }
 
 // Set Range
@@ -67,6 +72,9 @@ void ADXL345::setRange(adxl345_range_t range)
   value |= 0x08;
 
   writeRegister8(ADXL345_REG_DATA_FORMAT, value);
+
+  _range = range;
+  updateScale();
 }
 
 // Get Range
@@ -90,30 +98,58 @@ adxl345_dataRate_t ADXL345::getDataRate(void)
 // Low Pass Filter
 Vector ADXL345::lowPassFilter(Vector vector, float alpha)
 {
-    f.XAxis = vector.XAxis * alpha + (f.XAxis * (1.0 - alpha));
-    f.YAxis = vector.YAxis * alpha + (f.YAxis * (1.0 - alpha));
-    f.ZAxis = vector.ZAxis * alpha + (f.ZAxis * (1.0 - alpha));
+    f.XAxis = vector.XAxis * alpha + (f.XAxis * (1.0f - alpha));
+    f.YAxis = vector.YAxis * alpha + (f.YAxis * (1.0f - alpha));
+    f.ZAxis = vector.ZAxis * alpha + (f.ZAxis * (1.0f - alpha));
     return f;
 }
 
-// Read raw values
+// Read raw values (single 6-byte burst from DATAX0..DATAZ1)
 Vectori ADXL345::readRaw(void)
 {
-    r.XAxis = readRegister16(ADXL345_REG_DATAX0);
-    r.YAxis = readRegister16(ADXL345_REG_DATAY0);
-    r.ZAxis = readRegister16(ADXL345_REG_DATAZ0);
+    int16_t xyz[3] = {0, 0, 0};
+
+    readRawInto(xyz, 1);
+
+    r.XAxis = xyz[0];
+    r.YAxis = xyz[1];
+    r.ZAxis = xyz[2];
     return r;
 }
 
+// Read n raw samples into dst as interleaved x, y, z (dst must hold 3 * n values)
+size_t ADXL345::readRawInto(int16_t *dst, size_t n)
+{
+    uint8_t va[6];
+
+    for (size_t i = 0; i < n; i++)
+    {
+        // DATAX0..DATAZ1 auto-increment, so one read returns all three axes
+        if (readRegisters(ADXL345_REG_DATAX0, va, 6) != 6)
+        {
+            return i;
+        }
+
+        // Data registers are little-endian (DATAx0 is the LSB)
+        dst[3 * i + 0] = (int16_t)(va[1] << 8 | va[0]);
+        dst[3 * i + 1] = (int16_t)(va[3] << 8 | va[2]);
+        dst[3 * i + 2] = (int16_t)(va[5] << 8 | va[4]);
+    }
+
+    return n;
+}
+
 // Read normalized values
 Vector ADXL345::readNormalize(float gravityFactor)
 {
     readRaw();
 
-    // (4 mg/LSB scale factor in Full Res) * gravity factor
-    n.XAxis = r.XAxis * 0.004 * gravityFactor;
-    n.YAxis = r.YAxis * 0.004 * gravityFactor;
-    n.ZAxis = r.ZAxis * 0.004 * gravityFactor;
+    // (g/LSB scale factor for the current range) * gravity factor, single precision
+    float factor = _scale * gravityFactor;
+
+    n.XAxis = r.XAxis * factor;
+    n.YAxis = r.YAxis * factor;
+    n.ZAxis = r.ZAxis * factor;
 
     return n;
 }
@@ -123,14 +159,38 @@ Vector ADXL345::readScaled(void)
 {
     readRaw();
 
-    // (4 mg/LSB scale factor in Full Res)
-    n.XAxis = r.XAxis * 0.004;
-    n.YAxis = r.YAxis * 0.004;
-    n.ZAxis = r.ZAxis * 0.004;
+    // (g/LSB scale factor for the current range, single precision)
+    n.XAxis = r.XAxis * _scale;
+    n.YAxis = r.YAxis * _scale;
+    n.ZAxis = r.ZAxis * _scale;
 
     return n;
 }
 
+// Read values in mg (integer only, no FPU needed)
+Vectori ADXL345::readMilliG(void)
+{
+    Vectori mg;
+
+    readRaw();
+
+    mg.XAxis = r.XAxis * _milliGPerLsb;
+    mg.YAxis = r.YAxis * _milliGPerLsb;
+    mg.ZAxis = r.ZAxis * _milliGPerLsb;
+
+    return mg;
+}
+
+// Recompute the scale factors from DATA_FORMAT (served from the shadow)
+void ADXL345::updateScale(void)
+{
+    uint8_t format = readRegister8(ADXL345_REG_DATA_FORMAT);
+
+    // Full Res keeps 4 mg/LSB; 10-bit mode doubles per range step
+    _milliGPerLsb = (format & 0x08) ? ADXL345_MG_PER_LSB : ADXL345_MG_PER_LSB << (format & 0x03);
+    _scale = _milliGPerLsb * 0.001f;
+}
+
 void ADXL345::clearSettings(void)
 {
     setRange(ADXL345_RANGE_2G);
@@ -157,8 +217,222 @@ void ADXL345::clearSettings(void)
     writeRegister8(ADXL345_REG_TAP_AXES, value);
 }
 
-// Write byte to register
-void ADXL345::writeRegister8(uint8_t reg, uint8_t value)
+// Reload the configuration shadow from the device (e.g. after a device reset)
+bool ADXL345::resync(void)
+{
+    uint8_t *span = &shadow[ADXL345_REG_THRESH_TAP - ADXL345_SHADOW_FIRST];
+
+    shadowValid = false;
+
+    // THRESH_TAP..INT_MAP in one burst, then the two isolated registers
+    if (readRegisters(ADXL345_REG_THRESH_TAP, span,
+                      ADXL345_REG_INT_MAP - ADXL345_REG_THRESH_TAP + 1) !=
+        ADXL345_REG_INT_MAP - ADXL345_REG_THRESH_TAP + 1)
+    {
+        return false;
+    }
+
+    if (!fastRegister8(ADXL345_REG_DATA_FORMAT, &shadow[ADXL345_REG_DATA_FORMAT - ADXL345_SHADOW_FIRST]) ||
+        !fastRegister8(ADXL345_REG_FIFO_CTL, &shadow[ADXL345_REG_FIFO_CTL - ADXL345_SHADOW_FIRST]))
+    {
+        return false;
+    }
+
+    shadowValid = true;
+
+    // Range or FULL_RES may have changed with the device
+    updateScale();
+
+    return true;
+}
+
+// Configuration equivalent to begin() + clearSettings(): measurement mode,
+// +-2g full resolution, 100 Hz, all detection features off, FIFO bypassed
+ADXL345Config ADXL345::defaultConfig(void)
+{
+    ADXL345Config config;
+
+    config.range = ADXL345_RANGE_2G;
+    config.dataRate = ADXL345_DATARATE_100HZ;
+    config.fullResolution = true;
+    config.tapThreshold = 0;
+    config.offsetX = 0;
+    config.offsetY = 0;
+    config.offsetZ = 0;
+    config.tapDuration = 0;
+    config.doubleTapLatency = 0;
+    config.doubleTapWindow = 0;
+    config.activityThreshold = 0;
+    config.inactivityThreshold = 0;
+    config.timeInactivity = 0;
+    config.actInactControl = 0;
+    config.freeFallThreshold = 0;
+    config.freeFallDuration = 0;
+    config.tapAxes = 0;
+    config.intEnable = 0;
+    config.intMap = 0;
+    config.fifoMode = ADXL345_FIFO_BYPASS;
+    config.fifoWatermark = 0;
+    config.fifoTrigger = ADXL345_INT1;
+
+    return config;
+}
+
+// Apply a complete configuration.
+// Reading back the configuration spans (THRESH_TAP..INT_MAP, DATA_FORMAT,
+// FIFO_CTL) checks whether the device already holds it (warm restart);
+// INT_SOURCE and DATAX0..DATAZ1 are skipped, as reading them clears latched
+// interrupts and pops the FIFO. Otherwise the register spans are written
+// with auto-increment writes and measurement mode is enabled last.
+bool ADXL345::apply(const ADXL345Config &config)
+{
+    uint8_t image[ADXL345_SHADOW_SIZE];
+    uint8_t current[ADXL345_SHADOW_SIZE];
+    unsigned int configSpan = ADXL345_REG_INT_MAP - ADXL345_SHADOW_FIRST + 1;
+
+    buildImage(config, image);
+    _range = config.range;
+
+    if (readRegisters(ADXL345_SHADOW_FIRST, current, configSpan) == configSpan &&
+        readRegisters(ADXL345_REG_DATA_FORMAT, &current[ADXL345_REG_DATA_FORMAT - ADXL345_SHADOW_FIRST], 1) == 1 &&
+        readRegisters(ADXL345_REG_FIFO_CTL, &current[ADXL345_REG_FIFO_CTL - ADXL345_SHADOW_FIRST], 1) == 1)
+    {
+        bool match = true;
+
+        for (uint8_t i = 0; i < ADXL345_SHADOW_SIZE; i++)
+        {
+            if (isShadowed(ADXL345_SHADOW_FIRST + i))
+            {
+                shadow[i] = current[i];
+                match = match && (current[i] == image[i]);
+            }
+        }
+
+        shadowValid = true;
+
+        if (match)
+        {
+            updateScale();
+            return true;
+        }
+    }
+
+    uint8_t power = image[ADXL345_REG_POWER_CTL - ADXL345_SHADOW_FIRST];
+    image[ADXL345_REG_POWER_CTL - ADXL345_SHADOW_FIRST] = power & ~0x08;
+
+    // THRESH_TAP..TAP_AXES (skipping read-only ACT_TAP_STATUS), then BW_RATE..INT_MAP in standby
+    unsigned int lowSpan = ADXL345_REG_TAP_AXES - ADXL345_REG_THRESH_TAP + 1;
+    unsigned int highSpan = ADXL345_REG_INT_MAP - ADXL345_REG_BW_RATE + 1;
+    bool ok = writeRegisters(ADXL345_REG_THRESH_TAP,
+                             &image[ADXL345_REG_THRESH_TAP - ADXL345_SHADOW_FIRST], lowSpan) == lowSpan;
+    ok = ok && writeRegisters(ADXL345_REG_BW_RATE,
+                              &image[ADXL345_REG_BW_RATE - ADXL345_SHADOW_FIRST], highSpan) == highSpan;
+
+    ok = ok && writeRegister8(ADXL345_REG_DATA_FORMAT, image[ADXL345_REG_DATA_FORMAT - ADXL345_SHADOW_FIRST]);
+    ok = ok && writeRegister8(ADXL345_REG_FIFO_CTL, image[ADXL345_REG_FIFO_CTL - ADXL345_SHADOW_FIRST]);
+    ok = ok && writeRegister8(ADXL345_REG_POWER_CTL, power);
+
+    shadowValid = ok;
+    updateScale();
+
+    return ok;
+}
+
+// Lay out a configuration as register values, indexed like the shadow
+void ADXL345::buildImage(const ADXL345Config &config, uint8_t *image)
+{
+    for (uint8_t i = 0; i < ADXL345_SHADOW_SIZE; i++)
+    {
+        image[i] = 0;
+    }
+
+    image[ADXL345_REG_THRESH_TAP - ADXL345_SHADOW_FIRST] = config.tapThreshold;
+    image[ADXL345_REG_OFSX - ADXL345_SHADOW_FIRST] = (uint8_t)config.offsetX;
+    image[ADXL345_REG_OFSY - ADXL345_SHADOW_FIRST] = (uint8_t)config.offsetY;
+    image[ADXL345_REG_OFSZ - ADXL345_SHADOW_FIRST] = (uint8_t)config.offsetZ;
+    image[ADXL345_REG_DUR - ADXL345_SHADOW_FIRST] = config.tapDuration;
+    image[ADXL345_REG_LATENT - ADXL345_SHADOW_FIRST] = config.doubleTapLatency;
+    image[ADXL345_REG_WINDOW - ADXL345_SHADOW_FIRST] = config.doubleTapWindow;
+    image[ADXL345_REG_THRESH_ACT - ADXL345_SHADOW_FIRST] = config.activityThreshold;
+    image[ADXL345_REG_THRESH_INACT - ADXL345_SHADOW_FIRST] = config.inactivityThreshold;
+    image[ADXL345_REG_TIME_INACT - ADXL345_SHADOW_FIRST] = config.timeInactivity;
+    image[ADXL345_REG_ACT_INACT_CTL - ADXL345_SHADOW_FIRST] = config.actInactControl;
+    image[ADXL345_REG_THRESH_FF - ADXL345_SHADOW_FIRST] = config.freeFallThreshold;
+    image[ADXL345_REG_TIME_FF - ADXL345_SHADOW_FIRST] = config.freeFallDuration;
+    image[ADXL345_REG_TAP_AXES - ADXL345_SHADOW_FIRST] = config.tapAxes;
+    image[ADXL345_REG_BW_RATE - ADXL345_SHADOW_FIRST] = config.dataRate;
+    image[ADXL345_REG_POWER_CTL - ADXL345_SHADOW_FIRST] = 0x08;
+    image[ADXL345_REG_INT_ENABLE - ADXL345_SHADOW_FIRST] = config.intEnable;
+    image[ADXL345_REG_INT_MAP - ADXL345_SHADOW_FIRST] = config.intMap;
+    image[ADXL345_REG_DATA_FORMAT - ADXL345_SHADOW_FIRST] = config.range | (config.fullResolution ? 0x08 : 0x00);
+    image[ADXL345_REG_FIFO_CTL - ADXL345_SHADOW_FIRST] =
+        (config.fifoMode << 6) | ((config.fifoTrigger & 0x01) << 5) | (config.fifoWatermark & 0x1F);
+}
+
+// Set FIFO mode and watermark (samples before the WATERMARK interrupt, 0..31)
+void ADXL345::setFifoMode(adxl345_fifoMode_t mode, uint8_t watermark, adxl345_int_t trigger)
+{
+    // (|) 0bxx000000 (mode - FIFO_MODE)
+    // (|) 0b00x00000 (trigger - Trigger event on INT1/INT2)
+    // (|) 0b000xxxxx (watermark - Samples)
+    uint8_t value = (mode << 6) | ((trigger & 0x01) << 5) | (watermark & 0x1F);
+
+    writeRegister8(ADXL345_REG_FIFO_CTL, value);
+}
+
+// Get FIFO mode
+adxl345_fifoMode_t ADXL345::getFifoMode(void)
+{
+    return (adxl345_fifoMode_t)((readRegister8(ADXL345_REG_FIFO_CTL) >> 6) & 0x03);
+}
+
+// Get FIFO watermark
+uint8_t ADXL345::getFifoWatermark(void)
+{
+    return readRegister8(ADXL345_REG_FIFO_CTL) & 0x1F;
+}
+
+// Get number of samples waiting in the FIFO
+uint8_t ADXL345::getFifoEntries(void)
+{
+    return readRegister8(ADXL345_REG_FIFO_STATUS) & 0x3F;
+}
+
+// Drain up to max pending FIFO samples into xyz (interleaved x, y, z, 3 * max values)
+size_t ADXL345::drainFifo(int16_t *xyz, size_t max)
+{
+    size_t total = 0;
+
+    while (total < max)
+    {
+        size_t entries = getFifoEntries();
+
+        if (entries == 0)
+        {
+            break;
+        }
+
+        if (entries > max - total)
+        {
+            entries = max - total;
+        }
+
+        // Each 6-byte burst pops one FIFO entry; the STOP/START gap between
+        // bursts covers the 5 us the FIFO needs to advance at <= 400 kHz
+        size_t read = readRawInto(&xyz[3 * total], entries);
+        total += read;
+
+        if (read != entries)
+        {
+            break;
+        }
+    }
+
+    return total;
+}
+
+// Write byte to register; true if the device took both bytes
+bool ADXL345::writeRegister8(uint8_t reg, uint8_t value)
 {
     // Wire.beginTransmission(ADXL345_ADDRESS);
     // Wire.write(reg);
@@ -167,78 +441,127 @@ void ADXL345::writeRegister8(uint8_t reg, uint8_t value)
     
     uint8_t send_buffer[2] = {reg, value};
 	unsigned int written_bytes = Wire->write(ADXL345_ADDRESS, send_buffer, 2);
+
+    if (written_bytes != 2)
+    {
+        return false;
+    }
+
+    // Write-through: keep the shadow in step with the device
+    if (isShadowed(reg))
+    {
+        shadow[reg - ADXL345_SHADOW_FIRST] = value;
+    }
+
+    return true;
 }
 
-// Read byte to register
+// Read byte from register; 0 if the device did not answer
 uint8_t ADXL345::fastRegister8(uint8_t reg)
 {
-    uint8_t value[1]; // value;
+    uint8_t value = 0;
+
+    fastRegister8(reg, &value);
+
+    return value;
+}
+
+// Read byte from register; false (value untouched) if the read failed
+bool ADXL345::fastRegister8(uint8_t reg, uint8_t *value)
+{
+    uint8_t received[1];
     // Wire.beginTransmission(ADXL345_ADDRESS);
     // Wire.write(reg);
-    // Wire.endTransmission();
-    uint8_t send_buffer[1];
-	send_buffer[0] = reg;
-	unsigned int written_bytes = Wire->write(ADXL345_ADDRESS, send_buffer, 1);
-    
+    // Wire.endTransmission(false);
     // Wire.requestFrom(ADXL345_ADDRESS, 1);
     // value = Wire.read();
-    // Wire.endTransmission();
-	unsigned int read_bytes = Wire->read(ADXL345_ADDRESS, value, 1);
+    uint8_t send_buffer[1];
+	send_buffer[0] = reg;
+	unsigned int read_bytes = Wire->writeRead(ADXL345_ADDRESS, send_buffer, 1, received, 1);
+
+    if (read_bytes != 1)
+    {
+        return false;
+    }
 
-    return value[0];
+    *value = received[0];
+    return true;
 }
 
 // Read byte from register
 uint8_t ADXL345::readRegister8(uint8_t reg)
 {
-    uint8_t value[1];
-    // Wire.beginTransmission(ADXL345_ADDRESS);
-    // Wire.write(reg);
-    // Wire.endTransmission();
-    uint8_t send_buffer[1];
-	send_buffer[0] = reg;
-	unsigned int written_bytes = Wire->write(ADXL345_ADDRESS, send_buffer, 1);
-
-    // Wire.beginTransmission(ADXL345_ADDRESS);
-    // Wire.requestFrom(ADXL345_ADDRESS, 1);
-    // while(!Wire.available()) {};
-    // value = Wire.read();
-    // Wire.endTransmission();
-    unsigned int read_bytes = Wire->read(ADXL345_ADDRESS, value, 1);
+    // Configuration registers are served from the shadow once it is loaded
+    if (shadowValid && isShadowed(reg))
+    {
+        return shadow[reg - ADXL345_SHADOW_FIRST];
+    }
 
-    return value[0];
+    return fastRegister8(reg);
 }
 
 // Read word from register
 int16_t ADXL345::readRegister16(uint8_t reg)
 {
     int16_t value;
-    // Wire.beginTransmission(ADXL345_ADDRESS);
-    // Wire.write(reg);
-    // Wire.endTransmission();
-    uint8_t va[2];
+    uint8_t va[2] = {0, 0};
+
+    readRegisters(reg, va, 2);
+
+    value = va[1] << 8 | va[0];
+
+    return value;
+}
+
+// Read length consecutive registers starting at reg (auto-increment burst)
+unsigned int ADXL345::readRegisters(uint8_t reg, uint8_t *buffer, unsigned int length)
+{
+    // Register pointer write and data read share one transaction (repeated START)
     uint8_t send_buffer[1];
-	send_buffer[0] = reg;
-	unsigned int written_bytes = Wire->write(ADXL345_ADDRESS, send_buffer, 1);
+    send_buffer[0] = reg;
 
-    // Wire.beginTransmission(ADXL345_ADDRESS);
-    // Wire.requestFrom(ADXL345_ADDRESS, 2);
-    // while(!Wire.available()) {};
-    // uint8_t vla = Wire.read();
-    // uint8_t vha = Wire.read();
-    // Wire.endTransmission();
-    unsigned int read_bytes = Wire->read(ADXL345_ADDRESS, va, 2);
+    return Wire->writeRead(ADXL345_ADDRESS, send_buffer, 1, buffer, length);
+}
 
+// Write length consecutive registers starting at reg (auto-increment burst)
+unsigned int ADXL345::writeRegisters(uint8_t reg, const uint8_t *buffer, unsigned int length)
+{
+    uint8_t send_buffer[1 + ADXL345_SHADOW_SIZE];
 
-    value = va[0] << 8 | va[1];
+    if (length > ADXL345_SHADOW_SIZE)
+    {
+        return 0;
+    }
 
-    return value;
+    send_buffer[0] = reg;
+    for (unsigned int i = 0; i < length; i++)
+    {
+        send_buffer[1 + i] = buffer[i];
+    }
+
+    unsigned int written_bytes = Wire->write(ADXL345_ADDRESS, send_buffer, length + 1);
+    unsigned int written = written_bytes > 0 ? written_bytes - 1 : 0;
+
+    // Write-through for the registers the device acknowledged
+    for (unsigned int i = 0; i < written; i++)
+    {
+        if (isShadowed(reg + i))
+        {
+            shadow[reg + i - ADXL345_SHADOW_FIRST] = buffer[i];
+        }
+    }
+
+    return written;
 }
 
 void ADXL345::readADXL345(int16_t *x, int16_t *y, int16_t *z) {
-    *x = readRegister16(ADXL345_REG_DATAX0);
-    *y = readRegister16(ADXL345_REG_DATAX0 + 2);
-    *z = readRegister16(ADXL345_REG_DATAX0 + 4);
+    int16_t xyz[3] = {0, 0, 0};
+
+    readRawInto(xyz, 1);
+
+    *x = xyz[0];
+    *y = xyz[1];
+    *z = xyz[2];
 }
 
 void ADXL345::writeRegisterBit(uint8_t reg, uint8_t pos, bool state)
@@ -262,4 +585,17 @@ bool ADXL345::readRegisterBit(uint8_t reg, uint8_t pos)
     uint8_t value;
     value = readRegister8(reg);
     return ((value >> pos) & 1);
+}
+
+// Configuration registers mirrored in RAM (status/data registers are always read from the device)
+bool ADXL345::isShadowed(uint8_t reg)
+{
+    if (reg == ADXL345_REG_ACT_TAP_STATUS)
+    {
+        return false;
+    }
+
+    return (reg >= ADXL345_REG_THRESH_TAP && reg <= ADXL345_REG_INT_MAP) ||
+           reg == ADXL345_REG_DATA_FORMAT ||
+           reg == ADXL345_REG_FIFO_CTL;
 }
\ No newline at end of file
@@ -0,0 +1,255 @@
+/******************************************************************************
+ *
+ *
+ * @file axiWireAsync.hpp
+ *
+ * Interrupt-driven, non-blocking I2C transfer engine for AXI IIC.
+ *
+ * Transactions (optional write phase, optional read phase joined by a
+ * repeated START) are queued with submit() and run from the IIC interrupt;
+ * the callback fires in interrupt context when the transaction ends.
+ * The engine is parameterised on a port: XIicAsyncPort drives the XIic
+ * interrupt driver (which manages the Tx/Rx FIFO thresholds), and with
+ * AXIWIRE_HOST defined SimIicAsyncPort (axiWireSim.hpp) stands in with a
+ * simulated completion source.
+ *
+ * Hardware usage: connect AxiWireAsync::interruptHandler to the AXI INTC
+ * input of the IIC, e.g.
+ *   XIntc_RegisterHandler(INTC_BASEADDR, IIC_INTR_ID,
+ *                         AxiWireAsync::interruptHandler, &wire);
+ *
+ *****************************************************************************/
+#ifndef _AXI_WIRE_ASYNC_H_
+#define _AXI_WIRE_ASYNC_H_
+
+#include <stddef.h>
+
+#ifndef AXIWIRE_QUEUE_DEPTH
+#define AXIWIRE_QUEUE_DEPTH 8   // must be a power of two
+#endif
+
+// Completion status passed to the transaction callback
+#define AXIWIRE_OK          0
+#define AXIWIRE_NACK        1
+#define AXIWIRE_ARB_LOST    2
+#define AXIWIRE_ERROR       3
+
+struct AxiWireTransaction;
+typedef void (*AxiWireCallback)(AxiWireTransaction *transaction, void *ref);
+
+struct AxiWireTransaction
+{
+    unsigned int slave_address;
+    unsigned char *tx;          // write phase (may be NULL)
+    unsigned int tx_length;
+    unsigned char *rx;          // read phase after repeated START (may be NULL)
+    unsigned int rx_length;
+    volatile int status;
+
+    // filled in by submit()
+    AxiWireCallback callback;
+    void *ref;
+};
+
+template <class Port>
+class BasicAxiWireAsync {
+public:
+    BasicAxiWireAsync(unsigned int device) : port(device), head(0), tail(0), active(NULL), reading(false){
+        port.bind(portDone, this);
+    }
+
+    // Queue a transaction; returns false if the queue is full.
+    // The transaction (and its buffers) must stay valid until the callback.
+    bool submit(AxiWireTransaction *transaction, AxiWireCallback callback, void *ref){
+        if (tail - head >= AXIWIRE_QUEUE_DEPTH){
+            return false;
+        }
+
+        transaction->callback = callback;
+        transaction->ref = ref;
+        transaction->status = AXIWIRE_OK;
+
+        queue[tail & (AXIWIRE_QUEUE_DEPTH - 1)] = transaction;
+
+        port.lock();
+        tail = tail + 1;
+        if (active == NULL){
+            startNext();
+        }
+        port.unlock();
+
+        return true;
+    }
+
+    bool busy() const {
+        return active != NULL || head != tail;
+    }
+
+    unsigned int pending() const {
+        return tail - head;
+    }
+
+    Port &getPort(){
+        return port;
+    }
+
+    // IIC interrupt entry point (register with the INTC)
+    static void interruptHandler(void *ref){
+        static_cast<BasicAxiWireAsync *>(ref)->port.service();
+    }
+
+private:
+    void startNext(){
+        while (head != tail){
+            active = queue[head & (AXIWIRE_QUEUE_DEPTH - 1)];
+            head = head + 1;
+
+            int status;
+            if (active->tx_length > 0){
+                reading = false;
+                status = port.startWrite(active->slave_address, active->tx, active->tx_length,
+                                         active->rx_length > 0);
+            } else {
+                reading = true;
+                status = port.startRead(active->slave_address, active->rx, active->rx_length);
+            }
+
+            if (status == AXIWIRE_OK){
+                return;
+            }
+
+            finish(status);
+            if (active != NULL){
+                return;     // the callback submitted, and that started the queue
+            }
+        }
+        active = NULL;
+    }
+
+    void finish(int status){
+        AxiWireTransaction *done = active;
+        active = NULL;
+        done->status = status;
+        if (done->callback != NULL){
+            done->callback(done, done->ref);
+        }
+    }
+
+    // Called by the port from interrupt context when a phase ends
+    static void portDone(void *ref, int status){
+        BasicAxiWireAsync *self = static_cast<BasicAxiWireAsync *>(ref);
+
+        if (self->active == NULL){
+            return;
+        }
+
+        if (status == AXIWIRE_OK && !self->reading && self->active->rx_length > 0){
+            self->reading = true;
+            status = self->port.startRead(self->active->slave_address,
+                                          self->active->rx, self->active->rx_length);
+            if (status == AXIWIRE_OK){
+                return;
+            }
+        }
+
+        self->finish(status);
+        // A callback that submits has already started the next transaction
+        if (self->active == NULL){
+            self->startNext();
+        }
+    }
+
+    Port port;
+    AxiWireTransaction *queue[AXIWIRE_QUEUE_DEPTH];
+    volatile unsigned int head;
+    volatile unsigned int tail;
+    AxiWireTransaction *volatile active;
+    bool reading;
+};
+
+#ifdef AXIWIRE_HOST
+
+#include "axiWireSim.hpp"
+typedef BasicAxiWireAsync<SimIicAsyncPort> AxiWireAsync;
+
+#else
+
+#include <xparameters.h>
+#include "xiic.h"
+#include "xiic_l.h"
+
+// Port over the XIic interrupt driver
+class XIicAsyncPort {
+public:
+    XIicAsyncPort(unsigned int device) : done(NULL), doneRef(NULL){
+        XIic_Initialize(&xi2c, device);
+        XIic_SetSendHandler(&xi2c, this, sendHandler);
+        XIic_SetRecvHandler(&xi2c, this, recvHandler);
+        XIic_SetStatusHandler(&xi2c, this, statusHandler);
+        XIic_Start(&xi2c);
+    }
+    void bind(void (*callback)(void *, int), void *ref){
+        done = callback;
+        doneRef = ref;
+    }
+    int startWrite(unsigned int slave_address, unsigned char *buffer, unsigned int length, bool hold){
+        setRepeatedStart(hold);
+        XIic_SetAddress(&xi2c, XII_ADDR_TO_SEND_TYPE, slave_address);
+        return XIic_MasterSend(&xi2c, buffer, length) == XST_SUCCESS ? AXIWIRE_OK : AXIWIRE_ERROR;
+    }
+    int startRead(unsigned int slave_address, unsigned char *buffer, unsigned int length){
+        setRepeatedStart(false);
+        XIic_SetAddress(&xi2c, XII_ADDR_TO_SEND_TYPE, slave_address);
+        return XIic_MasterRecv(&xi2c, buffer, length) == XST_SUCCESS ? AXIWIRE_OK : AXIWIRE_ERROR;
+    }
+    void service(){
+        XIic_InterruptHandler(&xi2c);
+    }
+    // Mask the IIC interrupt while the queue is kicked from task context
+    void lock(){
+        XIic_IntrGlobalDisable(xi2c.BaseAddress);
+    }
+    void unlock(){
+        XIic_IntrGlobalEnable(xi2c.BaseAddress);
+    }
+    XIic *instance(){
+        return &xi2c;
+    }
+
+private:
+    void setRepeatedStart(bool hold){
+        u32 options = XIic_GetOptions(&xi2c);
+        if (hold){
+            options |= XII_REPEATED_START_OPTION;
+        } else {
+            options &= ~XII_REPEATED_START_OPTION;
+        }
+        XIic_SetOptions(&xi2c, options);
+    }
+    static void sendHandler(void *ref, int byteCount){
+        XIicAsyncPort *self = static_cast<XIicAsyncPort *>(ref);
+        self->done(self->doneRef, byteCount == 0 ? AXIWIRE_OK : AXIWIRE_ERROR);
+    }
+    static void recvHandler(void *ref, int byteCount){
+        XIicAsyncPort *self = static_cast<XIicAsyncPort *>(ref);
+        self->done(self->doneRef, byteCount == 0 ? AXIWIRE_OK : AXIWIRE_ERROR);
+    }
+    static void statusHandler(void *ref, int event){
+        XIicAsyncPort *self = static_cast<XIicAsyncPort *>(ref);
+        if (event & XII_SLAVE_NO_ACK_EVENT){
+            self->done(self->doneRef, AXIWIRE_NACK);
+        } else if (event & XII_ARB_LOST_EVENT){
+            self->done(self->doneRef, AXIWIRE_ARB_LOST);
+        }
+    }
+
+    XIic xi2c;
+    void (*done)(void *, int);
+    void *doneRef;
+};
+
+typedef BasicAxiWireAsync<XIicAsyncPort> AxiWireAsync;
+
+#endif // AXIWIRE_HOST
+
+#endif // _AXI_WIRE_ASYNC_H_
@@ -0,0 +1,246 @@
+/*
+bramRing.h - Single-producer / single-consumer message ring in shared BRAM.
+
+The producer (MicroBlaze) queues typed messages - a batch of samples, an
+FFT frame - into fixed-size slots; the consumer (A53, bare-metal or Linux)
+takes them out in order. Nothing is overwritten in place, so a consumer
+that polls late still receives every message the ring could hold, and one
+that polls early sees "empty" from a single word read.
+
+Layout (32-bit words from the base address; 64-byte lines so the two
+sides never write the same cache line):
+    line 0  producer    tail, dropped, slots, slotWords, magic
+    line 1  consumer    head
+    line 2  slots       slots x slotWords words, each
+                        [type:16 | words:16] followed by the payload
+
+tail and head run freely (wrap at 2^32); slots must be a power of two.
+Messages that find the ring full are not queued and are counted in
+dropped. Each side keeps a cached copy of the other side's index and only
+re-reads it from BRAM when the cached value says full / empty.
+
+Producer:
+    bram_ring_t ring;
+    bramring_init(&ring, (void *)BRAM_BASE, 16, 1 + 96);
+    bramring_push(&ring, MSG_SAMPLES, words, 96);
+Consumer:
+    bram_ring_t ring;
+    while (!bramring_attach(&ring, (void *)BRAM_BASE)) {}   // wait for init
+    uint32_t type, n = bramring_pop(&ring, buffer, sizeof(buffer) / 4, &type);
+
+On Linux map the BRAM with mmap() of /dev/mem (O_SYNC) or a UIO device
+and pass the mapped address; a plain shared-memory page works as a host
+stand-in (PC_BramRing_Bench.c).
+*/
+
+#ifndef BRAMRING_h
+#define BRAMRING_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__MICROBLAZE__)
+#define BRAMRING_BARRIER()      __asm__ __volatile__ ("mbar 1" ::: "memory")
+#elif defined(__aarch64__)
+#define BRAMRING_BARRIER()      __asm__ __volatile__ ("dmb sy" ::: "memory")
+#elif defined(__arm__)
+#define BRAMRING_BARRIER()      __asm__ __volatile__ ("dmb" ::: "memory")
+#else
+#define BRAMRING_BARRIER()      __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+#define BRAMRING_MAGIC          0x42524E47u     // "BRNG"
+#define BRAMRING_LINE_WORDS     16              // 64-byte cache line
+
+// Control words
+#define BRAMRING_TAIL           0
+#define BRAMRING_DROPPED        1
+#define BRAMRING_SLOTS          2
+#define BRAMRING_SLOT_WORDS     3
+#define BRAMRING_ID             4
+#define BRAMRING_HEAD           (BRAMRING_LINE_WORDS)
+#define BRAMRING_DATA           (2 * BRAMRING_LINE_WORDS)
+
+// Bytes of BRAM needed for a ring
+#define BRAMRING_BYTES(slots, slotWords)    (4 * (BRAMRING_DATA + (slots) * (slotWords)))
+
+typedef struct
+{
+    volatile uint32_t *base;
+    uint32_t slots;
+    uint32_t slotWords;
+    uint32_t index;         // own side's tail (producer) or head (consumer)
+    uint32_t peer;          // last value read of the other side's index
+    uint32_t dropped;       // producer only
+} bram_ring_t;
+
+static inline volatile uint32_t *bramring_slot(const bram_ring_t *r, uint32_t index)
+{
+    return r->base + BRAMRING_DATA + (index & (r->slots - 1)) * r->slotWords;
+}
+
+// --- Producer ---
+
+// Format the ring; slotWords includes the one-word message header.
+// Returns 0 if slots is not a power of two.
+static inline int bramring_init(bram_ring_t *r, volatile void *base, uint32_t slots, uint32_t slotWords)
+{
+    if (slots == 0 || (slots & (slots - 1)) != 0 || slotWords < 2)
+    {
+        return 0;
+    }
+
+    r->base = (volatile uint32_t *)base;
+    r->slots = slots;
+    r->slotWords = slotWords;
+    r->index = 0;
+    r->peer = 0;
+    r->dropped = 0;
+
+    r->base[BRAMRING_ID] = 0;
+    BRAMRING_BARRIER();
+    r->base[BRAMRING_TAIL] = 0;
+    r->base[BRAMRING_DROPPED] = 0;
+    r->base[BRAMRING_SLOTS] = slots;
+    r->base[BRAMRING_SLOT_WORDS] = slotWords;
+    r->base[BRAMRING_HEAD] = 0;
+    BRAMRING_BARRIER();
+    r->base[BRAMRING_ID] = BRAMRING_MAGIC;
+    return 1;
+}
+
+// Payload area of the next free slot (slotWords - 1 words), or NULL when full
+// (counted as dropped). Fill it, then bramring_publish().
+static inline volatile uint32_t *bramring_claim(bram_ring_t *r)
+{
+    if (r->index - r->peer >= r->slots)
+    {
+        r->peer = r->base[BRAMRING_HEAD];
+        BRAMRING_BARRIER();
+        if (r->index - r->peer >= r->slots)
+        {
+            r->dropped++;
+            r->base[BRAMRING_DROPPED] = r->dropped;
+            return (volatile uint32_t *)0;
+        }
+    }
+    return bramring_slot(r, r->index) + 1;
+}
+
+static inline void bramring_publish(bram_ring_t *r, uint32_t type, uint32_t words)
+{
+    bramring_slot(r, r->index)[0] = (type << 16) | (words & 0xFFFF);
+    BRAMRING_BARRIER();
+    r->index++;
+    r->base[BRAMRING_TAIL] = r->index;
+}
+
+// Copy a message in; returns 0 if the ring is full or the message too long
+static inline int bramring_push(bram_ring_t *r, uint32_t type, const uint32_t *payload, uint32_t words)
+{
+    volatile uint32_t *slot;
+    uint32_t i;
+
+    if (words > r->slotWords - 1 || (slot = bramring_claim(r)) == 0)
+    {
+        return 0;
+    }
+    for (i = 0; i < words; i++)
+    {
+        slot[i] = payload[i];
+    }
+    bramring_publish(r, type, words);
+    return 1;
+}
+
+// --- Consumer ---
+
+// Pick up a ring formatted by the producer; returns 0 until it has been
+static inline int bramring_attach(bram_ring_t *r, volatile void *base)
+{
+    r->base = (volatile uint32_t *)base;
+    if (r->base[BRAMRING_ID] != BRAMRING_MAGIC)
+    {
+        return 0;
+    }
+    BRAMRING_BARRIER();
+
+    r->slots = r->base[BRAMRING_SLOTS];
+    r->slotWords = r->base[BRAMRING_SLOT_WORDS];
+    r->index = r->base[BRAMRING_HEAD];
+    r->peer = r->index;
+    r->dropped = 0;
+    return 1;
+}
+
+// Messages waiting (re-reads the producer's tail)
+static inline uint32_t bramring_available(bram_ring_t *r)
+{
+    r->peer = r->base[BRAMRING_TAIL];
+    BRAMRING_BARRIER();
+    return r->peer - r->index;
+}
+
+// Oldest message in place, or NULL when empty; its header gives type and length
+static inline const volatile uint32_t *bramring_peek(bram_ring_t *r, uint32_t *type, uint32_t *words)
+{
+    const volatile uint32_t *slot;
+    uint32_t header;
+
+    if (r->index == r->peer && bramring_available(r) == 0)
+    {
+        return (const volatile uint32_t *)0;
+    }
+
+    slot = bramring_slot(r, r->index);
+    header = slot[0];
+    *type = header >> 16;
+    *words = header & 0xFFFF;
+    return slot + 1;
+}
+
+// Hand the peeked slot back to the producer
+static inline void bramring_release(bram_ring_t *r)
+{
+    BRAMRING_BARRIER();
+    r->index++;
+    r->base[BRAMRING_HEAD] = r->index;
+}
+
+// Copy the oldest message out (truncated to max words); returns its length,
+// 0 when the ring is empty
+static inline uint32_t bramring_pop(bram_ring_t *r, uint32_t *dst, uint32_t max, uint32_t *type)
+{
+    uint32_t words, i;
+    const volatile uint32_t *payload = bramring_peek(r, type, &words);
+
+    if (payload == 0)
+    {
+        return 0;
+    }
+    if (words > max)
+    {
+        words = max;
+    }
+    for (i = 0; i < words; i++)
+    {
+        dst[i] = payload[i];
+    }
+    bramring_release(r);
+    return words;
+}
+
+// Messages the producer could not queue so far
+static inline uint32_t bramring_dropped(const bram_ring_t *r)
+{
+    return r->base[BRAMRING_DROPPED];
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
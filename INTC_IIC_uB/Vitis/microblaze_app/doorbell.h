@@ -0,0 +1,289 @@
+/*
+doorbell.h - MicroBlaze -> A53 doorbell interrupt.
+
+Replaces "poll the shared BRAM every N ms" with an interrupt: after
+publishing data the MicroBlaze pulses a 1-bit AXI GPIO wired to the PS's
+pl_ps_irq0[0] (GIC SPI 121, rising edge). The A53 sleeps in WFI until the
+pulse arrives, then drains everything that was published.
+
+Coalescing: the first pulse masks the doorbell at the GIC, so while the A53
+is draining further pulses only set the interrupt pending instead of
+entering the ISR again. doorbell_rearm() unmasks it once the A53 has
+drained; a pulse that arrived meanwhile fires straight away, so nothing is
+missed and under load the A53 takes one interrupt per batch of messages
+rather than one per message.
+
+Latency: the ISR timestamps the interrupt and doorbell_wait() measures how
+long the A53 took from there to resume the waiting code (min / average /
+max in doorbell_t.stats). There is no clock shared with the MicroBlaze, so
+the GPIO-to-GIC part is not included; the host stand-in measures the
+whole ring-to-wake path.
+
+    MicroBlaze                          A53
+    doorbell_init(&bell, GPIO_BASE);    doorbell_attach(&bell, &gic, DOORBELL_INT_ID);
+    publish data                        while (1) {
+    doorbell_ring(&bell);                   doorbell_wait(&bell);
+                                            drain data
+                                            doorbell_rearm(&bell);
+                                        }
+
+Built with DOORBELL_HOST the same calls run on Linux over an eventfd:
+ring writes 1 (the kernel adds up rings nobody has read yet) and wait
+blocks in read() and returns how many rings it collected
+(PC_Doorbell_Test.c).
+*/
+
+#ifndef DOORBELL_h
+#define DOORBELL_h
+
+#include <stdint.h>
+
+#if defined(DOORBELL_HOST)
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#elif defined(__MICROBLAZE__)
+#include "xil_io.h"
+#else
+#include "xscugic.h"
+#include "xil_exception.h"
+#include "xtime_l.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DOORBELL_INT_ID             121     // pl_ps_irq0[0] on the GIC
+#define DOORBELL_PRIORITY           0xA0
+
+// AXI GPIO registers (channel 1)
+#define DOORBELL_GPIO_DATA          0x00
+#define DOORBELL_GPIO_TRI           0x04
+
+typedef struct
+{
+    uint32_t wakeups;       // doorbell_wait() returns
+    uint32_t rings;         // rings collected by those wakeups
+    uint32_t latencySamples;
+    uint32_t latencyMinNs;
+    uint32_t latencyMaxNs;
+    uint64_t latencySumNs;
+} doorbell_stats_t;
+
+static inline void doorbell_clearStats(doorbell_stats_t *s)
+{
+    s->wakeups = 0;
+    s->rings = 0;
+    s->latencySamples = 0;
+    s->latencyMinNs = 0;
+    s->latencyMaxNs = 0;
+    s->latencySumNs = 0;
+}
+
+#define DOORBELL_LATENCY_UNKNOWN    UINT64_MAX
+
+static inline void doorbell_record(doorbell_stats_t *s, uint32_t rings, uint64_t latencyNs)
+{
+    uint32_t ns = latencyNs > 0xFFFFFFFFu ? 0xFFFFFFFFu : (uint32_t)latencyNs;
+
+    s->rings += rings;
+    s->wakeups++;
+    if (latencyNs == DOORBELL_LATENCY_UNKNOWN)
+    {
+        return;
+    }
+
+    if (s->latencySamples == 0 || ns < s->latencyMinNs)
+    {
+        s->latencyMinNs = ns;
+    }
+    if (ns > s->latencyMaxNs)
+    {
+        s->latencyMaxNs = ns;
+    }
+    s->latencySumNs += ns;
+    s->latencySamples++;
+}
+
+static inline uint32_t doorbell_latencyAvgNs(const doorbell_stats_t *s)
+{
+    return s->latencySamples ? (uint32_t)(s->latencySumNs / s->latencySamples) : 0;
+}
+
+#if defined(DOORBELL_HOST)
+
+// --- Linux stand-in: both sides share one doorbell_t ---
+
+typedef struct
+{
+    int fd;
+    uint64_t firstRing;     // ns timestamp of the oldest uncollected ring, 0 if none
+    uint32_t rings;         // producer side
+    doorbell_stats_t stats; // consumer side
+} doorbell_t;
+
+static inline uint64_t doorbell_nowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static inline int doorbell_init(doorbell_t *db)
+{
+    db->fd = eventfd(0, 0);
+    db->firstRing = 0;
+    db->rings = 0;
+    doorbell_clearStats(&db->stats);
+    return db->fd >= 0;
+}
+
+static inline void doorbell_ring(doorbell_t *db)
+{
+    uint64_t one = 1, none = 0;
+
+    __atomic_compare_exchange_n(&db->firstRing, &none, doorbell_nowNs(), 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+    db->rings++;
+    if (write(db->fd, &one, sizeof(one)) != sizeof(one))
+    {
+        return;
+    }
+}
+
+// Block until rung; returns the number of rings collected
+static inline uint32_t doorbell_wait(doorbell_t *db)
+{
+    uint64_t count = 0;
+
+    if (read(db->fd, &count, sizeof(count)) != sizeof(count))
+    {
+        return 0;
+    }
+    uint64_t first = __atomic_exchange_n(&db->firstRing, 0, __ATOMIC_ACQUIRE);
+    uint64_t now = doorbell_nowNs();
+    // A ring that lands between read() and here is collected by the next
+    // wait, which then finds no timestamp
+    doorbell_record(&db->stats, (uint32_t)count, first != 0 ? now - first : DOORBELL_LATENCY_UNKNOWN);
+    return (uint32_t)count;
+}
+
+static inline void doorbell_rearm(doorbell_t *db)
+{
+    (void)db;
+}
+
+static inline void doorbell_close(doorbell_t *db)
+{
+    close(db->fd);
+}
+
+#elif defined(__MICROBLAZE__)
+
+// --- MicroBlaze: ring side ---
+
+typedef struct
+{
+    UINTPTR gpio;
+    uint32_t rings;
+} doorbell_t;
+
+static inline void doorbell_init(doorbell_t *db, UINTPTR gpioBase)
+{
+    db->gpio = gpioBase;
+    db->rings = 0;
+    Xil_Out32(gpioBase + DOORBELL_GPIO_TRI, 0);     // output
+    Xil_Out32(gpioBase + DOORBELL_GPIO_DATA, 0);
+}
+
+// Call after the data is published; mbar keeps the pulse behind the BRAM writes
+static inline void doorbell_ring(doorbell_t *db)
+{
+    __asm__ __volatile__ ("mbar 1" ::: "memory");
+    Xil_Out32(db->gpio + DOORBELL_GPIO_DATA, 1);
+    Xil_Out32(db->gpio + DOORBELL_GPIO_DATA, 0);
+    db->rings++;
+}
+
+#else
+
+// --- A53: wait side ---
+
+typedef struct
+{
+    XScuGic *gic;
+    uint32_t intId;
+    volatile uint32_t pending;  // interrupts since the last doorbell_wait()
+    volatile XTime stamp;       // when the first of them arrived
+    doorbell_stats_t stats;
+} doorbell_t;
+
+static void doorbell_isr(void *ref)
+{
+    doorbell_t *db = (doorbell_t *)ref;
+    XTime now;
+
+    XTime_GetTime(&now);
+    // Masked until doorbell_rearm(): further pulses stay pending at the GIC
+    XScuGic_Disable(db->gic, db->intId);
+    if (db->pending == 0)
+    {
+        db->stamp = now;
+    }
+    db->pending++;
+}
+
+// gic must already be initialised and hooked to the IRQ exception
+static inline int doorbell_attach(doorbell_t *db, XScuGic *gic, uint32_t intId)
+{
+    db->gic = gic;
+    db->intId = intId;
+    db->pending = 0;
+    db->stamp = 0;
+    doorbell_clearStats(&db->stats);
+
+    XScuGic_SetPriorityTriggerType(gic, intId, DOORBELL_PRIORITY, 0x3);     // rising edge
+    if (XScuGic_Connect(gic, intId, (Xil_InterruptHandler)doorbell_isr, db) != XST_SUCCESS)
+    {
+        return XST_FAILURE;
+    }
+    XScuGic_Enable(gic, intId);
+    return XST_SUCCESS;
+}
+
+// Sleep until rung; returns the number of interrupts taken
+static inline uint32_t doorbell_wait(doorbell_t *db)
+{
+    XTime now;
+    uint32_t rings;
+
+    // IRQs masked around the check so a ring between it and WFI still wakes us
+    Xil_ExceptionDisable();
+    while (db->pending == 0)
+    {
+        __asm__ __volatile__ ("wfi" ::: "memory");
+        Xil_ExceptionEnable();
+        Xil_ExceptionDisable();
+    }
+    XTime_GetTime(&now);
+    rings = db->pending;
+    db->pending = 0;
+    Xil_ExceptionEnable();
+
+    doorbell_record(&db->stats, rings, (uint64_t)(now - db->stamp) * 1000000000u / COUNTS_PER_SECOND);
+    return rings;
+}
+
+// Unmask the doorbell once everything published so far has been drained
+static inline void doorbell_rearm(doorbell_t *db)
+{
+    XScuGic_Enable(db->gic, db->intId);
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -5,17 +5,38 @@
 #include <sleep.h>
 #include "ADXL345.h"
 #include "xparameters.h"
+#include "bramRing.h"
+#include "packedSample.h"
+#include "doorbell.h"
 
-#define VECTOR_SIZE 6
 #define BRAM_BASE_ADDRESS XPAR_AXI_BRAM_0_BASEADDRESS
+#define DOORBELL_GPIO_ADDRESS XPAR_DOORBELL_GPIO_BASEADDR
+
+// Shared BRAM ring (8 KB): 16 slots of one header word + a message of
+// 48 packed samples (8 bytes each, see packedSample.h)
+#define MSG_RAW_SAMPLES 2
+#define BATCH_SAMPLES 48
+#define BATCH_WORDS PACKEDSAMPLE_MESSAGE_WORDS(BATCH_SAMPLES)
+#define RING_SLOTS 16
+#define RING_SLOT_WORDS (1 + BATCH_WORDS)
 
 
 // Launch the serial port in setup
 int main() {
 
-    int data_to_write[VECTOR_SIZE];
+    uint32_t batch[BATCH_WORDS];
+    uint32_t filled = 0;
+    uint16_t seq = 0;
+
+    bram_ring_t ring;
+    bramring_init(&ring, (volatile void *)BRAM_BASE_ADDRESS, RING_SLOTS, RING_SLOT_WORDS);
+
+    // Wakes the A53 (pl_ps_irq0) whenever a batch is queued
+    doorbell_t bell;
+    doorbell_init(&bell, DOORBELL_GPIO_ADDRESS);
 
-    Vector vetor;
+    // Scale for the A53's decoder (begin() selects full resolution)
+    batch[0] = ADXL345_MG_PER_LSB;
 
 	// initiallize i2c
 	AxiWire i2cDevice(0); // Initialize an AxiWire object for device 0
@@ -30,29 +51,19 @@ int main() {
 	// infinite loop
 	while(1){
 
-        vetor = mpu.readScaled();
-
-        int AccelX_int = (int)vetor.XAxis;
-        int AccelX_frac = abs((vetor.XAxis - (int)vetor.XAxis)*1000);
-        int AccelY_int = (int)vetor.YAxis;
-        int AccelY_frac = abs((vetor.YAxis - (int)vetor.YAxis)*1000);
-        int AccelZ_int = (int)vetor.ZAxis;
-        int AccelZ_frac = abs((vetor.ZAxis - (int)vetor.ZAxis)*1000);
-
-        data_to_write[0] = AccelX_int;
-        data_to_write[1] = AccelX_frac;
-
-        data_to_write[2] = AccelY_int;
-        data_to_write[3] = AccelY_frac;
+        // Raw counts only; conversion to g happens on the A53
+        Vectori raw = mpu.readRaw();
 
-        data_to_write[4] = AccelZ_int;
-        data_to_write[5] = AccelZ_frac;
-        
+        packedsample_pack(&batch[1 + PACKEDSAMPLE_WORDS * filled], (int16_t)raw.XAxis, (int16_t)raw.YAxis,
+                          (int16_t)raw.ZAxis, seq++);
 
-        // Write data to BRAM
-        for (int i = 0; i < VECTOR_SIZE; i++) {
-            u32 address = BRAM_BASE_ADDRESS + (i * 4); // Calculate address for each element
-            Xil_Out32(address, data_to_write[i]);
+        // Queue a full batch; if the A53 has fallen behind the batch is
+        // dropped (and counted) rather than overwriting unread data
+        if (++filled == BATCH_SAMPLES) {
+            if (bramring_push(&ring, MSG_RAW_SAMPLES, batch, BATCH_WORDS)) {
+                doorbell_ring(&bell);
+            }
+            filled = 0;
         }
 
 		// usleep(20000);
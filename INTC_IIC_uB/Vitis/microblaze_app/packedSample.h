@@ -0,0 +1,118 @@
+/*
+packedSample.h - Packed raw accelerometer samples for the shared BRAM ring.
+
+Each sample is the ADXL345's raw counts plus a wrapping sequence number,
+8 bytes as two little-endian 32-bit words:
+
+    word 0      [y:16 | x:16]
+    word 1      [seq:16 | z:16]
+
+so in memory it reads x, y, z, seq as four int16 values. A MSG_RAW_SAMPLES
+message is one word of mg per LSB (the sensor's scale) followed by the
+packed samples:
+
+    [mgPerLsb] [x0 y0] [z0 seq0] [x1 y1] [z1 seq1] ...
+
+The MicroBlaze only packs integers (packedsample_pack); conversion to g is
+done on the A53 by packedsample_decode(), which uses NEON when available
+(vld4 splits x, y, z and seq, eight samples per iteration) and plain C
+otherwise. Gaps in seq count the samples lost on the way.
+*/
+
+#ifndef PACKEDSAMPLE_h
+#define PACKEDSAMPLE_h
+
+#include <stdint.h>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PACKEDSAMPLE_WORDS              2
+#define PACKEDSAMPLE_MESSAGE_WORDS(n)   (1 + PACKEDSAMPLE_WORDS * (n))
+
+// Store one sample at dst (two words)
+static inline void packedsample_pack(uint32_t *dst, int16_t x, int16_t y, int16_t z, uint16_t seq)
+{
+    dst[0] = (uint32_t)(uint16_t)x | (uint32_t)(uint16_t)y << 16;
+    dst[1] = (uint32_t)(uint16_t)z | (uint32_t)seq << 16;
+}
+
+static inline uint16_t packedsample_seq(const uint32_t *src, uint32_t index)
+{
+    return (uint16_t)(src[PACKEDSAMPLE_WORDS * index + 1] >> 16);
+}
+
+/*
+Convert count packed samples to g, written to xyz as interleaved x, y, z
+floats (3 * count values). Returns the number of samples missing between
+expectedSeq and the last sample, and sets expectedSeq past it.
+*/
+static inline uint32_t packedsample_decode(const uint32_t *src, uint32_t count, float gPerLsb, float *xyz,
+                                           uint16_t *expectedSeq)
+{
+    uint32_t lost = 0;
+    uint16_t expected = *expectedSeq;
+    uint32_t i = 0;
+
+#if defined(__ARM_NEON)
+    for (; i + 8 <= count; i += 8)
+    {
+        int16x8x4_t v = vld4q_s16((const int16_t *)(src + PACKEDSAMPLE_WORDS * i));
+        float32x4x3_t lo, hi;
+
+        lo.val[0] = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v.val[0]))), gPerLsb);
+        lo.val[1] = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v.val[1]))), gPerLsb);
+        lo.val[2] = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v.val[2]))), gPerLsb);
+        hi.val[0] = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v.val[0]))), gPerLsb);
+        hi.val[1] = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v.val[1]))), gPerLsb);
+        hi.val[2] = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v.val[2]))), gPerLsb);
+        vst3q_f32(xyz + 3 * i, lo);
+        vst3q_f32(xyz + 3 * i + 12, hi);
+
+        // Sequence numbers are consecutive unless a batch went missing
+        uint16_t first = (uint16_t)vgetq_lane_s16(v.val[3], 0);
+        uint16_t last = (uint16_t)vgetq_lane_s16(v.val[3], 7);
+        if (first != expected || (uint16_t)(last - first) != 7)
+        {
+            for (uint32_t k = 0; k < 8; k++)
+            {
+                uint16_t seq = packedsample_seq(src, i + k);
+                lost += (uint16_t)(seq - expected);
+                expected = (uint16_t)(seq + 1);
+            }
+        }
+        else
+        {
+            expected = (uint16_t)(last + 1);
+        }
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        uint32_t w0 = src[PACKEDSAMPLE_WORDS * i];
+        uint32_t w1 = src[PACKEDSAMPLE_WORDS * i + 1];
+        uint16_t seq = (uint16_t)(w1 >> 16);
+
+        xyz[3 * i + 0] = (int16_t)(w0 & 0xFFFF) * gPerLsb;
+        xyz[3 * i + 1] = (int16_t)(w0 >> 16) * gPerLsb;
+        xyz[3 * i + 2] = (int16_t)(w1 & 0xFFFF) * gPerLsb;
+
+        lost += (uint16_t)(seq - expected);
+        expected = (uint16_t)(seq + 1);
+    }
+
+    *expectedSeq = expected;
+    return lost;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -4,28 +4,36 @@
  * This C file can be compiled on your local PC (not MicroBlaze) to verify
  * the FFT logic functionality before running it on hardware.
  *
- * To compile: gcc PC_FFT_Test.c -o fft_test -lm
+ * It runs the peak test with the real-input FFT from main.c (sw/fftPlan.c),
+ * checks the planned FFT against the original recursive fft() for
+ * N = 2..4096 and the real-input and two-channel paths against the complex
+ * plan for N = 4..4096, and benchmarks all of them (FFTs/second, one real
+ * channel per FFT for the real paths) for N = 128..4096.
+ *
+ * To compile: gcc -O2 -Isw PC_FFT_Test.c sw/fftPlan.c -o fft_test -lm
  * To run: ./fft_test
  */
 
 #include <stdio.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "fftPlan.h"
 
 #define SAMPLES_COUNT 128
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-// Structure format matching the embedded code
-typedef struct {
-    float real;
-    float imag;
-} complex_t;
+#define BENCH_MIN_SIZE 128
+#define BENCH_MAX_SIZE 4096
+#define BENCH_SECONDS  0.2
 
-complex_t signal[SAMPLES_COUNT];
+// Real samples in, bins 0..N/2 out, in the same buffer (as in main.c)
+complex_t signal[FFTPLAN_BINS(SAMPLES_COUNT)];
 
-// --- FFT Implementation (Copy from main.c) ---
+// --- Reference: the original recursive FFT (before sw/fftPlan.c) ---
 void fft(complex_t *X, int N) {
     if (N <= 1) return;
 
@@ -59,11 +67,172 @@ void fft(complex_t *X, int N) {
     }
 }
 
+// --- Plan vs Recursive ---
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void random_signal(complex_t *x, int n)
+{
+    for (int i = 0; i < n; i++) {
+        x[i].real = (float)rand() / RAND_MAX - 0.5f;
+        x[i].imag = (float)rand() / RAND_MAX - 0.5f;
+    }
+}
+
+// Largest |b - a| over `bins` bins relative to the largest bin of a
+static double max_error(const complex_t *a, const complex_t *b, int bins)
+{
+    double err = 0.0, peak = 0.0;
+
+    for (int i = 0; i < bins; i++) {
+        double dr = a[i].real - b[i].real, di = a[i].imag - b[i].imag;
+        double d = sqrt(dr * dr + di * di);
+        double m = sqrt((double)a[i].real * a[i].real + (double)a[i].imag * a[i].imag);
+        if (d > err) err = d;
+        if (m > peak) peak = m;
+    }
+    return err / peak;
+}
+
+// Planned FFT against the recursive one
+static double plan_error(const fftplan_t *plan, complex_t *a, complex_t *b)
+{
+    int n = plan->n;
+
+    random_signal(a, n);
+    memcpy(b, a, n * sizeof(complex_t));
+    fft(a, n);
+    fftplan_execute(plan, b);
+    return max_error(a, b, n);
+}
+
+// Real-input and two-channel paths against the complex plan with Imag = 0
+static double real_error(const fftplan_t *plan, const fftrplan_t *rplan, complex_t *a, complex_t *b)
+{
+    static float x[2][BENCH_MAX_SIZE];
+    static complex_t ref[2][BENCH_MAX_SIZE], bins[2][FFTPLAN_BINS(BENCH_MAX_SIZE)];
+    int n = plan->n;
+    double err = 0.0;
+
+    for (int c = 0; c < 2; c++) {
+        random_signal(a, n);
+        for (int i = 0; i < n; i++) {
+            x[c][i] = a[i].real;
+            ref[c][i].real = a[i].real;
+            ref[c][i].imag = 0.0f;
+        }
+        fftplan_execute(plan, ref[c]);
+
+        fftrplan_execute(rplan, x[c], b);
+        err = fmax(err, max_error(ref[c], b, FFTPLAN_BINS(n)));
+    }
+
+    fftplan_executeTwoReal(plan, x[0], x[1], a, bins[0], bins[1]);
+    err = fmax(err, max_error(ref[0], bins[0], FFTPLAN_BINS(n)));
+    err = fmax(err, max_error(ref[1], bins[1], FFTPLAN_BINS(n)));
+    return err;
+}
+
+#define BENCH_RECURSIVE 0
+#define BENCH_PLAN      1
+#define BENCH_REAL      2
+#define BENCH_TWO_REAL  3
+
+// FFTs per second over BENCH_SECONDS; every kind pays the same copy of the
+// input. Real paths count one FFT per real channel transformed.
+static double bench(int kind, const fftplan_t *plan, const fftrplan_t *rplan,
+                    const complex_t *src, complex_t *x, int n)
+{
+    static float in[2][BENCH_MAX_SIZE];
+    static complex_t out[FFTPLAN_BINS(BENCH_MAX_SIZE)];
+    long runs = 0;
+    double t0 = now_s(), t;
+
+    do {
+        for (int r = 0; r < 16; r++) {
+            switch (kind) {
+            case BENCH_RECURSIVE:
+                memcpy(x, src, n * sizeof(complex_t));
+                fft(x, n);
+                break;
+            case BENCH_PLAN:
+                memcpy(x, src, n * sizeof(complex_t));
+                fftplan_execute(plan, x);
+                break;
+            case BENCH_REAL:
+                memcpy(in[0], src, n * sizeof(float));
+                fftrplan_execute(rplan, in[0], x);
+                break;
+            default:
+                memcpy(in[0], src, n * sizeof(float));
+                memcpy(in[1], (const float *)src + n, n * sizeof(float));
+                fftplan_executeTwoReal(plan, in[0], in[1], x, x, out);
+                break;
+            }
+        }
+        runs += 16;
+        t = now_s() - t0;
+    } while (t < BENCH_SECONDS);
+    return (kind == BENCH_TWO_REAL ? 2 * runs : runs) / t;
+}
+
+static int compare_plans(void)
+{
+    static complex_t a[BENCH_MAX_SIZE], b[BENCH_MAX_SIZE];
+    static complex_t twiddle[FFTPLAN_TWIDDLES(BENCH_MAX_SIZE)];
+    static complex_t rtwiddle[FFTPLAN_TWIDDLES(BENCH_MAX_SIZE / 2)], split[FFTPLAN_SPLIT(BENCH_MAX_SIZE)];
+    static uint16_t bitrev[BENCH_MAX_SIZE], rbitrev[BENCH_MAX_SIZE / 2];
+    fftplan_t plan;
+    fftrplan_t rplan;
+    int pass = 1;
+
+    printf("Max error relative to the largest bin\n");
+    printf("  N     plan vs recursive   real / 2 real vs plan\n");
+    for (int n = 2; n <= BENCH_MAX_SIZE; n *= 2) {
+        fftplan_init(&plan, n, twiddle, bitrev);
+        double err = plan_error(&plan, a, b);
+        double rerr = 0.0;
+        if (n >= 4) {
+            fftrplan_init(&rplan, n, rtwiddle, rbitrev, split);
+            rerr = real_error(&plan, &rplan, a, b);
+        }
+        printf("  %-5d %17.1e %23.1e%s\n", n, err, rerr, err < 1e-5 && rerr < 1e-5 ? "" : "  <-- too large");
+        pass &= err < 1e-5 && rerr < 1e-5;
+    }
+
+    printf("\nFFTs/second (real paths: real channels transformed per second)\n");
+    printf("  N       recursive      plan      real    2 real   real vs recursive\n");
+    for (int n = BENCH_MIN_SIZE; n <= BENCH_MAX_SIZE; n *= 2) {
+        fftplan_init(&plan, n, twiddle, bitrev);
+        fftrplan_init(&rplan, n, rtwiddle, rbitrev, split);
+        random_signal(a, n);
+        double rec = bench(BENCH_RECURSIVE, &plan, &rplan, a, b, n);
+        double pl = bench(BENCH_PLAN, &plan, &rplan, a, b, n);
+        double re = bench(BENCH_REAL, &plan, &rplan, a, b, n);
+        double two = bench(BENCH_TWO_REAL, &plan, &rplan, a, b, n);
+        printf("  %-5d %11.0f %9.0f %9.0f %9.0f %18.1fx\n", n, rec, pl, re, two, re / rec);
+    }
+    printf("\n");
+    return pass;
+}
+
 // --- Main Test Bench ---
 int main() {
+    static complex_t twiddle[FFTPLAN_TWIDDLES(SAMPLES_COUNT / 2)], split[FFTPLAN_SPLIT(SAMPLES_COUNT)];
+    static uint16_t bitrev[SAMPLES_COUNT / 2];
+    fftrplan_t plan;
+    float *samples = (float *)signal;
+
     printf("Verify FFT Logic (PC-based Test)\n");
     printf("--------------------------------\n");
 
+    int plans_ok = compare_plans();
+    fftrplan_init(&plan, SAMPLES_COUNT, twiddle, bitrev, split);
+
     // 1. Generate Input Signal: 10Hz sine wave + 30Hz sine wave
     // Sampling rate assumed arbitrary, e.g., 128Hz for simplicity (N=128)
     // So 10Hz = index 10, 30Hz = index 30.
@@ -71,12 +240,11 @@ int main() {
     printf("Generating Signal: 10Hz (Amp 1.0) + 30Hz (Amp 0.5)...\n");
     for (int i = 0; i < SAMPLES_COUNT; i++) {
         float t = (float)i / SAMPLES_COUNT; // Time 0 to 1 sec
-        signal[i].real = 1.0f * sin(2 * M_PI * 10 * t) + 0.5f * sin(2 * M_PI * 30 * t);
-        signal[i].imag = 0.0f;
+        samples[i] = 1.0f * sin(2 * M_PI * 10 * t) + 0.5f * sin(2 * M_PI * 30 * t);
     }
 
-    // 2. Run FFT
-    fft(signal, SAMPLES_COUNT);
+    // 2. Run FFT (real input: bins 0..N/2)
+    fftrplan_execute(&plan, samples, signal);
 
     // 3. Print Output
     printf("FFT Results (Magnitudes > 1.0):\n");
@@ -93,11 +261,11 @@ int main() {
         }
     }
     
-    if(peaks_found >= 2) {
+    if(peaks_found >= 2 && plans_ok) {
         printf("\nSUCCESS: Peaks detected (likely at index 10 and 30)\n");
     } else {
         printf("\nFAILURE: Peaks not clearly detected.\n");
     }
 
-    return 0;
+    return (peaks_found >= 2 && plans_ok) ? 0 : 1;
 }
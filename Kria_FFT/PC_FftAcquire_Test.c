@@ -0,0 +1,123 @@
+/*
+ * Host Test for the ADXL345 FIFO Acquisition
+ * ==========================================
+ * Runs sw/fftAcquire.c on your local PC against sw/fftAcquireSim.h
+ * (FFTACQ_HOST): an ADXL345 FIFO model on an I2C bus whose clock advances
+ * by the bit times of every transfer, so bus time and sensor time relate
+ * as on the board. Each pass of the loop stands for one main_mb.c pass
+ * (DMA service + log drain, PASS_NS of CPU time) plus one fftacq_fill().
+ *
+ * For several bus speeds, output data rates and axes it fills FRAMES
+ * frames and checks:
+ *   - every word is [31:16] Imag = 0 | [15:0] Real = the selected axis
+ *   - samples are consecutive unless the sensor really dropped some, and
+ *     every drop shows up in the overrun counter
+ *   - rates the bus can carry are sustained without drops
+ * and prints the sustained sample rate and bus utilisation.
+ *
+ * To compile: gcc -O2 -DFFTACQ_HOST -Isw PC_FftAcquire_Test.c sw/fftAcquire.c -o fftacquire_test
+ * To run: ./fftacquire_test
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include "frameBuffers.h"
+#include "fftAcquire.h"
+
+#define FRAMES          8
+#define PASS_NS         20000
+
+typedef struct
+{
+    uint32_t busHz;
+    uint8_t dataRate;
+    int axis;
+    int expectDrops;
+} acq_case_t;
+
+static const acq_case_t cases[] = {
+    { 400000, FFTACQ_DATARATE_3200HZ, FFTACQ_AXIS_X, 0 },
+    { 400000, FFTACQ_DATARATE_1600HZ, FFTACQ_AXIS_Y, 0 },
+    { 400000, FFTACQ_DATARATE_800HZ,  FFTACQ_AXIS_Z, 0 },
+    { 100000, FFTACQ_DATARATE_800HZ,  FFTACQ_AXIS_X, 0 },
+    { 100000, FFTACQ_DATARATE_1600HZ, FFTACQ_AXIS_X, 1 },     // more than 100 kHz can carry
+};
+
+// Sample number (mod 4096) back from the ramp value of each axis
+static uint32_t ramp_index(int axis, int16_t v)
+{
+    switch (axis) {
+    case FFTACQ_AXIS_X: return (uint32_t)v & 0x0FFF;
+    case FFTACQ_AXIS_Y: return (uint32_t)(-v) & 0x0FFF;
+    default:            return (uint32_t)(v - 1000) & 0x0FFF;
+    }
+}
+
+static int run_case(const acq_case_t *c)
+{
+    static uint32_t frame[FFT_SIZE];
+    fftacqsim_t sim;
+    fftacq_t acq;
+    uint32_t badWords = 0, gaps = 0, lost = 0, prev = 0;
+    int first = 1;
+
+    fftacqsim_init(&sim, c->busHz);
+    if (fftacq_init(&acq, (UINTPTR)&sim, c->busHz, c->axis, c->dataRate) != XST_SUCCESS) {
+        printf("init failed\n");
+        return 0;
+    }
+    uint64_t t0 = sim.nowNs;
+
+    for (int f = 0; f < FRAMES; f++) {
+        int n = 0;
+        while (n < FFT_SIZE) {
+            fftacqsim_idle(&sim, PASS_NS);
+            n += fftacq_fill(&acq, frame + n, FFT_SIZE - n);
+        }
+
+        for (int i = 0; i < FFT_SIZE; i++) {
+            if ((frame[i] >> 16) != 0) {
+                badWords++;
+                continue;
+            }
+            uint32_t index = ramp_index(c->axis, (int16_t)(frame[i] & 0xFFFF));
+            uint32_t step = (index - prev) & 0x0FFF;
+            if (!first && step != 1) {
+                gaps++;
+                lost += (step - 1) & 0x0FFF;
+            }
+            prev = index;
+            first = 0;
+        }
+    }
+
+    double seconds = (sim.nowNs - t0) * 1e-9;
+    double odr = fftacq_odrMilliHz(c->dataRate) / 1000.0;
+    uint32_t bus = fftacq_busPermille(&acq, acq.dataBits + acq.pollBits, acq.samples);
+    uint32_t busData = fftacq_busPermille(&acq, acq.dataBits, acq.samples);
+
+    printf("%3u kHz bus, ODR %4.0f Hz, axis %c: %5.0f samples/s sustained, %llu dropped "
+           "(%u overruns), bus %u.%u%% busy (%u.%u%% samples)\n",
+           c->busHz / 1000, odr, "XYZ"[c->axis], acq.samples / seconds,
+           (unsigned long long)sim.dropped, acq.overruns, bus / 10, bus % 10, busData / 10, busData % 10);
+
+    int pass = badWords == 0 && lost == sim.dropped && (sim.dropped == 0 || acq.overruns > 0) &&
+               (c->expectDrops ? sim.dropped > 0 : sim.dropped == 0);
+    if (!pass) {
+        printf("  %u bad words, %u gaps (%u samples) in the frames, %llu dropped by the sensor\n",
+               badWords, gaps, lost, (unsigned long long)sim.dropped);
+    }
+    return pass;
+}
+
+int main(void)
+{
+    int pass = 1;
+
+    printf("%d frames of %d samples per case\n", FRAMES, FFT_SIZE);
+    for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        pass &= run_case(&cases[i]);
+    }
+    printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
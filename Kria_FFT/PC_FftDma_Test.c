@@ -0,0 +1,219 @@
+/*
+ * Host Test for the Interrupt-Driven FFT DMA
+ * ==========================================
+ * Runs sw/fftDma.c on your local PC against sw/fftDmaSim.h (FFTDMA_HOST),
+ * a model of the AXI DMA + xfft that completes each transfer from its own
+ * thread after the modelled transform time and calls the MM2S / S2MM
+ * handlers the way the AXI INTC would.
+ *
+ * Three runs over FRAME_BUFFERS slots of a malloc'd "BRAM":
+ *   polled    - start, wait for completion, then acquire the next frame
+ *               (what main_mb.c did with XAxiDma_Busy)
+ *   interrupt - the main_mb.c event loop: acquire frame k + 1 while the
+ *               DMA works on frame k, fftdma_service() retires it
+ *   recovery  - an injected DMA error and an injected hang: the callback
+ *               must see FFTDMA_ERROR / FFTDMA_TIMEOUT, the core must be
+ *               reset, and the next frame must go through
+ *   stuck     - a hang whose reset never completes: the callback still
+ *               sees FFTDMA_TIMEOUT, fftdma_failed() is set and the next
+ *               frame is refused
+ * Every completed frame is checked (the model copies RX to TX).
+ *
+ * To compile: gcc -O2 -DFFTDMA_HOST -Isw PC_FftDma_Test.c sw/fftDma.c -o fftdma_test -lpthread
+ * To run: ./fftdma_test
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "frameBuffers.h"
+#include "fftDma.h"
+
+#define FRAMES          2000
+#define ACQUIRE_US      25          // modelled I2C acquisition time per frame
+#define TIMEOUT_US      20000
+
+static uint32_t *rx;
+static uint32_t *tx;
+static fftdma_t fft;
+
+static uint32_t framesOk;
+static uint32_t framesBad;
+static int lastStatus;
+
+static uint32_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000u + ts.tv_nsec / 1000);
+}
+
+static void spin_us(uint32_t us)
+{
+    uint32_t start = now_us();
+    while (now_us() - start < us) {
+    }
+}
+
+static void acquire(int k, uint32_t frameNumber)
+{
+    uint32_t *frame = rx + k * FFT_SIZE;
+    for (int i = 0; i < FFT_SIZE; i++) {
+        frame[i] = (frameNumber << 16) | (uint32_t)i;
+    }
+    spin_us(ACQUIRE_US);
+}
+
+static void frame_done(void *ref, int slot, int status)
+{
+    (void)ref;
+    lastStatus = status;
+    if (status != FFTDMA_OK) {
+        return;
+    }
+    if (memcmp(tx + slot * FFT_SIZE, rx + slot * FFT_SIZE, FRAME_BYTES) == 0) {
+        framesOk++;
+    } else {
+        framesBad++;
+    }
+}
+
+static int start(int k)
+{
+    return fftdma_start(&fft, k, (UINTPTR)(rx + k * FFT_SIZE), (UINTPTR)(tx + k * FFT_SIZE),
+                        FRAME_BYTES, now_us());
+}
+
+static double run_polled(void)
+{
+    uint32_t t0 = now_us();
+
+    for (uint32_t n = 0; n < FRAMES; n++) {
+        int k = n % FRAME_BUFFERS;
+        acquire(k, n);
+        start(k);
+        while (!fftdma_service(&fft, now_us())) {
+        }
+    }
+    return (now_us() - t0) / 1e6;
+}
+
+static double run_interrupt(uint32_t *overlapped)
+{
+    uint32_t t0 = now_us();
+    uint32_t acquired = 0, started = 0;
+    int filled = 0;
+
+    *overlapped = 0;
+    while (framesOk + framesBad < FRAMES) {
+        fftdma_service(&fft, now_us());
+
+        if (!filled && acquired < FRAMES) {
+            if (fftdma_busy(&fft)) {
+                (*overlapped)++;
+            }
+            acquire(acquired % FRAME_BUFFERS, acquired);
+            acquired++;
+            filled = 1;
+        }
+        if (filled && !fftdma_busy(&fft)) {
+            if (start(started % FRAME_BUFFERS) == XST_SUCCESS) {
+                started++;
+                filled = 0;
+            }
+        }
+    }
+    return (now_us() - t0) / 1e6;
+}
+
+static int run_fault(int fault, int expected, uint32_t resets)
+{
+    int ok = 1;
+
+    fftdmasim_inject(&fft.dma, fault);
+    acquire(0, 0xAAAA);
+    start(0);
+    while (!fftdma_service(&fft, now_us())) {
+    }
+    if (lastStatus != expected || fft.resets != resets) {
+        printf("  fault %d: status %d (expected %d), resets %u (expected %u)\n",
+               fault, lastStatus, expected, fft.resets, resets);
+        ok = 0;
+    }
+
+    // The next frame must go through after the reset
+    uint32_t before = framesOk;
+    acquire(1, 0x5555);
+    start(1);
+    while (!fftdma_service(&fft, now_us())) {
+    }
+    if (lastStatus != FFTDMA_OK || framesOk != before + 1) {
+        printf("  fault %d: frame after reset failed (status %d)\n", fault, lastStatus);
+        ok = 0;
+    }
+    return ok;
+}
+
+// Hang with a core that never leaves reset: the driver must give up
+static int run_stuck(uint32_t resets)
+{
+    fftdmasim_inject(&fft.dma, FFTDMASIM_HANG);
+    fftdmasim_inject(&fft.dma, FFTDMASIM_STUCK_RESET);
+    acquire(0, 0xDEAD);
+    start(0);
+    while (!fftdma_service(&fft, now_us())) {
+    }
+
+    int refused = start(1) != XST_SUCCESS;
+    printf("stuck:     status %d, failed %d, resets %u, next frame %s\n",
+           lastStatus, fftdma_failed(&fft), fft.resets, refused ? "refused" : "ACCEPTED");
+    return lastStatus == FFTDMA_TIMEOUT && fftdma_failed(&fft) && fft.resets == resets && refused &&
+           !fftdma_busy(&fft);
+}
+
+int main(void)
+{
+    int pass = 1;
+    uint32_t overlapped;
+
+    rx = malloc(FRAME_BUFFERS * FRAME_BYTES);
+    tx = malloc(FRAME_BUFFERS * FRAME_BYTES);
+    if (rx == NULL || tx == NULL ||
+        fftdma_init(&fft, 0, frame_done, NULL, TIMEOUT_US) != XST_SUCCESS) {
+        printf("init failed\n");
+        return 1;
+    }
+    fftdmasim_connect(&fft.dma, XAXIDMA_DMA_TO_DEVICE, fftdma_mm2sIsr, &fft);
+    fftdmasim_connect(&fft.dma, XAXIDMA_DEVICE_TO_DMA, fftdma_s2mmIsr, &fft);
+
+    printf("%d frames of %d bytes, acquisition %d us, modelled transform %u ns\n",
+           FRAMES, FRAME_BYTES, ACQUIRE_US, (FRAME_BYTES / 4) * fft.dma.nsPerWord);
+
+    double polled = run_polled();
+    printf("polled:    %.0f frames/s\n", FRAMES / polled);
+    pass &= (framesOk == FRAMES && framesBad == 0);
+
+    framesOk = framesBad = 0;
+    double irq = run_interrupt(&overlapped);
+    printf("interrupt: %.0f frames/s, %u of %d acquisitions overlapped a transform\n",
+           FRAMES / irq, overlapped, FRAMES);
+    pass &= (framesOk == FRAMES && framesBad == 0);
+
+    pass &= run_fault(FFTDMASIM_ERROR, FFTDMA_ERROR, 1);
+    pass &= run_fault(FFTDMASIM_HANG, FFTDMA_TIMEOUT, 2);
+    printf("recovery:  %u errors, %u timeouts, %u resets\n", fft.errors, fft.timeouts, fft.resets);
+    pass &= !fftdma_failed(&fft);
+    pass &= run_stuck(2);
+
+    if (framesBad != 0) {
+        printf("%u frames corrupted\n", framesBad);
+    }
+    printf("%s\n", pass ? "PASS" : "FAIL");
+
+    fftdmasim_shutdown(&fft.dma);
+    free(rx);
+    free(tx);
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,343 @@
+/*
+ * Host Test for the Fixed-Point FFT
+ * =================================
+ * Runs sw/fftFixed.c on your local PC for the xfft_0 configuration
+ * (FFT_SIZE points, 16-bit input and phase factors) and checks:
+ *   - unscaled + truncation against a double-precision DFT: error and
+ *     SQNR, and that full-scale frames fit the 27-bit output word
+ *   - scaled with the conservative schedule: never overflows, and equals
+ *     the unscaled result shifted down (within the extra truncation);
+ *     an unscaled schedule on full-scale data does raise OVFLO
+ *   - block floating point: the block exponent brings the frame back into
+ *     16 bits and output * 2^exp matches the unscaled result
+ *   - convergent rounding has less error than truncation (whose -1/2 LSB
+ *     offsets pile up in the bins the later stages map them onto)
+ *   - the TDATA packing (27-bit fields sign-extended to 32)
+ * and benchmarks FFTs/second against the float plan (sw/fftPlan.c).
+ *
+ * With a file argument it also compares against golden vectors, e.g. from
+ * the board or from the Xilinx bit-accurate C model: one line per sample,
+ * "<input TDATA hex> <output TDATA hex>" (further columns and lines that
+ * do not start with two hex numbers are ignored, so PC_FftPipeline_Model
+ * vectors work as they are), FFT_SIZE lines per frame, the core configured
+ * as in build_complete_system.tcl.
+ *
+ * To compile: gcc -O2 -Isw PC_FftFixed_Test.c sw/fftFixed.c sw/fftPlan.c -o fftfixed_test -lm
+ * To run: ./fftfixed_test [vectors.txt]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "frameBuffers.h"
+#include "fftFixed.h"
+#include "fftPlan.h"
+
+#define N               FFT_SIZE
+#define RANDOM_FRAMES   20
+#define BENCH_SECONDS   0.3
+
+static fftfix_complex_t twiddle[FFTFIX_TWIDDLES(N)];
+static uint16_t bitrev[N];
+static fftfix_plan_t plan;
+static fftfix_plan_t planRound;
+static fftfix_complex_t twiddleRound[FFTFIX_TWIDDLES(N)];
+static uint16_t bitrevRound[N];
+
+static double cosTable[N], sinTable[N];
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void random_frame(fftfix_complex_t *x, int amplitude)
+{
+    for (int i = 0; i < N; i++) {
+        x[i].real = rand() % (2 * amplitude) - amplitude;
+        x[i].imag = rand() % (2 * amplitude) - amplitude;
+    }
+}
+
+static void dft(const fftfix_complex_t *x, double *re, double *im)
+{
+    for (int k = 0; k < N; k++) {
+        double r = 0.0, i = 0.0;
+        for (int j = 0; j < N; j++) {
+            int a = (int)(((long)j * k) % N);
+            r += x[j].real * cosTable[a] + x[j].imag * sinTable[a];
+            i += x[j].imag * cosTable[a] - x[j].real * sinTable[a];
+        }
+        re[k] = r;
+        im[k] = i;
+    }
+}
+
+static int fits(int32_t v, int width)
+{
+    return v >= -(1 << (width - 1)) && v < (1 << (width - 1));
+}
+
+static int test_unscaled(void)
+{
+    static fftfix_complex_t x[N], in[N];
+    static double re[N], im[N];
+    double maxErr = 0.0, noise = 0.0, signal = 0.0, bias = 0.0;
+    int width = fftfix_outputWidth(&plan, FFTFIX_UNSCALED);
+    int pass = 1;
+
+    for (int f = 0; f < RANDOM_FRAMES; f++) {
+        random_frame(in, 32768);
+        memcpy(x, in, sizeof(x));
+        fftfix_execute(&plan, x, FFTFIX_UNSCALED, 0, NULL);
+        dft(in, re, im);
+        for (int k = 0; k < N; k++) {
+            double er = x[k].real - re[k], ei = x[k].imag - im[k];
+            maxErr = fmax(maxErr, fmax(fabs(er), fabs(ei)));
+            noise += er * er + ei * ei;
+            signal += re[k] * re[k] + im[k] * im[k];
+            bias += er + ei;
+            pass &= fits(x[k].real, width) && fits(x[k].imag, width);
+        }
+    }
+
+    // Extremes: DC at both full-scale ends must still fit the output word
+    int32_t corner[2] = {32767, -32768};
+    for (int c = 0; c < 2; c++) {
+        for (int i = 0; i < N; i++) {
+            x[i].real = x[i].imag = corner[c];
+        }
+        fftfix_execute(&plan, x, FFTFIX_UNSCALED, 0, NULL);
+        pass &= x[0].real == (int32_t)N * corner[c] && x[0].imag == (int32_t)N * corner[c];
+        pass &= fits(x[0].real, width);
+    }
+
+    double sqnr = 10.0 * log10(signal / noise);
+    printf("unscaled:  %d-bit output, max error %.1f LSB, SQNR %.1f dB, mean error %+.2f LSB\n",
+           width, maxErr, sqnr, bias / (2.0 * N * RANDOM_FRAMES));
+    pass &= width == 27 && sqnr > 90.0;
+    return pass;
+}
+
+static int test_scaled(void)
+{
+    static fftfix_complex_t x[N], ref[N];
+    uint32_t schedule = fftfix_conservativeSchedule(&plan);
+    int total = 0, overflows = 0;
+    double maxErr = 0.0;
+
+    for (int g = 0; g < fftfix_stages(&plan); g++) {
+        total += (schedule >> (2 * g)) & 3;
+    }
+
+    for (int f = 0; f < RANDOM_FRAMES + 2; f++) {
+        if (f < RANDOM_FRAMES) {
+            random_frame(x, 32768);
+        } else {
+            for (int i = 0; i < N; i++) {
+                x[i].real = x[i].imag = f == RANDOM_FRAMES ? 32767 : -32768;
+            }
+        }
+        memcpy(ref, x, sizeof(x));
+        overflows += fftfix_execute(&plan, x, FFTFIX_SCALED, schedule, NULL);
+        fftfix_execute(&plan, ref, FFTFIX_UNSCALED, 0, NULL);
+        for (int k = 0; k < N; k++) {
+            maxErr = fmax(maxErr, fabs(x[k].real - ref[k].real / (double)(1 << total)));
+            maxErr = fmax(maxErr, fabs(x[k].imag - ref[k].imag / (double)(1 << total)));
+        }
+    }
+
+    // No scaling at all on full-scale data must wrap and say so
+    random_frame(x, 32768);
+    int wrapped = fftfix_execute(&plan, x, FFTFIX_SCALED, 0, NULL);
+
+    printf("scaled:    schedule 0x%03X (%d bits), %d overflows, max error vs unscaled >> %d: %.1f LSB; "
+           "schedule 0 overflow %s\n",
+           schedule, total, overflows, total, maxErr, wrapped ? "flagged" : "NOT flagged");
+    return total == plan.log2n + 1 && overflows == 0 && maxErr < 2 * plan.log2n && wrapped;
+}
+
+static int test_bfp(void)
+{
+    static fftfix_complex_t x[N], ref[N];
+    int amplitudes[3] = {32768, 1000, 8};
+    int pass = 1;
+
+    printf("bfp:      ");
+    for (int a = 0; a < 3; a++) {
+        int exponent = 0;
+        double maxErr = 0.0;
+
+        random_frame(x, amplitudes[a]);
+        memcpy(ref, x, sizeof(x));
+        int overflow = fftfix_execute(&plan, x, FFTFIX_BFP, 0, &exponent);
+        fftfix_execute(&plan, ref, FFTFIX_UNSCALED, 0, NULL);
+        for (int k = 0; k < N; k++) {
+            pass &= fits(x[k].real, FFTFIX_INPUT_WIDTH) && fits(x[k].imag, FFTFIX_INPUT_WIDTH);
+            maxErr = fmax(maxErr, fabs(x[k].real * (double)(1 << exponent) - ref[k].real) / (1 << exponent));
+            maxErr = fmax(maxErr, fabs(x[k].imag * (double)(1 << exponent) - ref[k].imag) / (1 << exponent));
+        }
+        printf(" amplitude %5d: exponent %2d, max error %.1f LSB;", amplitudes[a], exponent, maxErr);
+        pass &= !overflow && maxErr < 2 * plan.log2n;
+    }
+    printf("\n");
+    return pass;
+}
+
+static int test_rounding(void)
+{
+    static fftfix_complex_t t[N], c[N], in[N];
+    static double re[N], im[N];
+    double noiseT = 0.0, noiseC = 0.0;
+
+    for (int f = 0; f < RANDOM_FRAMES / 4; f++) {
+        random_frame(in, 32768);
+        memcpy(t, in, sizeof(t));
+        memcpy(c, in, sizeof(c));
+        fftfix_execute(&plan, t, FFTFIX_UNSCALED, 0, NULL);
+        fftfix_execute(&planRound, c, FFTFIX_UNSCALED, 0, NULL);
+        dft(in, re, im);
+        for (int k = 0; k < N; k++) {
+            double tr = t[k].real - re[k], ti = t[k].imag - im[k];
+            double cr = c[k].real - re[k], ci = c[k].imag - im[k];
+            noiseT += tr * tr + ti * ti;
+            noiseC += cr * cr + ci * ci;
+        }
+    }
+    double rmsT = sqrt(noiseT / (2.0 * N * (RANDOM_FRAMES / 4)));
+    double rmsC = sqrt(noiseC / (2.0 * N * (RANDOM_FRAMES / 4)));
+    printf("rounding:  rms error truncation %.1f LSB, convergent %.1f LSB\n", rmsT, rmsC);
+    return rmsC < rmsT;
+}
+
+static int test_packing(void)
+{
+    fftfix_complex_t v = { -5, 67108863 };     // -5, 2^26 - 1
+    uint64_t word = fftfix_packOutput(v, 27);
+    fftfix_complex_t in = { -32768, 32767 };
+    uint32_t inWord = fftfix_packInput(in);
+    fftfix_complex_t back = fftfix_unpackInput(inWord);
+
+    int pass = word == 0x03FFFFFFFFFFFFFBull && fftfix_packOutput(v, 16) == 0xFFFFFFFBull &&
+               inWord == 0x7FFF8000u && back.real == -32768 && back.imag == 32767;
+    printf("packing:   27-bit (-5, 2^26-1) -> 0x%016llX, input (-32768, 32767) -> 0x%08X: %s\n",
+           (unsigned long long)word, inWord, pass ? "ok" : "wrong");
+    return pass;
+}
+
+static void benchmark(void)
+{
+    static fftfix_complex_t src[N], x[N];
+    static complex_t fsrc[N], fx[N];
+    static complex_t ftw[FFTPLAN_TWIDDLES(N)];
+    static uint16_t fbr[N];
+    fftplan_t fplan;
+    long runs;
+    double t0, t;
+
+    fftplan_init(&fplan, N, ftw, fbr);
+    random_frame(src, 32768);
+    for (int i = 0; i < N; i++) {
+        fsrc[i].real = (float)src[i].real;
+        fsrc[i].imag = (float)src[i].imag;
+    }
+
+    runs = 0;
+    t0 = now_s();
+    do {
+        memcpy(x, src, sizeof(x));
+        fftfix_execute(&plan, x, FFTFIX_UNSCALED, 0, NULL);
+        runs++;
+    } while ((t = now_s() - t0) < BENCH_SECONDS);
+    double fixedRate = runs / t;
+
+    runs = 0;
+    t0 = now_s();
+    do {
+        memcpy(fx, fsrc, sizeof(fx));
+        fftplan_execute(&fplan, fx);
+        runs++;
+    } while ((t = now_s() - t0) < BENCH_SECONDS);
+
+    printf("speed:     %d-point fixed %.0f FFTs/s, float plan %.0f FFTs/s on this host (FPU);\n"
+           "           on the FPU-less MicroBlaze the float plan runs in soft-float\n",
+           N, fixedRate, runs / t);
+}
+
+// Golden vectors: "<in hex> <out hex>" per line, N lines per frame
+static int compare_vectors(const char *path)
+{
+    static fftfix_complex_t x[N];
+    static uint64_t expected[N];
+    FILE *fp = fopen(path, "r");
+    unsigned long long in, out;
+    char line[256];
+    int frames = 0, mismatches = 0, n = 0;
+
+    if (fp == NULL) {
+        printf("vectors:   cannot open %s\n", path);
+        return 0;
+    }
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (sscanf(line, "%llx %llx", &in, &out) != 2) {
+            continue;   // comments, blank lines
+        }
+        x[n] = fftfix_unpackInput((uint32_t)in);
+        expected[n] = out;
+        if (++n < N) {
+            continue;
+        }
+        fftfix_execute(&plan, x, FFTFIX_UNSCALED, 0, NULL);
+        for (int k = 0; k < N; k++) {
+            uint64_t got = fftfix_packOutput(x[k], fftfix_outputWidth(&plan, FFTFIX_UNSCALED));
+            if (got != expected[k]) {
+                if (mismatches < 5) {
+                    printf("  frame %d bin %d: expected 0x%016llX, got 0x%016llX\n",
+                           frames, k, (unsigned long long)expected[k], (unsigned long long)got);
+                }
+                mismatches++;
+            }
+        }
+        frames++;
+        n = 0;
+    }
+    fclose(fp);
+
+    printf("vectors:   %d frames from %s, %d bins differ\n", frames, path, mismatches);
+    return frames > 0 && mismatches == 0;
+}
+
+int main(int argc, char **argv)
+{
+    int pass = 1;
+
+    for (int a = 0; a < N; a++) {
+        cosTable[a] = cos(2.0 * M_PI * a / N);
+        sinTable[a] = sin(2.0 * M_PI * a / N);
+    }
+    if (fftfix_init(&plan, N, twiddle, bitrev, FFTFIX_TRUNCATE) != 0 ||
+        fftfix_init(&planRound, N, twiddleRound, bitrevRound, FFTFIX_CONVERGENT) != 0) {
+        printf("init failed\n");
+        return 1;
+    }
+
+    printf("%d-point, %d-bit input, %d-bit phase factors, %d frames per check\n",
+           N, FFTFIX_INPUT_WIDTH, FFTFIX_PHASE_WIDTH, RANDOM_FRAMES);
+    pass &= test_unscaled();
+    pass &= test_scaled();
+    pass &= test_bfp();
+    pass &= test_rounding();
+    pass &= test_packing();
+    if (argc > 1) {
+        pass &= compare_vectors(argv[1]);
+    }
+    benchmark();
+
+    printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
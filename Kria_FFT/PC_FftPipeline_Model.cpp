@@ -0,0 +1,267 @@
+/*
+ * Host Model of the FFT Data Path
+ * ===============================
+ * Drives sw/fftPipelineModel.hpp, the bit-accurate / cycle-approximate
+ * model of MM2S -> xfft_0 -> power_calc_0 (mag_squared.v) -> S2MM, on your
+ * local PC. It checks:
+ *   - mag_squared: signed squares and the 32-bit wraparound
+ *   - the streaming API (random push / pop chunk sizes) gives the same
+ *     words and TLAST framing as whole-frame processing
+ *   - TLAST on the wrong beat is counted as event_tlast_unexpected /
+ *     event_tlast_missing and does not change the framing
+ *   - a scaled core configuration puts a test tone at the right bin with
+ *     the right power
+ * then reports what the as-built (unscaled, 64-bit TDATA into the 32-bit
+ * power_calc input) design delivers for the same tone, how many frames per
+ * second the model runs on this host, and the estimated frame rate at
+ * 100 MHz for simple and scatter-gather DMA.
+ *
+ * With a file argument it writes golden vectors for the as-built design,
+ * one line per beat: "<input TDATA> <xfft TDATA> <power TDATA> <TLAST>"
+ * (hex). PC_FftFixed_Test.c reads the same file.
+ *
+ * To compile: g++ -O2 -Isw PC_FftPipeline_Model.cpp sw/fftFixed.c -o fftpipeline_model
+ * To run: ./fftpipeline_model [vectors.txt [frames]]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "frameBuffers.h"
+#include "fftPipelineModel.hpp"
+
+#define N               FFT_SIZE
+#define STREAM_FRAMES   16
+#define BENCH_FRAMES    2000
+#define TONE_BIN        10
+#define TONE_AMPLITUDE  16000
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void random_frame(uint32_t *rx)
+{
+    for (int i = 0; i < N; i++) {
+        rx[i] = (uint32_t)rand() << 16 ^ (uint32_t)rand();
+    }
+}
+
+// Real cosine at `bin`, Imag = 0, as the acquisition packs it
+static void tone_frame(uint32_t *rx, int bin, int amplitude)
+{
+    for (int i = 0; i < N; i++) {
+        int16_t v = (int16_t)lround(amplitude * cos(2.0 * M_PI * bin * i / N));
+        rx[i] = (uint16_t)v;
+    }
+}
+
+static int test_mag_squared(void)
+{
+    struct { uint32_t in, out; } cases[] = {
+        { 0x00040003, 25 },             // 3^2 + 4^2
+        { 0x0000FFFF, 1 },              // (-1)^2
+        { 0x80000000, 0x40000000 },     // (-32768)^2 in Imag
+        { 0x80008000, 0x80000000 },     // 2^30 + 2^30: past INT32_MAX, wraps as the RTL sum
+        { 0x7FFF8000, 0x7FFF0001 },     // 2^30 + 32767^2
+    };
+    int pass = 1;
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        pass &= FftPipelineModel::magSquared(cases[i].in) == cases[i].out;
+    }
+    printf("mag_squared:  %s\n", pass ? "ok" : "WRONG");
+    return pass;
+}
+
+static int test_streaming(void)
+{
+    static uint32_t rx[STREAM_FRAMES][N], tx[STREAM_FRAMES][N], streamed[STREAM_FRAMES * N];
+    FftPipelineModel framed, streaming;
+    size_t pushed = 0, popped = 0;
+    int lastsOk = 1;
+
+    for (int f = 0; f < STREAM_FRAMES; f++) {
+        random_frame(rx[f]);
+        framed.processFrame(rx[f], tx[f]);
+    }
+
+    // Input and output in random chunks, as a DMA with stalls would move them
+    const uint32_t *in = &rx[0][0];
+    while (popped < (size_t)STREAM_FRAMES * N) {
+        size_t chunk = 1 + rand() % 300;
+        for (size_t i = 0; i < chunk && pushed < (size_t)STREAM_FRAMES * N; i++, pushed++) {
+            streaming.push(in[pushed], pushed % N == N - 1);
+        }
+        chunk = 1 + rand() % 300;
+        FftStreamBeat beat;
+        for (size_t i = 0; i < chunk && streaming.pop(beat); i++, popped++) {
+            streamed[popped] = beat.tdata;
+            lastsOk &= beat.last == (popped % N == N - 1);
+        }
+    }
+
+    int pass = memcmp(streamed, tx, sizeof(streamed)) == 0 && lastsOk &&
+               framed.stats().frames == STREAM_FRAMES && streaming.stats().frames == STREAM_FRAMES &&
+               streaming.cycles() == framed.cycles();
+    printf("streaming:    %d frames in random chunks, words %s frame API, TLAST %s\n", STREAM_FRAMES,
+           memcmp(streamed, tx, sizeof(streamed)) == 0 ? "match the" : "DIFFER from the",
+           lastsOk ? "on every last bin" : "MISPLACED");
+    return pass;
+}
+
+static int test_tlast(void)
+{
+    static uint32_t rx[N], tx[N];
+    FftPipelineModel model;
+
+    random_frame(rx);
+    for (int i = 0; i < N; i++) {
+        model.push(rx[i], i == N / 2);         // early TLAST, none at the end
+    }
+    size_t words = model.popTransfer(tx, N);
+
+    const FftPipelineModel::Stats &s = model.stats();
+    int pass = s.tlastUnexpected == 1 && s.tlastMissing == 1 && s.frames == 1 && words == N;
+    printf("tlast:        early TLAST -> %llu unexpected, %llu missing, frame still %zu beats\n",
+           (unsigned long long)s.tlastUnexpected, (unsigned long long)s.tlastMissing, words);
+    return pass;
+}
+
+static int peak_bin(const uint32_t *tx)
+{
+    int peak = 0;
+    for (int k = 1; k < N / 2; k++) {
+        if (tx[k] > tx[peak]) {
+            peak = k;
+        }
+    }
+    return peak;
+}
+
+static int test_tone(void)
+{
+    static uint32_t rx[N], tx[N];
+    FftPipelineModel::Config config;
+    config.scaling = FFTFIX_SCALED;
+
+    fftfix_plan_t plan;
+    fftfix_complex_t tw[FFTFIX_TWIDDLES(N)];
+    uint16_t br[N];
+    fftfix_init(&plan, N, tw, br, FFTFIX_TRUNCATE);
+    config.schedule = fftfix_conservativeSchedule(&plan);
+    int shift = plan.log2n + 1;
+
+    FftPipelineModel model(config);
+    tone_frame(rx, TONE_BIN, TONE_AMPLITUDE);
+    model.processFrame(rx, tx);
+
+    // A cosine of amplitude A gives A * N / 2 in its bin, before the schedule's shift
+    double bin = TONE_AMPLITUDE * (double)N / 2 / (1 << shift);
+    double expected = bin * bin;
+    int peak = peak_bin(tx);
+    int pass = peak == TONE_BIN && fabs(tx[peak] - expected) < 0.02 * expected && model.stats().overflows == 0;
+    printf("tone scaled:  %d-bit TDATA, schedule 0x%03X, peak bin %d power %u (expected %.0f)\n",
+           2 * ((model.xfftWidth() + 7) / 8 * 8), config.schedule, peak, tx[peak], expected);
+    return pass;
+}
+
+// The design as built: unscaled 64-bit TDATA, low 32 bits into power_calc_0
+static void report_as_built(void)
+{
+    static uint32_t rx[N], tx[N];
+    FftPipelineModel model;
+
+    tone_frame(rx, TONE_BIN, TONE_AMPLITUDE);
+    model.processFrame(rx, tx);
+
+    uint64_t word = model.lastXfft()[TONE_BIN];
+    int32_t re = (int32_t)(uint32_t)word, im = (int32_t)(uint32_t)(word >> 32);
+    printf("as built:     %d-bit TDATA; bin %d is (%d, %d) but power_calc sees (%d, %d) -> %u, peak at bin %d\n",
+           2 * ((model.xfftWidth() + 7) / 8 * 8), TONE_BIN, re, im,
+           (int16_t)(re & 0xFFFF), (int16_t)((uint32_t)re >> 16), tx[TONE_BIN], peak_bin(tx));
+}
+
+static void write_vectors(const char *path, int frames)
+{
+    static uint32_t rx[N], tx[N];
+    FftPipelineModel model;
+    FILE *fp = fopen(path, "w");
+
+    if (fp == NULL) {
+        printf("vectors:      cannot write %s\n", path);
+        return;
+    }
+    fprintf(fp, "# input_tdata xfft_tdata power_tdata tlast  (%d-point, as built)\n", N);
+    for (int f = 0; f < frames; f++) {
+        if (f == 0) {
+            tone_frame(rx, TONE_BIN, TONE_AMPLITUDE);
+        } else {
+            random_frame(rx);
+        }
+        model.processFrame(rx, tx);
+        for (int i = 0; i < N; i++) {
+            fprintf(fp, "%08X %016llX %08X %d\n", model.lastInput()[i],
+                    (unsigned long long)model.lastXfft()[i], tx[i], i == N - 1);
+        }
+    }
+    fclose(fp);
+    printf("vectors:      %d frames written to %s\n", frames, path);
+}
+
+static void benchmark(void)
+{
+    static uint32_t rx[N], tx[N];
+    FftPipelineModel model;
+
+    random_frame(rx);
+    double t0 = now_s();
+    for (int f = 0; f < BENCH_FRAMES; f++) {
+        model.processFrame(rx, tx);
+    }
+    double t = now_s() - t0;
+    printf("host:         %.0f frames/s through the model (%d frames)\n", BENCH_FRAMES / t, BENCH_FRAMES);
+}
+
+static void estimate(void)
+{
+    FftPipelineTiming timing;
+    FftPipelineEstimate simple = FftPipelineModel::estimate(timing, N, FftPipelineModel::SIMPLE, 1000);
+    FftPipelineEstimate sg = FftPipelineModel::estimate(timing, N, FftPipelineModel::SCATTER_GATHER, 1000);
+    double native = timing.clockHz / N;
+
+    printf("%.0f MHz:      simple DMA %.0f cycles/frame = %.0f frames/s, scatter-gather %.0f cycles/frame = "
+           "%.0f frames/s (%.0f%% of one frame per %d clocks); latency %.1f us\n",
+           timing.clockHz / 1e6, simple.cyclesPerFrame, simple.framesPerSecond, sg.cyclesPerFrame,
+           sg.framesPerSecond, 100.0 * sg.framesPerSecond / native, N, sg.latencyCycles / timing.clockHz * 1e6);
+    printf("              the ADXL345 at 3200 Hz fills %.1f frames/s\n", 3200.0 / N);
+}
+
+int main(int argc, char **argv)
+{
+    int pass = 1;
+
+    if (!FftPipelineModel().ok()) {
+        printf("init failed\n");
+        return 1;
+    }
+
+    pass &= test_mag_squared();
+    pass &= test_streaming();
+    pass &= test_tlast();
+    pass &= test_tone();
+    report_as_built();
+    if (argc > 1) {
+        write_vectors(argv[1], argc > 2 ? atoi(argv[2]) : 4);
+    }
+    benchmark();
+    estimate();
+
+    printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
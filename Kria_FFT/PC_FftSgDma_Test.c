@@ -0,0 +1,235 @@
+/*
+ * Host Test for the Scatter-Gather FFT DMA
+ * ========================================
+ * Runs sw/fftSgDma.c on your local PC against sw/fftSgDmaSim.h (FFTSG_HOST),
+ * a register-level model of the AXI DMA in scatter-gather mode feeding a
+ * pipelined-streaming FFT (its clock scaled down x10, see NS_PER_WORD).
+ * The BD rings and frames live in a 64 KB buffer laid out like the shared
+ * BRAM (sw/frameBuffers.h); the model walks the rings itself and rejects
+ * descriptors the driver got wrong.
+ *
+ * Three runs:
+ *   one-by-one - one frame queued at a time, as with simple mode: every
+ *                frame waits for the FFT pipeline to fill and drain
+ *   streaming  - the ring kept full: frames follow each other through the
+ *                FFT with no gap, close to the native one frame per N words
+ *   recovery   - an injected DMA error and an injected hang with the ring
+ *                full: every queued frame comes back as FFTSG_ERROR /
+ *                FFTSG_TIMEOUT, the core is reset and streaming resumes
+ *   stuck      - a hang whose reset never completes: the ring still comes
+ *                back as FFTSG_TIMEOUT, fftsg_failed() is set and no
+ *                further frame is accepted
+ * Every completed frame is checked (the model copies RX to TX), completions
+ * must arrive in submit order, and the model must not have rejected a BD.
+ * Only the injected faults may fail frames: one ring of FFTSG_ERROR, two of
+ * FFTSG_TIMEOUT, and every other frame must come back ok.
+ *
+ * To compile: gcc -O2 -DFFTSG_HOST -Isw PC_FftSgDma_Test.c sw/fftSgDma.c -o fftsgdma_test -lpthread
+ * To run: ./fftsgdma_test
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <sched.h>
+#include <time.h>
+#include "frameBuffers.h"
+#include "fftSgDma.h"
+
+#define BRAM_BYTES      0x10000
+#define FRAMES          20000
+#define TIMEOUT_US      200000
+#define NS_PER_WORD     100         // model time scaled x10 (102 us frames) for host scheduling
+#define RESUME_FRAMES   100         // streamed after each recovery
+
+static uint8_t *bram;
+static fftsgsim_t sim;
+static fftsg_t sg;
+
+static uint32_t submitted;
+static uint32_t retired;
+static uint32_t framesOk;
+static uint32_t framesBad;
+static uint32_t outOfOrder;
+static uint32_t statusCount[3];
+
+static uint32_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000u + ts.tv_nsec / 1000);
+}
+
+static uint32_t *rx_frame(int k)
+{
+    return (uint32_t *)(bram + RX_FRAME_OFFSET(k));
+}
+
+static uint32_t *tx_frame(int k)
+{
+    return (uint32_t *)(bram + TX_FRAME_OFFSET(k));
+}
+
+static void frame_done(void *ref, int slot, int status)
+{
+    (void)ref;
+
+    if (slot != (int)(retired % FRAME_BUFFERS)) {
+        outOfOrder++;
+    }
+    retired++;
+    statusCount[status]++;
+
+    if (status == FFTSG_OK) {
+        if (memcmp(tx_frame(slot), rx_frame(slot), FRAME_BYTES) == 0) {
+            framesOk++;
+        } else {
+            framesBad++;
+        }
+    }
+}
+
+static int submit(void)
+{
+    int k = submitted % FRAME_BUFFERS;
+    uint32_t *frame = rx_frame(k);
+
+    for (int i = 0; i < FFT_SIZE; i++) {
+        frame[i] = (submitted << 16) | (uint32_t)i;
+    }
+    if (fftsg_submit(&sg, k, (UINTPTR)frame, (UINTPTR)tx_frame(k), FRAME_BYTES, now_us()) != XST_SUCCESS) {
+        return 0;
+    }
+    submitted++;
+    return 1;
+}
+
+static void service(void)
+{
+    if (fftsg_service(&sg, now_us()) == 0) {
+        sched_yield();
+    }
+}
+
+static double run(uint32_t frames, int depth)
+{
+    uint32_t t0 = now_us();
+    uint32_t end = submitted + frames;
+
+    while (retired < end) {
+        while (submitted < end && sg.queued < depth) {
+            submit();
+        }
+        service();
+    }
+    return (now_us() - t0) / 1e6;
+}
+
+static int run_fault(int fault, int expected)
+{
+    uint32_t resets = sg.resets;
+    uint32_t before[3];
+    uint32_t end;
+
+    memcpy(before, statusCount, sizeof(before));
+
+    // Faulty frame first, the ring full behind it
+    fftsgsim_inject(&sim, fault);
+    while (fftsg_free(&sg) > 0) {
+        submit();
+    }
+    end = submitted;
+    while (retired < end) {
+        service();
+    }
+
+    uint32_t ok = statusCount[FFTSG_OK] - before[FFTSG_OK];
+    uint32_t failed = statusCount[expected] - before[expected];
+    int pass = ok == 0 && failed == FRAME_BUFFERS && sg.resets == resets + 1;
+    printf("  fault %d: %u ok, %u returned with status %d, %u reset(s)\n",
+           fault, ok, failed, expected, sg.resets - resets);
+
+    // Streaming must resume after the reset
+    uint32_t okBefore = framesOk;
+    run(RESUME_FRAMES, FRAME_BUFFERS);
+    return pass && framesOk == okBefore + RESUME_FRAMES;
+}
+
+// Hang with a core that never leaves reset: the driver must give up
+static int run_stuck(void)
+{
+    uint32_t resets = sg.resets;
+    uint32_t before = statusCount[FFTSG_TIMEOUT];
+    uint32_t end;
+
+    fftsgsim_inject(&sim, FFTSGSIM_HANG);
+    fftsgsim_inject(&sim, FFTSGSIM_STUCK_RESET);
+    while (fftsg_free(&sg) > 0) {
+        submit();
+    }
+    end = submitted;
+    while (retired < end) {
+        service();
+    }
+
+    uint32_t timedOut = statusCount[FFTSG_TIMEOUT] - before;
+    int refused = !submit();
+    printf("stuck:      %u returned with status %d, failed %d, %u reset(s), next submit %s\n",
+           timedOut, FFTSG_TIMEOUT, fftsg_failed(&sg), sg.resets - resets, refused ? "refused" : "ACCEPTED");
+    return timedOut == FRAME_BUFFERS && fftsg_failed(&sg) && sg.resets == resets && refused &&
+           fftsg_service(&sg, now_us()) == 0;
+}
+
+int main(void)
+{
+    int pass = 1;
+
+    bram = aligned_alloc(FFTSG_BD_SIZE, BRAM_BYTES);
+    if (bram == NULL || fftsgsim_init(&sim) != XST_SUCCESS ||
+        fftsg_init(&sg, (UINTPTR)&sim, (UINTPTR)(bram + MM2S_BD_OFFSET), (UINTPTR)(bram + S2MM_BD_OFFSET),
+                   FRAME_BUFFERS, frame_done, NULL, TIMEOUT_US) != XST_SUCCESS) {
+        printf("init failed\n");
+        return 1;
+    }
+    sim.nsPerWord = NS_PER_WORD;
+    sim.latencyNs = 2 * FFT_SIZE * NS_PER_WORD;
+    fftsgsim_connect(&sim, 0, fftsg_mm2sIsr, &sg);
+    fftsgsim_connect(&sim, 1, fftsg_s2mmIsr, &sg);
+
+    double native = 1e9 / ((double)FFT_SIZE * sim.nsPerWord);
+    printf("%d-point frames, %d BDs per ring, native rate %.0f frames/s, pipeline latency %u ns\n",
+           FFT_SIZE, FRAME_BUFFERS, native, sim.latencyNs);
+
+    uint32_t refills = sim.refills;
+    double single = run(FRAMES / 10, 1);
+    printf("one-by-one: %.0f frames/s, %u pipeline refills\n", (FRAMES / 10) / single, sim.refills - refills);
+
+    refills = sim.refills;
+    double stream = run(FRAMES, FRAME_BUFFERS);
+    printf("streaming:  %.0f frames/s (%.0f%% of native), %u pipeline refills in %d frames\n",
+           FRAMES / stream, 100.0 * FRAMES / stream / native, sim.refills - refills, FRAMES);
+
+    printf("recovery:\n");
+    pass &= run_fault(FFTSGSIM_ERROR, FFTSG_ERROR);
+    pass &= run_fault(FFTSGSIM_HANG, FFTSG_TIMEOUT);
+    pass &= !fftsg_failed(&sg);
+    pass &= run_stuck();
+
+    // Only the two injected faults may fail frames, each taking the full ring with it
+    uint32_t expectOk = FRAMES / 10 + FRAMES + 2 * RESUME_FRAMES;
+    printf("%u frames: %u ok (expected %u), %u error, %u timeout, %u corrupted, %u out of order, "
+           "%u BDs rejected by the model\n",
+           retired, framesOk, expectOk, statusCount[FFTSG_ERROR], statusCount[FFTSG_TIMEOUT],
+           framesBad, outOfOrder, sim.bdErrors);
+    pass &= framesBad == 0 && outOfOrder == 0 && sim.bdErrors == 0 && framesOk == expectOk &&
+            statusCount[FFTSG_OK] == expectOk && sg.completed == expectOk &&
+            statusCount[FFTSG_ERROR] == FRAME_BUFFERS && statusCount[FFTSG_TIMEOUT] == 2 * FRAME_BUFFERS &&
+            sg.resets == 2;
+
+    printf("%s\n", pass ? "PASS" : "FAIL");
+
+    fftsgsim_shutdown(&sim);
+    free(bram);
+    return pass ? 0 : 1;
+}
@@ -17,6 +17,9 @@ set project_name "Kria_FFT"
 set project_dir "./$project_name"
 set board_part "xilinx.com:kr260_som:part0:1.1"
 set device_part "xck26-sfvc784-2LV-c"
+# DMA mode: 1 = scatter-gather (frames queued as BDs in the shared BRAM, sw/fftSgDma.c),
+# 0 = simple mode (one SimpleTransfer per frame, sw/fftDma.c). Must match DMA_SG_MODE in sw/main_mb.c
+set dma_sg_mode 1
 
 # =========================================================================================
 # PART 1: BASE SYSTEM CREATION
@@ -66,6 +69,9 @@ if { $old_ic != "" } {
 
 # Peripherals
 set iic [create_bd_cell -type ip -vlnv xilinx.com:ip:axi_iic axi_iic_0]
+# 400 kHz fast mode: one ADXL345 FIFO entry is ~84 bit times, so this carries
+# up to ~4.7k samples/s (3200 Hz ODR); 100 kHz tops out below 1200 samples/s
+set_property CONFIG.IIC_FREQ_KHZ {400} $iic
 set mb_bram_ctrl [create_bd_cell -type ip -vlnv xilinx.com:ip:axi_bram_ctrl mb_bram_ctrl]
 set ps_bram_ctrl [create_bd_cell -type ip -vlnv xilinx.com:ip:axi_bram_ctrl ps_bram_ctrl]
 set shared_bram [create_bd_cell -type ip -vlnv xilinx.com:ip:blk_mem_gen shared_bram]
@@ -184,10 +190,10 @@ set_property -dict [list \
 ] $xfft
 
 # 3. Add AXI DMA
-# Simple Mode (Scatter Gather Disabled), Width matching our data (32-bit)
+# Scatter Gather per $dma_sg_mode (BDs fetched over M_AXI_SG), Width matching our data (32-bit)
 set dma [create_bd_cell -type ip -vlnv xilinx.com:ip:axi_dma axi_dma_0]
 set_property -dict [list \
-    CONFIG.c_include_sg {0} \
+    CONFIG.c_include_sg $dma_sg_mode \
     CONFIG.c_sg_include_stscntrl_strm {0} \
     CONFIG.c_include_mm2s {1} \
     CONFIG.c_include_s2mm {1} \
@@ -202,6 +208,9 @@ connect_bd_net $clk_src [get_bd_pins xfft_0/aclk]
 connect_bd_net $clk_src [get_bd_pins axi_dma_0/s_axi_lite_aclk]
 connect_bd_net $clk_src [get_bd_pins axi_dma_0/m_axi_mm2s_aclk]
 connect_bd_net $clk_src [get_bd_pins axi_dma_0/m_axi_s2mm_aclk]
+if { $dma_sg_mode } {
+    connect_bd_net $clk_src [get_bd_pins axi_dma_0/m_axi_sg_aclk]
+}
 connect_bd_net $clk_src [get_bd_pins power_calc_0/aclk]
 
 # Shared Reset
@@ -282,6 +291,32 @@ connect_bd_net [get_bd_pins const_zeros/dout] [get_bd_pins xfft_0/s_axis_config_
 set_property CONFIG.NUM_MI {4} $smc_mb
 connect_bd_intf_net [get_bd_intf_pins smc_mb/M03_AXI] [get_bd_intf_pins axi_dma_0/S_AXI_LITE]
 
+# Doorbell: 1-bit GPIO pulsed by the MicroBlaze after each frame, wired to
+# pl_ps_irq0[0] (GIC SPI 121) so the PS sleeps instead of polling the flag
+set doorbell_gpio [create_bd_cell -type ip -vlnv xilinx.com:ip:axi_gpio doorbell_gpio]
+set_property -dict [list \
+    CONFIG.C_ALL_OUTPUTS {1} \
+    CONFIG.C_GPIO_WIDTH {1} \
+] $doorbell_gpio
+set_property CONFIG.PSU__USE__IRQ0 {1} $zynq
+
+set_property CONFIG.NUM_MI {5} $smc_mb
+connect_bd_intf_net [get_bd_intf_pins smc_mb/M04_AXI] [get_bd_intf_pins doorbell_gpio/S_AXI]
+connect_bd_net $clk_src [get_bd_pins doorbell_gpio/s_axi_aclk]
+connect_bd_net $rst_peripheral [get_bd_pins doorbell_gpio/s_axi_aresetn]
+connect_bd_net [get_bd_pins doorbell_gpio/gpio_io_o] [get_bd_pins zynq_ultra_ps_e_0/pl_ps_irq0]
+
+# DMA completion interrupts -> AXI INTC (In0 = MM2S, In1 = S2MM), so the
+# MicroBlaze acquires the next frame instead of polling XAxiDma_Busy
+set irq_concat [get_bd_cells -quiet microblaze_0_xlconcat]
+if { $irq_concat == "" } {
+    set irq_concat [create_bd_cell -type ip -vlnv xilinx.com:ip:xlconcat microblaze_0_xlconcat]
+    connect_bd_net [get_bd_pins $irq_concat/dout] [get_bd_pins $intc/intr]
+}
+set_property CONFIG.NUM_PORTS {2} $irq_concat
+connect_bd_net [get_bd_pins axi_dma_0/mm2s_introut] [get_bd_pins $irq_concat/In0]
+connect_bd_net [get_bd_pins axi_dma_0/s2mm_introut] [get_bd_pins $irq_concat/In1]
+
 # Reconfigure smc_ps (for Masters -> Ram)
 # Zynq, DMA_MM2S, DMA_S2MM all need to access Shared BRAM.
 # Currently smc_ps is: Zynq -> BRAM.
@@ -291,6 +326,11 @@ set_property CONFIG.NUM_SI {3} $smc_ps
 # Connect DMA Masters to SmartConnect Slaves
 connect_bd_intf_net [get_bd_intf_pins axi_dma_0/M_AXI_MM2S] [get_bd_intf_pins smc_ps/S01_AXI]
 connect_bd_intf_net [get_bd_intf_pins axi_dma_0/M_AXI_S2MM] [get_bd_intf_pins smc_ps/S02_AXI]
+# S03: DMA descriptor fetch / status write-back (BD rings in the shared BRAM)
+if { $dma_sg_mode } {
+    set_property CONFIG.NUM_SI {4} $smc_ps
+    connect_bd_intf_net [get_bd_intf_pins axi_dma_0/M_AXI_SG] [get_bd_intf_pins smc_ps/S03_AXI]
+}
 
 # Clocks/Resets for new SMC ports
 # Explicitly connect clock to all SI slots on smc_ps to avoid validation warnings
@@ -321,6 +361,23 @@ if { [file exists $xdc_file] } {
 
 puts "--- Validating and Saving Design ---"
 assign_bd_address
+# The shared BRAM holds N RX + N TX frames and the slot states (sw/frameBuffers.h),
+# so map it 64 KB wide for every master that uses it
+foreach seg [get_bd_addr_segs -quiet { \
+    microblaze_0/Data/SEG_mb_bram_ctrl_Mem0 \
+    zynq_ultra_ps_e_0/Data/SEG_ps_bram_ctrl_Mem0 \
+    axi_dma_0/Data_MM2S/SEG_ps_bram_ctrl_Mem0 \
+    axi_dma_0/Data_S2MM/SEG_ps_bram_ctrl_Mem0 \
+    axi_dma_0/Data_SG/SEG_ps_bram_ctrl_Mem0 \
+}] {
+    set_property range 64K $seg
+}
+# The MicroBlaze hands the DMA its own BRAM addresses (frame buffers, and the
+# BD ring links in SG mode), so the DMA must see the BRAM at the same offset
+set mb_bram_offset [get_property offset [get_bd_addr_segs microblaze_0/Data/SEG_mb_bram_ctrl_Mem0]]
+foreach seg [get_bd_addr_segs -quiet axi_dma_0/*/SEG_ps_bram_ctrl_Mem0] {
+    set_property offset $mb_bram_offset $seg
+}
 validate_bd_design
 save_bd_design
 close_bd_design [current_bd_design]
@@ -0,0 +1,142 @@
+/*
+fftAcquire.c - ADXL345 FIFO acquisition straight into the FFT RX buffer (see fftAcquire.h).
+*/
+
+#include "fftAcquire.h"
+
+// Bit times of one transaction: START (or repeated START), address + ACK,
+// n bytes + ACK each, and the STOP if it ends the transfer
+static inline uint32_t fftacq_bits(uint32_t bytes, int stop)
+{
+    return 1 + 9 + 9 * bytes + (stop ? 1 : 0);
+}
+
+// Register pointer write, repeated START, read n bytes
+static int fftacq_read(fftacq_t *acq, uint8_t reg, uint8_t *buffer, unsigned n, uint64_t *bits)
+{
+    u8 pointer = reg;
+    unsigned got;
+
+    if (XIic_Send(acq->iicBase, FFTACQ_ADDRESS, &pointer, 1, XIIC_REPEATED_START) != 1)
+    {
+        return XST_FAILURE;
+    }
+    got = XIic_Recv(acq->iicBase, FFTACQ_ADDRESS, buffer, n, XIIC_STOP);
+    *bits += fftacq_bits(1, 0) + fftacq_bits(n, 1);
+
+    return got == n ? XST_SUCCESS : XST_FAILURE;
+}
+
+static int fftacq_write(fftacq_t *acq, uint8_t reg, uint8_t value)
+{
+    u8 buffer[2] = {reg, value};
+
+    acq->pollBits += fftacq_bits(2, 1);
+    return XIic_Send(acq->iicBase, FFTACQ_ADDRESS, buffer, 2, XIIC_STOP) == 2 ? XST_SUCCESS : XST_FAILURE;
+}
+
+int fftacq_init(fftacq_t *acq, UINTPTR iicBase, uint32_t busHz, int axis, uint8_t dataRate)
+{
+    uint8_t devid = 0;
+
+    acq->iicBase = iicBase;
+    acq->busHz = busHz;
+    acq->axis = axis;
+    acq->dataRate = dataRate;
+    acq->samples = 0;
+    acq->overruns = 0;
+    acq->polls = 0;
+    acq->dataBits = 0;
+    acq->pollBits = 0;
+
+    if (fftacq_read(acq, FFTACQ_REG_DEVID, &devid, 1, &acq->pollBits) != XST_SUCCESS || devid != FFTACQ_DEVID)
+    {
+        return XST_FAILURE;
+    }
+
+    // Configure in standby, then start measuring
+    if (fftacq_write(acq, FFTACQ_REG_POWER_CTL, 0) != XST_SUCCESS ||
+        fftacq_write(acq, FFTACQ_REG_BW_RATE, dataRate & 0x0F) != XST_SUCCESS ||
+        fftacq_write(acq, FFTACQ_REG_DATA_FORMAT, FFTACQ_FULL_RES_16G) != XST_SUCCESS ||
+        fftacq_write(acq, FFTACQ_REG_FIFO_CTL, FFTACQ_FIFO_STREAM | (FFTACQ_FIFO_DEPTH / 2)) != XST_SUCCESS ||
+        fftacq_write(acq, FFTACQ_REG_POWER_CTL, FFTACQ_MEASURE) != XST_SUCCESS)
+    {
+        return XST_FAILURE;
+    }
+
+    return XST_SUCCESS;
+}
+
+int fftacq_setDataRate(fftacq_t *acq, uint8_t dataRate)
+{
+    if (fftacq_write(acq, FFTACQ_REG_BW_RATE, dataRate & 0x0F) != XST_SUCCESS)
+    {
+        return XST_FAILURE;
+    }
+    acq->dataRate = dataRate;
+    return XST_SUCCESS;
+}
+
+int fftacq_fill(fftacq_t *acq, volatile uint32_t *dst, int count)
+{
+    uint8_t status;
+    int entries;
+
+    acq->polls++;
+    if (fftacq_read(acq, FFTACQ_REG_FIFO_STATUS, &status, 1, &acq->pollBits) != XST_SUCCESS)
+    {
+        return 0;
+    }
+
+    entries = status & 0x3F;
+    if (entries == 0)
+    {
+        return 0;
+    }
+
+    // A full FIFO may have overflowed since the last poll
+    if (entries >= FFTACQ_FIFO_DEPTH)
+    {
+        uint8_t source;
+        if (fftacq_read(acq, FFTACQ_REG_INT_SOURCE, &source, 1, &acq->pollBits) == XST_SUCCESS &&
+            (source & FFTACQ_INT_OVERRUN))
+        {
+            acq->overruns++;
+        }
+    }
+
+    if (entries > count)
+    {
+        entries = count;
+    }
+
+    for (int i = 0; i < entries; i++)
+    {
+        uint8_t va[6];
+
+        // One burst per entry; the STOP/START gap lets the FIFO advance
+        if (fftacq_read(acq, FFTACQ_REG_DATAX0, va, 6, &acq->dataBits) != XST_SUCCESS)
+        {
+            return i;
+        }
+
+        // Little-endian axis pair; Real = sample, Imag = 0
+        uint16_t real = (uint16_t)(va[2 * acq->axis + 1] << 8 | va[2 * acq->axis]);
+        dst[i] = real;
+        acq->samples++;
+    }
+
+    return entries;
+}
+
+uint32_t fftacq_busPermille(const fftacq_t *acq, uint64_t bits, uint32_t samples)
+{
+    // (bits / busHz) / (samples / odr) * 1000, with the ODR in mHz
+    uint64_t sampleTime = (uint64_t)acq->busHz * samples;
+
+    if (sampleTime == 0)
+    {
+        return 0;
+    }
+    return (uint32_t)(bits * fftacq_odrMilliHz(acq->dataRate) / sampleTime);
+}
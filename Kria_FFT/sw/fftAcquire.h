@@ -0,0 +1,125 @@
+/*
+fftAcquire.h - ADXL345 FIFO acquisition straight into the FFT RX buffer.
+
+The sensor runs in stream mode at the configured output data rate (ODR)
+and buffers up to 32 samples in its FIFO. fftacq_fill() drains whatever
+the FIFO holds, one 6-byte burst per entry (the FIFO pops after each read
+of DATAX0..DATAZ1), and writes the selected axis into the frame as the
+xfft input word:
+
+    [31:16] Imag = 0    [15:0] Real = raw sample (full resolution, 4 mg/LSB)
+
+It never blocks waiting for samples, so the main loop keeps servicing the
+DMA between calls and a frame fills over several passes:
+
+    fftacq_init(&acq, XPAR_AXI_IIC_0_BASEADDR, FFTACQ_BUS_HZ, FFTACQ_AXIS_X, FFTACQ_DATARATE_1600HZ);
+    n += fftacq_fill(&acq, rx + n, FFT_SIZE - n);
+
+Counters (cumulative, never reset):
+    samples     samples written to frames
+    overruns    polls that found the FIFO overflowed: at least one sample
+                was dropped each time (the sensor does not say how many)
+    dataBits    I2C bit times spent reading samples
+    pollBits    I2C bit times spent on FIFO_STATUS / INT_SOURCE polls and setup
+Bus time is counted from the transaction sizes (START, address, data and
+ACK bits, STOP), so fftacq_busPermille() gives the bus utilisation without
+a timer: bus time over the time the sensor took to produce the samples.
+Polling fills whatever the sample reads leave idle; the sample share alone
+says how close the ODR is to what the bus can carry, and above 100% the
+sensor is dropping samples.
+
+Built with FFTACQ_HOST the XIic calls go to fftAcquireSim.h, an ADXL345
+FIFO model on a virtual-time I2C bus (PC_FftAcquire_Test.c).
+*/
+
+#ifndef FFTACQUIRE_h
+#define FFTACQUIRE_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef FFTACQ_HOST
+#include "fftAcquireSim.h"
+#else
+#include "xiic_l.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FFTACQ_ADDRESS          0x53
+#define FFTACQ_BUS_HZ           400000  // axi_iic_0 SCL (IIC_FREQ_KHZ in build_complete_system.tcl)
+
+// Output data rates (BW_RATE codes, adxl345_dataRate_t in I2C/Vitis/ADXL345.h)
+#define FFTACQ_DATARATE_3200HZ  0x0F
+#define FFTACQ_DATARATE_1600HZ  0x0E
+#define FFTACQ_DATARATE_800HZ   0x0D
+#define FFTACQ_DATARATE_400HZ   0x0C
+#define FFTACQ_DATARATE_200HZ   0x0B
+#define FFTACQ_DATARATE_100HZ   0x0A
+
+#define FFTACQ_AXIS_X           0
+#define FFTACQ_AXIS_Y           1
+#define FFTACQ_AXIS_Z           2
+
+// ADXL345 registers and settings used here (see I2C/Vitis/ADXL345.h)
+#define FFTACQ_REG_DEVID        0x00
+#define FFTACQ_REG_BW_RATE      0x2C
+#define FFTACQ_REG_POWER_CTL    0x2D
+#define FFTACQ_REG_INT_SOURCE   0x30
+#define FFTACQ_REG_DATA_FORMAT  0x31
+#define FFTACQ_REG_DATAX0       0x32
+#define FFTACQ_REG_FIFO_CTL     0x38
+#define FFTACQ_REG_FIFO_STATUS  0x39
+
+#define FFTACQ_DEVID            0xE5
+#define FFTACQ_FIFO_DEPTH       32
+#define FFTACQ_FULL_RES_16G     0x0B    // FULL_RES, +/-16 g: 4 mg/LSB on every range
+#define FFTACQ_FIFO_STREAM      0x80
+#define FFTACQ_MEASURE          0x08
+#define FFTACQ_INT_OVERRUN      0x01
+
+typedef struct
+{
+    UINTPTR iicBase;
+    uint32_t busHz;
+    int axis;
+    uint8_t dataRate;           // ADXL345 BW_RATE code (adxl345_dataRate_t)
+
+    // Counters
+    uint32_t samples;
+    uint32_t overruns;
+    uint32_t polls;
+    uint64_t dataBits;
+    uint64_t pollBits;
+} fftacq_t;
+
+// Check the DEVID, set the ODR, full resolution and stream mode, start measuring
+int fftacq_init(fftacq_t *acq, UINTPTR iicBase, uint32_t busHz, int axis, uint8_t dataRate);
+
+int fftacq_setDataRate(fftacq_t *acq, uint8_t dataRate);
+
+static inline void fftacq_setAxis(fftacq_t *acq, int axis)
+{
+    acq->axis = axis;
+}
+
+// Output data rate in mHz for a BW_RATE code (3200 Hz halving per step)
+static inline uint32_t fftacq_odrMilliHz(uint8_t dataRate)
+{
+    return 3200000u >> (15 - (dataRate & 0x0F));
+}
+
+// Move up to `count` FIFO samples into dst as xfft input words; returns the
+// number written (0 if the FIFO is empty)
+int fftacq_fill(fftacq_t *acq, volatile uint32_t *dst, int count);
+
+// Bus busy time as a share (1/1000) of the time `samples` took at the ODR
+uint32_t fftacq_busPermille(const fftacq_t *acq, uint64_t bits, uint32_t samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
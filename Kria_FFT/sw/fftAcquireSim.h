@@ -0,0 +1,192 @@
+/*
+fftAcquireSim.h - Host (Linux) stand-in for the ADXL345 on axi_iic_0, selected with FFTACQ_HOST.
+
+The IIC base address handed to fftacq_init() is the address of an
+fftacqsim_t. XIic_Send / XIic_Recv below run the transfer against an
+ADXL345 model (register pointer with auto-increment, 32-entry FIFO in
+stream mode, FIFO_STATUS, OVERRUN in INT_SOURCE, reads of DATAX0..DATAZ1
+pop the FIFO) and advance a virtual clock by the transfer's bit times at
+busHz, so the sensor produces samples while the bus is busy exactly as
+the real part would. I2C/Vitis/ADXL345Sim.hpp is the fuller C++ model.
+
+Samples come from source(ref, index, xyz) for sample number `index`; the
+default is a ramp (x = index, y = -index, z = 1000 + index, all mod 2^12)
+so a reader can find gaps. generated / dropped count the sensor side.
+*/
+
+#ifndef FFTACQUIRESIM_h
+#define FFTACQUIRESIM_h
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef XST_SUCCESS
+typedef uint8_t u8;
+typedef uint32_t u32;
+typedef uintptr_t UINTPTR;
+#define XST_SUCCESS             0
+#define XST_FAILURE             1
+#endif
+
+#define XIIC_STOP               0x00
+#define XIIC_REPEATED_START     0x01
+
+#define FFTACQSIM_SLOTS         33      // FIFO plus the output data registers
+
+typedef void (*fftacqsim_source_t)(void *ref, uint64_t index, int16_t *xyz);
+
+typedef struct
+{
+    uint8_t regs[0x40];
+    uint8_t pointer;
+    int16_t fifo[FFTACQSIM_SLOTS][3];
+    unsigned head, count;
+    int overrun;
+
+    uint32_t busHz;
+    uint64_t nowNs;
+    uint64_t nextSample;
+    fftacqsim_source_t source;
+    void *sourceRef;
+
+    // Counters
+    uint64_t generated;
+    uint64_t dropped;
+} fftacqsim_t;
+
+static inline void fftacqsim_ramp(void *ref, uint64_t index, int16_t *xyz)
+{
+    (void)ref;
+    xyz[0] = (int16_t)(index & 0x0FFF);
+    xyz[1] = (int16_t)(-(int64_t)(index & 0x0FFF));
+    xyz[2] = (int16_t)((1000 + index) & 0x0FFF);
+}
+
+static inline uint64_t fftacqsim_period(const fftacqsim_t *sim)
+{
+    // 3200 Hz = 312.5 us, doubling per rate code step down
+    return 312500ull << (15 - (sim->regs[0x2C] & 0x0F));
+}
+
+static inline void fftacqsim_update(fftacqsim_t *sim)
+{
+    if (!(sim->regs[0x2D] & 0x08))
+    {
+        return;
+    }
+    while (sim->nextSample <= sim->nowNs)
+    {
+        if (sim->count >= FFTACQSIM_SLOTS)
+        {
+            // Stream mode: the oldest sample is lost
+            sim->overrun = 1;
+            sim->dropped++;
+            sim->head = (sim->head + 1) % FFTACQSIM_SLOTS;
+            sim->count--;
+        }
+        sim->source(sim->sourceRef, sim->generated++, sim->fifo[(sim->head + sim->count) % FFTACQSIM_SLOTS]);
+        sim->count++;
+        sim->nextSample += fftacqsim_period(sim);
+    }
+}
+
+static inline void fftacqsim_clock(fftacqsim_t *sim, unsigned bytes, u8 option)
+{
+    unsigned bits = 1 + 9 + 9 * bytes + (option == XIIC_STOP ? 1 : 0);
+    sim->nowNs += (uint64_t)bits * 1000000000u / sim->busHz;
+    fftacqsim_update(sim);
+}
+
+static inline uint8_t fftacqsim_register(const fftacqsim_t *sim, uint8_t reg)
+{
+    if (reg >= 0x32 && reg <= 0x37)
+    {
+        unsigned slot = sim->count > 0 ? sim->head : (sim->head + FFTACQSIM_SLOTS - 1) % FFTACQSIM_SLOTS;
+        uint16_t value = (uint16_t)sim->fifo[slot][(reg - 0x32) / 2];
+        return (reg - 0x32) & 1 ? (uint8_t)(value >> 8) : (uint8_t)value;
+    }
+    if (reg == 0x39)
+    {
+        return (uint8_t)sim->count;
+    }
+    if (reg == 0x30)
+    {
+        return (sim->count > 0 ? 0x80 : 0) | (sim->overrun ? 0x01 : 0);
+    }
+    return sim->regs[reg];
+}
+
+static inline unsigned XIic_Send(UINTPTR base, u8 address, u8 *buffer, unsigned n, u8 option)
+{
+    fftacqsim_t *sim = (fftacqsim_t *)base;
+
+    fftacqsim_clock(sim, n, option);
+    if (address != 0x53 || n == 0)
+    {
+        return 0;
+    }
+
+    sim->pointer = buffer[0] & 0x3F;
+    for (unsigned i = 1; i < n; i++)
+    {
+        uint8_t reg = sim->pointer;
+        if (reg == 0x2D && !(sim->regs[reg] & 0x08) && (buffer[i] & 0x08))
+        {
+            sim->nextSample = sim->nowNs + fftacqsim_period(sim);
+        }
+        if (reg != 0x00 && reg != 0x30 && reg != 0x39 && !(reg >= 0x32 && reg <= 0x37))
+        {
+            sim->regs[reg] = buffer[i];
+        }
+        sim->pointer = (sim->pointer + 1) & 0x3F;
+    }
+    return n;
+}
+
+static inline unsigned XIic_Recv(UINTPTR base, u8 address, u8 *buffer, unsigned n, u8 option)
+{
+    fftacqsim_t *sim = (fftacqsim_t *)base;
+    int touchedData = 0;
+
+    fftacqsim_clock(sim, n, option);
+    if (address != 0x53)
+    {
+        return 0;
+    }
+
+    for (unsigned i = 0; i < n; i++)
+    {
+        buffer[i] = fftacqsim_register(sim, sim->pointer);
+        touchedData |= sim->pointer >= 0x32 && sim->pointer <= 0x37;
+        sim->pointer = (sim->pointer + 1) & 0x3F;
+    }
+
+    // Reading the data registers pops the oldest entry (and clears OVERRUN)
+    if (touchedData && sim->count > 0)
+    {
+        sim->head = (sim->head + 1) % FFTACQSIM_SLOTS;
+        sim->count--;
+        sim->overrun = 0;
+    }
+    return n;
+}
+
+// --- Test hooks ---
+
+static inline void fftacqsim_init(fftacqsim_t *sim, uint32_t busHz)
+{
+    memset(sim, 0, sizeof(*sim));
+    sim->regs[0x00] = 0xE5;
+    sim->regs[0x2C] = 0x0A;         // 100 Hz
+    sim->busHz = busHz;
+    sim->source = fftacqsim_ramp;
+}
+
+// Let time pass with the bus idle (the main loop doing other work)
+static inline void fftacqsim_idle(fftacqsim_t *sim, uint64_t ns)
+{
+    sim->nowNs += ns;
+    fftacqsim_update(sim);
+}
+
+#endif
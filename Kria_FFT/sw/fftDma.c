@@ -0,0 +1,157 @@
+/*
+fftDma.c - Interrupt-driven AXI DMA for the FFT path (see fftDma.h).
+*/
+
+#include "fftDma.h"
+
+#define FFTDMA_RESET_POLLS      1000
+
+static void fftdma_enableIrqs(fftdma_t *fft)
+{
+    u32 mask = XAXIDMA_IRQ_IOC_MASK | XAXIDMA_IRQ_ERROR_MASK;
+
+    XAxiDma_IntrDisable(&fft->dma, XAXIDMA_IRQ_ALL_MASK, XAXIDMA_DMA_TO_DEVICE);
+    XAxiDma_IntrDisable(&fft->dma, XAXIDMA_IRQ_ALL_MASK, XAXIDMA_DEVICE_TO_DMA);
+    XAxiDma_IntrEnable(&fft->dma, mask, XAXIDMA_DMA_TO_DEVICE);
+    XAxiDma_IntrEnable(&fft->dma, mask, XAXIDMA_DEVICE_TO_DMA);
+}
+
+// Reset both channels (also clears DMACR, so interrupts are set up again);
+// a reset that never completes leaves the driver failed for good
+static int fftdma_reset(fftdma_t *fft)
+{
+    int polls = FFTDMA_RESET_POLLS;
+
+    XAxiDma_Reset(&fft->dma);
+    while (!XAxiDma_ResetIsDone(&fft->dma))
+    {
+        if (--polls == 0)
+        {
+            fft->failed = 1;
+            return XST_FAILURE;
+        }
+    }
+
+    fftdma_enableIrqs(fft);
+    fft->resets++;
+    return XST_SUCCESS;
+}
+
+int fftdma_init(fftdma_t *fft, uint32_t deviceId, fftdma_callback_t done, void *ref, uint32_t timeoutTicks)
+{
+    XAxiDma_Config *config = XAxiDma_LookupConfig(deviceId);
+
+    if (config == NULL || XAxiDma_CfgInitialize(&fft->dma, config) != XST_SUCCESS)
+    {
+        return XST_FAILURE;
+    }
+
+    fft->done = done;
+    fft->ref = ref;
+    fft->timeoutTicks = timeoutTicks;
+    fft->slot = -1;
+    fft->started = 0;
+    fft->pending = 0;
+    fft->errorIrq = 0;
+    fft->completed = 0;
+    fft->errors = 0;
+    fft->timeouts = 0;
+    fft->resets = 0;
+    fft->failed = 0;
+
+    fftdma_enableIrqs(fft);
+    return XST_SUCCESS;
+}
+
+int fftdma_start(fftdma_t *fft, int slot, UINTPTR src, UINTPTR dst, uint32_t bytes, uint32_t now)
+{
+    if (fft->failed || fft->slot >= 0)
+    {
+        return XST_FAILURE;
+    }
+
+    fft->slot = slot;
+    fft->started = now;
+    fft->errorIrq = 0;
+    fft->pending = FFTDMA_MM2S | FFTDMA_S2MM;
+
+    // S2MM first, so the result stream has somewhere to go as soon as MM2S starts
+    if (XAxiDma_SimpleTransfer(&fft->dma, dst, bytes, XAXIDMA_DEVICE_TO_DMA) != XST_SUCCESS ||
+        XAxiDma_SimpleTransfer(&fft->dma, src, bytes, XAXIDMA_DMA_TO_DEVICE) != XST_SUCCESS)
+    {
+        fftdma_reset(fft);
+        fft->slot = -1;
+        fft->pending = 0;
+        return XST_FAILURE;
+    }
+
+    return XST_SUCCESS;
+}
+
+int fftdma_service(fftdma_t *fft, uint32_t now)
+{
+    int status;
+    int slot = fft->slot;
+
+    if (slot < 0)
+    {
+        return 0;
+    }
+
+    if (fft->errorIrq != 0)
+    {
+        status = FFTDMA_ERROR;
+        fft->errors++;
+        fftdma_reset(fft);
+    }
+    else if (fft->pending == 0)
+    {
+        status = FFTDMA_OK;
+        fft->completed++;
+    }
+    else if (now - fft->started >= fft->timeoutTicks)
+    {
+        status = FFTDMA_TIMEOUT;
+        fft->timeouts++;
+        fftdma_reset(fft);
+    }
+    else
+    {
+        return 0;
+    }
+
+    fft->slot = -1;
+    fft->pending = 0;
+    if (fft->done != NULL)
+    {
+        fft->done(fft->ref, slot, status);
+    }
+    return 1;
+}
+
+static void fftdma_isr(fftdma_t *fft, int direction, uint32_t channel)
+{
+    u32 irq = XAxiDma_IntrGetIrq(&fft->dma, direction);
+
+    XAxiDma_IntrAckIrq(&fft->dma, irq, direction);
+
+    if (irq & XAXIDMA_IRQ_ERROR_MASK)
+    {
+        // The channel halts; fftdma_service() resets it outside the ISR
+        fft->errorIrq |= channel;
+    }
+    if (irq & XAXIDMA_IRQ_IOC_MASK)
+    {
+        fft->pending &= ~channel;
+    }
+}
+
+void fftdma_mm2sIsr(void *ref)
+{
+    fftdma_isr((fftdma_t *)ref, XAXIDMA_DMA_TO_DEVICE, FFTDMA_MM2S);
+}
+
+void fftdma_s2mmIsr(void *ref)
+{
+    fftdma_isr((fftdma_t *)ref, XAXIDMA_DEVICE_TO_DMA, FFTDMA_S2MM);
+}
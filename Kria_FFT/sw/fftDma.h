@@ -0,0 +1,105 @@
+/*
+fftDma.h - Interrupt-driven AXI DMA for the BRAM -> xfft -> mag_squared -> BRAM path.
+
+Instead of spinning on XAxiDma_Busy() for a whole 1024-point transform, the
+MicroBlaze starts both channels and goes back to acquiring. The MM2S and
+S2MM IOC / error interrupts (AXI INTC inputs 0 and 1) record what happened;
+the main loop calls fftdma_service() whenever convenient, which delivers the
+completion callback outside interrupt context:
+
+    fftdma_init(&fft, DMA_DEV_ID, frameDone, NULL, TIMEOUT);
+    XIntc_RegisterHandler(INTC_BASE, MM2S_INTR_ID, fftdma_mm2sIsr, &fft);
+    XIntc_RegisterHandler(INTC_BASE, S2MM_INTR_ID, fftdma_s2mmIsr, &fft);
+    fftdma_start(&fft, slot, rxAddr, txAddr, FRAME_BYTES, now);
+    while (...) { acquire(); fftdma_service(&fft, now); }
+
+Recovery: a DMA error interrupt, or a transfer still running timeoutTicks
+after it was started (ticks are whatever the caller counts in `now`), resets
+the DMA core, re-enables its interrupts and reports FFTDMA_ERROR /
+FFTDMA_TIMEOUT to the callback, so the frame can be retried or dropped.
+If the core does not come out of the reset, the callback still runs, but
+fftdma_failed() turns true and fftdma_start() refuses every further frame.
+
+Built with FFTDMA_HOST the XAxiDma calls go to fftDmaSim.h, a model that
+completes transfers from a thread after a modelled delay and can inject
+errors and hangs (PC_FftDma_Test.c).
+*/
+
+#ifndef FFTDMA_h
+#define FFTDMA_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef FFTDMA_HOST
+#include "fftDmaSim.h"
+#else
+#include "xaxidma.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Completion status passed to the callback
+#define FFTDMA_OK           0
+#define FFTDMA_ERROR        1       // DMA reported an error (decode / slave / internal)
+#define FFTDMA_TIMEOUT      2       // no completion within timeoutTicks
+
+// Channels still outstanding
+#define FFTDMA_MM2S         0x1
+#define FFTDMA_S2MM         0x2
+
+typedef void (*fftdma_callback_t)(void *ref, int slot, int status);
+
+typedef struct
+{
+    XAxiDma dma;
+    fftdma_callback_t done;
+    void *ref;
+    uint32_t timeoutTicks;
+
+    // Current transfer
+    int slot;                       // -1 when idle
+    uint32_t started;               // `now` at fftdma_start()
+    volatile uint32_t pending;      // FFTDMA_MM2S | FFTDMA_S2MM, cleared by the ISRs
+    volatile uint32_t errorIrq;     // error bits seen by the ISRs
+    int failed;                     // stuck in reset: nothing is started any more
+
+    // Counters
+    uint32_t completed;
+    uint32_t errors;
+    uint32_t timeouts;
+    uint32_t resets;
+} fftdma_t;
+
+int fftdma_init(fftdma_t *fft, uint32_t deviceId, fftdma_callback_t done, void *ref, uint32_t timeoutTicks);
+
+// Start src -> FFT -> dst for one frame; XST_FAILURE if a transfer is still
+// outstanding, the DMA refuses it or the core is stuck in reset
+int fftdma_start(fftdma_t *fft, int slot, UINTPTR src, UINTPTR dst, uint32_t bytes, uint32_t now);
+
+// Deliver a finished transfer (or recover a failed one); returns 1 if the
+// callback ran
+int fftdma_service(fftdma_t *fft, uint32_t now);
+
+static inline int fftdma_busy(const fftdma_t *fft)
+{
+    return fft->slot >= 0;
+}
+
+// A recovery reset timed out; the DMA is unusable until the next power-up
+static inline int fftdma_failed(const fftdma_t *fft)
+{
+    return fft->failed;
+}
+
+// AXI INTC handlers (ref = the fftdma_t)
+void fftdma_mm2sIsr(void *ref);
+void fftdma_s2mmIsr(void *ref);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,297 @@
+/*
+fftDmaSim.h - Host (Linux) stand-in for the AXI DMA + xfft, selected with FFTDMA_HOST.
+
+Provides the XAxiDma calls fftDma.c uses. A model thread plays the DMA and
+the FFT: once both channels are armed it waits the modelled transform time,
+copies the MM2S source to the S2MM destination (the data path itself is not
+modelled here) and raises IOC on MM2S, then S2MM, calling the handlers
+connected with fftdmasim_connect() the way the AXI INTC would.
+
+Timing: the pipelined-streaming xfft at 100 MHz takes about one cycle per
+sample to load, one to unload in natural order and roughly one more of
+pipeline latency, so the default is 3 x 10 ns per 32-bit word (~31 us per
+1024-point frame). nsPerWord scales it.
+
+Faults for testing recovery (each applies to the next transfer only):
+    fftdmasim_inject(&fft.dma, FFTDMASIM_ERROR)     error IRQ, channel halts until reset
+    fftdmasim_inject(&fft.dma, FFTDMASIM_HANG)      never completes (timeout path)
+and for the driver's give-up path (from then on):
+    fftdmasim_inject(&fft.dma, FFTDMASIM_STUCK_RESET)   reset never completes
+A transfer with S2MM not armed also never completes, as the stream stalls.
+*/
+
+#ifndef FFTDMASIM_h
+#define FFTDMASIM_h
+
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#ifndef XST_SUCCESS
+typedef uint32_t u32;
+typedef uintptr_t UINTPTR;
+#define XST_SUCCESS             0
+#define XST_FAILURE             1
+#endif
+
+#define XAXIDMA_DMA_TO_DEVICE   0       // MM2S
+#define XAXIDMA_DEVICE_TO_DMA   1       // S2MM
+#define XAXIDMA_IRQ_IOC_MASK    0x00001000
+#define XAXIDMA_IRQ_DELAY_MASK  0x00002000
+#define XAXIDMA_IRQ_ERROR_MASK  0x00004000
+#define XAXIDMA_IRQ_ALL_MASK    0x00007000
+
+#define FFTDMASIM_NS_PER_WORD   30
+#define FFTDMASIM_ERROR         1
+#define FFTDMASIM_HANG          2
+#define FFTDMASIM_STUCK_RESET   3
+
+typedef struct
+{
+    u32 DeviceId;
+} XAxiDma_Config;
+
+typedef struct
+{
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int running;
+
+    int armed[2];
+    UINTPTR addr[2];
+    u32 length[2];
+    u32 irqEnable[2];
+    u32 irqStatus[2];
+    int halted;
+    int fault;
+    int resetStuck;
+    u32 generation;         // bumped by reset, so a transform in flight is abandoned
+
+    void (*isr[2])(void *ref);
+    void *isrRef[2];
+
+    u32 nsPerWord;
+    u32 transfers;
+} XAxiDma;
+
+static inline void fftdmasim_sleepNs(uint64_t ns)
+{
+    struct timespec ts;
+    ts.tv_sec = (time_t)(ns / 1000000000u);
+    ts.tv_nsec = (long)(ns % 1000000000u);
+    nanosleep(&ts, NULL);
+}
+
+// Raise status bits on a channel and call its handler if they are enabled
+static inline void fftdmasim_raise(XAxiDma *dma, int dir, u32 bits)
+{
+    void (*isr)(void *) = NULL;
+    void *ref = NULL;
+
+    pthread_mutex_lock(&dma->lock);
+    dma->irqStatus[dir] |= bits;
+    if ((dma->irqEnable[dir] & bits) != 0)
+    {
+        isr = dma->isr[dir];
+        ref = dma->isrRef[dir];
+    }
+    pthread_mutex_unlock(&dma->lock);
+
+    if (isr != NULL)
+    {
+        isr(ref);
+    }
+}
+
+static void *fftdmasim_run(void *arg)
+{
+    XAxiDma *dma = (XAxiDma *)arg;
+
+    pthread_mutex_lock(&dma->lock);
+    while (dma->running)
+    {
+        if (!(dma->armed[0] && dma->armed[1]) || dma->halted || dma->fault == FFTDMASIM_HANG)
+        {
+            pthread_cond_wait(&dma->cond, &dma->lock);
+            continue;
+        }
+
+        UINTPTR src = dma->addr[XAXIDMA_DMA_TO_DEVICE];
+        UINTPTR dst = dma->addr[XAXIDMA_DEVICE_TO_DMA];
+        u32 length = dma->length[XAXIDMA_DMA_TO_DEVICE];
+        int fault = dma->fault;
+        u32 generation = dma->generation;
+
+        // The transform runs without the lock, so a reset can cut in
+        pthread_mutex_unlock(&dma->lock);
+        fftdmasim_sleepNs((uint64_t)(length / 4) * dma->nsPerWord);
+        pthread_mutex_lock(&dma->lock);
+
+        if (generation != dma->generation)
+        {
+            continue;       // reset while in flight
+        }
+        dma->fault = 0;
+        dma->transfers++;
+
+        if (fault == FFTDMASIM_ERROR)
+        {
+            dma->halted = 1;
+            pthread_mutex_unlock(&dma->lock);
+            fftdmasim_raise(dma, XAXIDMA_DEVICE_TO_DMA, XAXIDMA_IRQ_ERROR_MASK);
+            pthread_mutex_lock(&dma->lock);
+            continue;
+        }
+
+        if (length > dma->length[XAXIDMA_DEVICE_TO_DMA])
+        {
+            length = dma->length[XAXIDMA_DEVICE_TO_DMA];
+        }
+        memcpy((void *)dst, (const void *)src, length);
+        dma->armed[XAXIDMA_DMA_TO_DEVICE] = 0;
+        dma->armed[XAXIDMA_DEVICE_TO_DMA] = 0;
+
+        pthread_mutex_unlock(&dma->lock);
+        fftdmasim_raise(dma, XAXIDMA_DMA_TO_DEVICE, XAXIDMA_IRQ_IOC_MASK);
+        fftdmasim_raise(dma, XAXIDMA_DEVICE_TO_DMA, XAXIDMA_IRQ_IOC_MASK);
+        pthread_mutex_lock(&dma->lock);
+    }
+    pthread_mutex_unlock(&dma->lock);
+    return NULL;
+}
+
+static inline XAxiDma_Config *XAxiDma_LookupConfig(u32 deviceId)
+{
+    static XAxiDma_Config config;
+    config.DeviceId = deviceId;
+    return &config;
+}
+
+static inline int XAxiDma_CfgInitialize(XAxiDma *dma, XAxiDma_Config *config)
+{
+    (void)config;
+    memset(dma, 0, sizeof(*dma));
+    dma->nsPerWord = FFTDMASIM_NS_PER_WORD;
+    dma->running = 1;
+    pthread_mutex_init(&dma->lock, NULL);
+    pthread_cond_init(&dma->cond, NULL);
+    return pthread_create(&dma->thread, NULL, fftdmasim_run, dma) == 0 ? XST_SUCCESS : XST_FAILURE;
+}
+
+static inline void XAxiDma_IntrEnable(XAxiDma *dma, u32 mask, int dir)
+{
+    pthread_mutex_lock(&dma->lock);
+    dma->irqEnable[dir] |= mask;
+    pthread_mutex_unlock(&dma->lock);
+}
+
+static inline void XAxiDma_IntrDisable(XAxiDma *dma, u32 mask, int dir)
+{
+    pthread_mutex_lock(&dma->lock);
+    dma->irqEnable[dir] &= ~mask;
+    pthread_mutex_unlock(&dma->lock);
+}
+
+static inline u32 XAxiDma_IntrGetIrq(XAxiDma *dma, int dir)
+{
+    pthread_mutex_lock(&dma->lock);
+    u32 irq = dma->irqStatus[dir] & XAXIDMA_IRQ_ALL_MASK;
+    pthread_mutex_unlock(&dma->lock);
+    return irq;
+}
+
+static inline void XAxiDma_IntrAckIrq(XAxiDma *dma, u32 mask, int dir)
+{
+    pthread_mutex_lock(&dma->lock);
+    dma->irqStatus[dir] &= ~mask;
+    pthread_mutex_unlock(&dma->lock);
+}
+
+static inline int XAxiDma_SimpleTransfer(XAxiDma *dma, UINTPTR addr, u32 length, int dir)
+{
+    int status = XST_FAILURE;
+
+    pthread_mutex_lock(&dma->lock);
+    if (!dma->halted && !dma->armed[dir])
+    {
+        dma->addr[dir] = addr;
+        dma->length[dir] = length;
+        dma->armed[dir] = 1;
+        pthread_cond_signal(&dma->cond);
+        status = XST_SUCCESS;
+    }
+    pthread_mutex_unlock(&dma->lock);
+    return status;
+}
+
+static inline int XAxiDma_Busy(XAxiDma *dma, int dir)
+{
+    pthread_mutex_lock(&dma->lock);
+    int busy = dma->armed[dir];
+    pthread_mutex_unlock(&dma->lock);
+    return busy;
+}
+
+// Like the core: stops both channels and clears DMACR (interrupt enables)
+static inline void XAxiDma_Reset(XAxiDma *dma)
+{
+    pthread_mutex_lock(&dma->lock);
+    if (dma->resetStuck)
+    {
+        pthread_mutex_unlock(&dma->lock);
+        return;
+    }
+    dma->armed[0] = dma->armed[1] = 0;
+    dma->irqEnable[0] = dma->irqEnable[1] = 0;
+    dma->irqStatus[0] = dma->irqStatus[1] = 0;
+    dma->halted = 0;
+    dma->fault = 0;
+    dma->generation++;
+    pthread_cond_signal(&dma->cond);
+    pthread_mutex_unlock(&dma->lock);
+}
+
+static inline int XAxiDma_ResetIsDone(XAxiDma *dma)
+{
+    pthread_mutex_lock(&dma->lock);
+    int done = !dma->resetStuck;
+    pthread_mutex_unlock(&dma->lock);
+    return done;
+}
+
+// --- Test hooks ---
+
+static inline void fftdmasim_connect(XAxiDma *dma, int dir, void (*isr)(void *ref), void *ref)
+{
+    pthread_mutex_lock(&dma->lock);
+    dma->isr[dir] = isr;
+    dma->isrRef[dir] = ref;
+    pthread_mutex_unlock(&dma->lock);
+}
+
+static inline void fftdmasim_inject(XAxiDma *dma, int fault)
+{
+    pthread_mutex_lock(&dma->lock);
+    if (fault == FFTDMASIM_STUCK_RESET)
+    {
+        dma->resetStuck = 1;
+    }
+    else
+    {
+        dma->fault = fault;
+    }
+    pthread_mutex_unlock(&dma->lock);
+}
+
+static inline void fftdmasim_shutdown(XAxiDma *dma)
+{
+    pthread_mutex_lock(&dma->lock);
+    dma->running = 0;
+    pthread_cond_signal(&dma->cond);
+    pthread_mutex_unlock(&dma->lock);
+    pthread_join(dma->thread, NULL);
+}
+
+#endif
@@ -0,0 +1,255 @@
+/*
+fftFixed.c - Integer FFT with the arithmetic of the xfft_0 configuration (see fftFixed.h).
+*/
+
+#include <stddef.h>
+#include <math.h>
+#include "fftFixed.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define FFTFIX_PHASE_ONE        (1 << (FFTFIX_PHASE_WIDTH - 1))
+
+int fftfix_init(fftfix_plan_t *plan, int n, fftfix_complex_t *twiddle, uint16_t *bitrev, int rounding)
+{
+    int log2n = 0;
+
+    if (n < 2 || n > FFTFIX_MAX_SIZE || (n & (n - 1)) != 0)
+    {
+        return -1;
+    }
+    while ((1 << log2n) < n)
+    {
+        log2n++;
+    }
+
+    // Q1.15 phase factors: +1.0 does not fit and saturates to 0x7FFF
+    for (int k = 0; k < FFTFIX_TWIDDLES(n); k++)
+    {
+        double angle = -2.0 * M_PI * k / n;
+        long re = lround(cos(angle) * FFTFIX_PHASE_ONE);
+        long im = lround(sin(angle) * FFTFIX_PHASE_ONE);
+        twiddle[k].real = (int32_t)(re >= FFTFIX_PHASE_ONE ? FFTFIX_PHASE_ONE - 1 : re);
+        twiddle[k].imag = (int32_t)(im >= FFTFIX_PHASE_ONE ? FFTFIX_PHASE_ONE - 1 : im);
+    }
+
+    for (int k = 0; k < n; k++)
+    {
+        unsigned r = 0;
+        for (int b = 0; b < log2n; b++)
+        {
+            r |= ((k >> b) & 1u) << (log2n - 1 - b);
+        }
+        bitrev[k] = (uint16_t)r;
+    }
+
+    plan->n = n;
+    plan->log2n = log2n;
+    plan->rounding = rounding;
+    plan->twiddle = twiddle;
+    plan->bitrev = bitrev;
+    return 0;
+}
+
+uint32_t fftfix_conservativeSchedule(const fftfix_plan_t *plan)
+{
+    uint32_t schedule = 0;
+    int stages = fftfix_stages(plan);
+
+    for (int g = 0; g < stages; g++)
+    {
+        int shift = g == 0 ? 3 : 2;
+        if (g == stages - 1 && (plan->log2n & 1))
+        {
+            shift = stages == 1 ? 2 : 1;    // radix-2 stage: 1 bit of growth (+1 if it is also the first)
+        }
+        schedule |= (uint32_t)shift << (2 * g);
+    }
+    return schedule;
+}
+
+// Arithmetic right shift with truncation (floor) or convergent rounding (half to even)
+static inline int64_t fftfix_shift(int64_t v, int bits, int rounding)
+{
+    if (bits <= 0)
+    {
+        return v;
+    }
+
+    int64_t q = v >> bits;
+    if (rounding == FFTFIX_CONVERGENT)
+    {
+        int64_t rem = v & ((1ll << bits) - 1);
+        int64_t half = 1ll << (bits - 1);
+        if (rem > half || (rem == half && (q & 1)))
+        {
+            q++;
+        }
+    }
+    return q;
+}
+
+// Keep the low FFTFIX_INPUT_WIDTH bits as the core's register would; flag a wrap
+static inline int32_t fftfix_wrap(int64_t v, int *overflow)
+{
+    int32_t w = (int32_t)((uint32_t)v << (32 - FFTFIX_INPUT_WIDTH)) >> (32 - FFTFIX_INPUT_WIDTH);
+    if (w != v)
+    {
+        *overflow = 1;
+    }
+    return w;
+}
+
+// (re + i im) * W, each component truncated / rounded once after the full-precision sum
+static inline void fftfix_rotate(int64_t *re, int64_t *im, fftfix_complex_t w, int rounding)
+{
+    int64_t r = *re * w.real - *im * w.imag;
+    int64_t i = *re * w.imag + *im * w.real;
+    *re = fftfix_shift(r, FFTFIX_PHASE_WIDTH - 1, rounding);
+    *im = fftfix_shift(i, FFTFIX_PHASE_WIDTH - 1, rounding);
+}
+
+// Scaling at the end of stage g over the whole frame
+static void fftfix_scale(const fftfix_plan_t *plan, fftfix_complex_t *x, int mode, int shift, int *overflow)
+{
+    if (mode == FFTFIX_UNSCALED)
+    {
+        return;
+    }
+    for (int k = 0; k < plan->n; k++)
+    {
+        x[k].real = fftfix_wrap(fftfix_shift(x[k].real, shift, plan->rounding), overflow);
+        x[k].imag = fftfix_wrap(fftfix_shift(x[k].imag, shift, plan->rounding), overflow);
+    }
+}
+
+// BFP: the smallest shift (up to maxShift) that brings the frame into FFTFIX_INPUT_WIDTH bits
+static int fftfix_bfpShift(const fftfix_plan_t *plan, const fftfix_complex_t *x, int maxShift)
+{
+    const int32_t top = (1 << (FFTFIX_INPUT_WIDTH - 1)) - 1;
+    int32_t hi = 0, lo = 0;
+    int shift = 0;
+
+    for (int k = 0; k < plan->n; k++)
+    {
+        hi = x[k].real > hi ? x[k].real : hi;
+        hi = x[k].imag > hi ? x[k].imag : hi;
+        lo = x[k].real < lo ? x[k].real : lo;
+        lo = x[k].imag < lo ? x[k].imag : lo;
+    }
+    while (shift < maxShift &&
+           (fftfix_shift(hi, shift, plan->rounding) > top || fftfix_shift(lo, shift, plan->rounding) < -top - 1))
+    {
+        shift++;
+    }
+    return shift;
+}
+
+static int fftfix_stageShift(const fftfix_plan_t *plan, const fftfix_complex_t *x, int mode, uint32_t schedule,
+                             int g, int maxShift, int *blockExp)
+{
+    if (mode == FFTFIX_SCALED)
+    {
+        return (schedule >> (2 * g)) & 3;
+    }
+    if (mode == FFTFIX_BFP)
+    {
+        int shift = fftfix_bfpShift(plan, x, maxShift);
+        *blockExp += shift;
+        return shift;
+    }
+    return 0;
+}
+
+int fftfix_execute(const fftfix_plan_t *plan, fftfix_complex_t *x, int mode, uint32_t schedule, int *blockExp)
+{
+    const int n = plan->n;
+    const int rounding = plan->rounding;
+    int overflow = 0;
+    int exponent = 0;
+    int g = 0;
+
+    // Radix-2^2 stages, DIF: blocks of 4m shrinking by 4 each stage
+    for (int m = n / 4; g < plan->log2n / 2; m /= 4, g++)
+    {
+        const int stride = n / (4 * m);     // W^j = twiddle[j * stride]
+
+        for (int base = 0; base < n; base += 4 * m)
+        {
+            fftfix_complex_t *p = x + base;
+
+            for (int j = 0; j < m; j++)
+            {
+                int64_t a0r = p[j].real,         a0i = p[j].imag;
+                int64_t a1r = p[j + m].real,     a1i = p[j + m].imag;
+                int64_t a2r = p[j + 2 * m].real, a2i = p[j + 2 * m].imag;
+                int64_t a3r = p[j + 3 * m].real, a3i = p[j + 3 * m].imag;
+
+                // First butterfly (span 2m), -j on the lower odd output, second butterfly (span m)
+                int64_t s02r = a0r + a2r, s02i = a0i + a2i;
+                int64_t d02r = a0r - a2r, d02i = a0i - a2i;
+                int64_t s13r = a1r + a3r, s13i = a1i + a3i;
+                int64_t d13r = a1r - a3r, d13i = a1i - a3i;
+
+                int64_t y0r = s02r + s13r, y0i = s02i + s13i;
+                int64_t y2r = s02r - s13r, y2i = s02i - s13i;
+                int64_t y1r = d02r + d13i, y1i = d02i - d13r;
+                int64_t y3r = d02r - d13i, y3i = d02i + d13r;
+
+                // Deferred twiddles; W^0 is a pass-through
+                if (j != 0)
+                {
+                    fftfix_rotate(&y2r, &y2i, plan->twiddle[2 * j * stride], rounding);
+                    fftfix_rotate(&y1r, &y1i, plan->twiddle[j * stride], rounding);
+                    fftfix_rotate(&y3r, &y3i, plan->twiddle[3 * j * stride], rounding);
+                }
+
+                p[j].real = (int32_t)y0r;
+                p[j].imag = (int32_t)y0i;
+                p[j + m].real = (int32_t)y2r;
+                p[j + m].imag = (int32_t)y2i;
+                p[j + 2 * m].real = (int32_t)y1r;
+                p[j + 2 * m].imag = (int32_t)y1i;
+                p[j + 3 * m].real = (int32_t)y3r;
+                p[j + 3 * m].imag = (int32_t)y3i;
+            }
+        }
+
+        fftfix_scale(plan, x, mode, fftfix_stageShift(plan, x, mode, schedule, g, 3, &exponent), &overflow);
+    }
+
+    // Odd log2(n): a last radix-2 stage on neighbouring pairs, no twiddles
+    if (plan->log2n & 1)
+    {
+        for (int k = 0; k < n; k += 2)
+        {
+            fftfix_complex_t a = x[k];
+            fftfix_complex_t b = x[k + 1];
+            x[k].real = a.real + b.real;
+            x[k].imag = a.imag + b.imag;
+            x[k + 1].real = a.real - b.real;
+            x[k + 1].imag = a.imag - b.imag;
+        }
+        fftfix_scale(plan, x, mode, fftfix_stageShift(plan, x, mode, schedule, g, 1, &exponent), &overflow);
+    }
+
+    // DIF leaves the bins in bit-reversed order; the core is set to Natural_Order
+    for (int k = 0; k < n; k++)
+    {
+        int r = plan->bitrev[k];
+        if (k < r)
+        {
+            fftfix_complex_t t = x[k];
+            x[k] = x[r];
+            x[r] = t;
+        }
+    }
+
+    if (blockExp != NULL)
+    {
+        *blockExp = exponent;
+    }
+    return overflow;
+}
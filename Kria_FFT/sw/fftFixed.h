@@ -0,0 +1,135 @@
+/*
+fftFixed.h - Integer FFT with the arithmetic of the xfft_0 configuration.
+
+build_complete_system.tcl sets xfft_0 to Pipelined_Streaming_IO, 16-bit
+fixed-point input, 16-bit phase factors, Unscaled, Truncation, natural
+order output. This library does the same transform in integers, so the
+MicroBlaze fallback does not go through soft-float and the PC can produce
+the expected core output for a given input frame.
+
+Data path (per PG109, Pipelined Streaming I/O is a chain of radix-2^2
+stages): for every pair of radix-2 stages, blocks of M = 4m points at
+j, j+m, j+2m, j+3m (j < m) go through
+    1. two radix-2 DIF butterflies at full precision, with the trivial
+       -j rotation between them
+    2. the deferred twiddles W^2j, W^j, W^3j (W = exp(-2*pi*i / M)) on the
+       outputs at j+m, j+2m, j+3m; phase factors are Q1.15,
+       round(2^15 * cos / -sin) saturated to 0x7FFF; each complex product
+       component is summed at full precision and then truncated by 15 bits
+       (or convergent-rounded)
+    3. scaling:
+        FFTFIX_UNSCALED  none; the word grows to 16 + log2(n) + 1 bits
+                         (27 bits for 1024 points)
+        FFTFIX_SCALED    right shift by the stage's 2-bit field of the
+                         schedule (stage 0 in bits [1:0], as SCALE_SCH);
+                         results wrap to 16 bits and set the overflow flag
+        FFTFIX_BFP       the smallest shift (0..3) that keeps the stage in
+                         16 bits, summed into the block exponent
+If log2(n) is odd the last stage is a single radix-2 butterfly without
+twiddles, scaled by its field (0 or 1 is enough). The output is then
+reordered to natural order.
+
+Input and output words use the xfft TDATA layout:
+    input   [31:16] Imag  [15:0] Real                       (16-bit fields)
+    output  Imag / Real, each sign-extended to the next byte boundary:
+            27-bit unscaled -> [63:32] Imag [31:0] Real, 16-bit -> as input
+
+    fftfix_init(&plan, 1024, twiddle, bitrev, FFTFIX_TRUNCATE);
+    fftfix_execute(&plan, x, FFTFIX_UNSCALED, 0, NULL);
+
+The model is written from the documented behaviour, not from the Xilinx
+bit-accurate C model. Compare with the core's output on the board (or
+with xfft_v9_1_bitacc_cmodel) before relying on it to the last bit.
+*/
+
+#ifndef FFTFIXED_h
+#define FFTFIXED_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// xfft_0 configuration (build_complete_system.tcl)
+#define FFTFIX_INPUT_WIDTH      16
+#define FFTFIX_PHASE_WIDTH      16
+#define FFTFIX_MAX_SIZE         16384   // unscaled 16 + 14 + 1 bits fits int32
+
+// Scaling modes
+#define FFTFIX_UNSCALED         0
+#define FFTFIX_SCALED           1
+#define FFTFIX_BFP              2
+
+// Rounding after the twiddle multiply and the scaling shifts
+#define FFTFIX_TRUNCATE         0
+#define FFTFIX_CONVERGENT       1
+
+#define FFTFIX_TWIDDLES(n)      ((n) * 3 / 4 > 0 ? (n) * 3 / 4 : 1)
+
+typedef struct {
+    int32_t real;
+    int32_t imag;
+} fftfix_complex_t;
+
+typedef struct
+{
+    int n;
+    int log2n;
+    int rounding;
+    const fftfix_complex_t *twiddle;    // FFTFIX_TWIDDLES(n) Q1.15 phase factors
+    const uint16_t *bitrev;             // n entries
+} fftfix_plan_t;
+
+// Fill the tables for an n-point transform; returns 0, or -1 if n is not supported
+int fftfix_init(fftfix_plan_t *plan, int n, fftfix_complex_t *twiddle, uint16_t *bitrev, int rounding);
+
+// Forward transform in place. schedule: 2 bits per stage (FFTFIX_SCALED),
+// blockExp: total BFP shift (may be NULL). Returns 1 if a scaled or BFP
+// result wrapped (OVFLO), else 0.
+int fftfix_execute(const fftfix_plan_t *plan, fftfix_complex_t *x, int mode, uint32_t schedule, int *blockExp);
+
+// Radix-2^2 stages (schedule fields) for n points
+static inline int fftfix_stages(const fftfix_plan_t *plan)
+{
+    return (plan->log2n + 1) / 2;
+}
+
+// A schedule that cannot overflow: 3 in the first stage, 2 in the others
+// (1 for a final radix-2 stage); log2(n) + 1 bits in total
+uint32_t fftfix_conservativeSchedule(const fftfix_plan_t *plan);
+
+// Output word width in bits for a mode (27 for 1024-point unscaled)
+static inline int fftfix_outputWidth(const fftfix_plan_t *plan, int mode)
+{
+    return mode == FFTFIX_UNSCALED ? FFTFIX_INPUT_WIDTH + plan->log2n + 1 : FFTFIX_INPUT_WIDTH;
+}
+
+// --- TDATA packing ---
+
+static inline fftfix_complex_t fftfix_unpackInput(uint32_t word)
+{
+    fftfix_complex_t v;
+    v.real = (int16_t)(word & 0xFFFF);
+    v.imag = (int16_t)(word >> 16);
+    return v;
+}
+
+static inline uint32_t fftfix_packInput(fftfix_complex_t v)
+{
+    return (uint32_t)(uint16_t)v.imag << 16 | (uint16_t)v.real;
+}
+
+// Output TDATA: fields of `width` bits sign-extended to whole bytes
+static inline uint64_t fftfix_packOutput(fftfix_complex_t v, int width)
+{
+    int field = (width + 7) / 8 * 8;
+    uint64_t mask = field >= 32 ? 0xFFFFFFFFull : (1ull << field) - 1;
+    return ((uint64_t)(uint32_t)v.imag & mask) << field | ((uint64_t)(uint32_t)v.real & mask);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
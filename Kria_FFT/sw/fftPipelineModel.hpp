@@ -0,0 +1,390 @@
+/*
+fftPipelineModel.hpp - Bit-accurate, cycle-approximate host model of the
+DMA -> xfft_0 -> power_calc_0 (mag_squared.v) -> DMA stream.
+
+Data (bit-accurate for the design in build_complete_system.tcl):
+    MM2S        RX frame words as TDATA ([31:16] Imag, [15:0] Real), TLAST
+                on the last word of the transfer
+    xfft_0      fftFixed.c with the core's configuration; frames are always
+                `points` beats, TLAST only raises event_tlast_unexpected /
+                event_tlast_missing (counted in Stats). m_axis_data_tdata
+                is the byte-aligned Real / Imag pair: 64 bits unscaled
+                (27-bit fields), 32 bits scaled / BFP; TLAST on the last bin
+    wiring      power_calc_0/s_axis_tdata is 32 bits, and IPI connects only
+                the low-order bits of a wider net (BD 41-235). Unscaled, it
+                therefore sees Real[15:0] as "Real" and Real[31:16] as "Imag";
+                the FFT's Imag never arrives
+    mag_squared signed 16 x 16 squares, 32-bit sum wrapping (as the RTL),
+                TVALID / TLAST passed through
+    S2MM        power words into the TX frame up to TLAST
+
+Timing (cycle-approximate, FftPipelineTiming, estimates rather than
+measurements): MM2S / S2MM stream one beat per clock in bursts separated by
+a few idle cycles, the xfft holds a frame for its natural-order reorder
+plus a pipeline delay, at most three frames are inside it (loading,
+processing, unloading; NonRealTime throttling stalls the input beyond
+that), and each frame costs a descriptor fetch. In SIMPLE mode the
+next frame only starts `rearm` cycles after the previous one completed
+(interrupt, service, next SimpleTransfer); in SCATTER_GATHER mode frames
+follow each other as fast as the stream allows.
+
+Streaming:
+    FftPipelineModel model;                         // xfft_0 as configured
+    model.pushTransfer(rx, FFT_SIZE);               // or push(word, last) beat by beat
+    while (model.pop(beat)) { ... }                 // or popTransfer(tx, FFT_SIZE)
+Whole frames:
+    model.processFrame(rx, tx);
+    model.lastXfft();                               // xfft TDATA, for golden vectors
+Sizing:
+    FftPipelineEstimate e = FftPipelineModel::estimate(timing, FFT_SIZE, FftPipelineModel::SIMPLE, 1000);
+
+Host only (std::vector / std::deque); PC_FftPipeline_Model.cpp.
+*/
+
+#ifndef FFTPIPELINEMODEL_h
+#define FFTPIPELINEMODEL_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <deque>
+#include "frameBuffers.h"
+#include "fftFixed.h"
+
+#define FFTPIPELINE_IN_FLIGHT   3       // frames inside xfft_0: loading, processing, unloading
+
+// One AXI-Stream beat leaving power_calc_0
+struct FftStreamBeat
+{
+    uint32_t tdata;
+    bool last;
+};
+
+// Cycle costs at the fabric clock (estimates; adjust to measurements)
+struct FftPipelineTiming
+{
+    double clockHz;             // pl_clk0 (target_clock_frequency of xfft_0)
+    unsigned mm2sBurst;         // beats per AXI read burst (c_mm2s_burst_size)
+    unsigned mm2sBurstGap;      // idle cycles between read bursts (BRAM read via the SmartConnect)
+    unsigned s2mmBurst;
+    unsigned s2mmBurstGap;
+    unsigned xfftPipeline;      // processing delay on top of input and reorder frames
+    unsigned frameSetup;        // descriptor fetch / register start per frame
+    unsigned rearm;             // SIMPLE: IOC interrupt -> fftdma_service -> next SimpleTransfer
+
+    FftPipelineTiming()
+        : clockHz(100e6), mm2sBurst(16), mm2sBurstGap(4), s2mmBurst(16), s2mmBurstGap(2),
+          xfftPipeline(100), frameSetup(40), rearm(3000)
+    {
+    }
+};
+
+struct FftPipelineEstimate
+{
+    double cyclesPerFrame;      // steady state
+    double framesPerSecond;
+    double samplesPerSecond;
+    uint64_t latencyCycles;     // first input beat to last power word of one frame
+};
+
+class FftPipelineModel
+{
+    public:
+
+    enum Mode { SIMPLE, SCATTER_GATHER };
+
+    struct Config
+    {
+        int points;
+        int scaling;            // FFTFIX_UNSCALED (as built), FFTFIX_SCALED, FFTFIX_BFP
+        uint32_t schedule;      // SCALE_SCH for FFTFIX_SCALED
+        int rounding;
+        Mode mode;
+        FftPipelineTiming timing;
+
+        Config()
+            : points(FFT_SIZE), scaling(FFTFIX_UNSCALED), schedule(0), rounding(FFTFIX_TRUNCATE),
+              mode(SCATTER_GATHER)
+        {
+        }
+    };
+
+    struct Stats
+    {
+        uint64_t frames;
+        uint64_t tlastUnexpected;   // TLAST before the last beat of a frame
+        uint64_t tlastMissing;      // no TLAST on the last beat of a frame
+        uint64_t overflows;         // scaled / BFP frames with OVFLO
+    };
+
+    explicit FftPipelineModel(const Config &config = Config())
+        : cfg(config), twiddle(FFTFIX_TWIDDLES(config.points)), bitrev(config.points),
+          frame(config.points), input(config.points), xfft(config.points), fill(0)
+    {
+        valid = fftfix_init(&plan, cfg.points, &twiddle[0], &bitrev[0], cfg.rounding) == 0;
+        reset();
+    }
+
+    bool ok(void) const
+    {
+        return valid;
+    }
+
+    void reset(void)
+    {
+        stat = Stats();
+        fill = 0;
+        output.clear();
+        inEnd = 0;
+        outEnd = 0;
+        for (int i = 0; i < FFTPIPELINE_IN_FLIGHT; i++)
+        {
+            outEndHistory[i] = 0;
+        }
+        firstLatency = 0;
+        timed = 0;
+    }
+
+    // --- Streaming API ---
+
+    // One MM2S beat into xfft_0
+    void push(uint32_t tdata, bool last)
+    {
+        input[fill] = tdata;
+        frame[fill] = fftfix_unpackInput(tdata);
+        fill++;
+
+        if (fill < (size_t)cfg.points)
+        {
+            stat.tlastUnexpected += last;
+            return;
+        }
+        stat.tlastMissing += !last;
+        fill = 0;
+        runFrame();
+    }
+
+    // One DMA transfer: TLAST on the final word
+    void pushTransfer(const uint32_t *words, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            push(words[i], i + 1 == count);
+        }
+    }
+
+    // Power beats waiting for S2MM
+    size_t available(void) const
+    {
+        return output.size();
+    }
+
+    bool pop(FftStreamBeat &beat)
+    {
+        if (output.empty())
+        {
+            return false;
+        }
+        beat = output.front();
+        output.pop_front();
+        return true;
+    }
+
+    // S2MM: words up to and including TLAST (at most max); returns the count
+    size_t popTransfer(uint32_t *words, size_t max)
+    {
+        size_t n = 0;
+        FftStreamBeat beat;
+
+        while (n < max && pop(beat))
+        {
+            words[n++] = beat.tdata;
+            if (beat.last)
+            {
+                break;
+            }
+        }
+        return n;
+    }
+
+    // --- Frame API ---
+
+    void processFrame(const uint32_t *rx, uint32_t *tx)
+    {
+        pushTransfer(rx, cfg.points);
+        popTransfer(tx, cfg.points);
+    }
+
+    // Last frame as seen at each stage (golden vectors)
+    const std::vector<uint32_t> &lastInput(void) const
+    {
+        return input;
+    }
+
+    const std::vector<uint64_t> &lastXfft(void) const
+    {
+        return xfft;
+    }
+
+    // --- Stage models ---
+
+    // Bits per field of m_axis_data_tdata (27 for 1024-point unscaled)
+    int xfftWidth(void) const
+    {
+        return fftfix_outputWidth(&plan, cfg.scaling);
+    }
+
+    // power_calc_0/s_axis_tdata: the low 32 bits of m_axis_data_tdata
+    static uint32_t magInput(uint64_t xfftTdata)
+    {
+        return (uint32_t)xfftTdata;
+    }
+
+    // mag_squared.v: signed 16x16 squares, 32-bit wrapping sum
+    static uint32_t magSquared(uint32_t tdata)
+    {
+        int32_t re = (int16_t)(tdata & 0xFFFF);
+        int32_t im = (int16_t)(tdata >> 16);
+        return (uint32_t)(re * re) + (uint32_t)(im * im);
+    }
+
+    // --- Timing ---
+
+    // Cycle at which the last completed frame's final power word was written
+    uint64_t cycles(void) const
+    {
+        return outEnd;
+    }
+
+    // First frame: first input beat to last power word
+    uint64_t latency(void) const
+    {
+        return firstLatency;
+    }
+
+    const Stats &stats(void) const
+    {
+        return stat;
+    }
+
+    const Config &config(void) const
+    {
+        return cfg;
+    }
+
+    // Beats plus the idle cycles between bursts
+    static uint64_t streamCycles(unsigned beats, unsigned burst, unsigned gap)
+    {
+        return beats + (uint64_t)((beats + burst - 1) / burst - 1) * gap;
+    }
+
+    // Steady-state rate of `frames` back-to-back frames through the timing model
+    static FftPipelineEstimate estimate(const FftPipelineTiming &timing, int points, Mode mode, unsigned frames)
+    {
+        FftPipelineModel::Config config;
+        config.points = points;
+        config.mode = mode;
+        config.timing = timing;
+
+        FftPipelineModel model(config);
+        uint64_t first = 0;
+        for (unsigned k = 0; k < frames; k++)
+        {
+            model.advance();
+            if (k == 0)
+            {
+                first = model.outEnd;
+            }
+        }
+
+        FftPipelineEstimate e;
+        e.cyclesPerFrame = frames > 1 ? (double)(model.outEnd - first) / (frames - 1) : (double)first;
+        e.framesPerSecond = timing.clockHz / e.cyclesPerFrame;
+        e.samplesPerSecond = e.framesPerSecond * points;
+        e.latencyCycles = model.firstLatency;
+        return e;
+    }
+
+    private:
+
+    // xfft_0 -> wiring -> mag_squared for one complete input frame
+    void runFrame(void)
+    {
+        if (fftfix_execute(&plan, &frame[0], cfg.scaling, cfg.schedule, NULL))
+        {
+            stat.overflows++;
+        }
+
+        int width = xfftWidth();
+        for (int k = 0; k < cfg.points; k++)
+        {
+            xfft[k] = fftfix_packOutput(frame[k], width);
+
+            FftStreamBeat beat;
+            beat.tdata = magSquared(magInput(xfft[k]));
+            beat.last = k == cfg.points - 1;
+            output.push_back(beat);
+        }
+
+        stat.frames++;
+        advance();
+    }
+
+    // Frame timing: in = MM2S into the xfft, out = power words through S2MM
+    void advance(void)
+    {
+        const FftPipelineTiming &t = cfg.timing;
+        const unsigned n = (unsigned)cfg.points;
+
+        uint64_t ready = 0;
+        if (cfg.mode == SIMPLE && outEnd > 0)
+        {
+            ready = outEnd + t.rearm;
+        }
+
+        uint64_t inStart = ready + t.frameSetup;
+        if (outEnd > 0 && inEnd + t.frameSetup > inStart)
+        {
+            inStart = inEnd + t.frameSetup;
+        }
+        // Frame k waits for frame k - FFTPIPELINE_IN_FLIGHT to leave the core
+        uint64_t &oldest = outEndHistory[timed++ % FFTPIPELINE_IN_FLIGHT];
+        if (oldest > inStart)
+        {
+            inStart = oldest;
+        }
+        inEnd = inStart + streamCycles(n, t.mm2sBurst, t.mm2sBurstGap);
+
+        uint64_t outStart = inEnd + n + t.xfftPipeline;
+        if (outEnd > outStart)
+        {
+            outStart = outEnd;
+        }
+        outEnd = outStart + streamCycles(n, t.s2mmBurst, t.s2mmBurstGap);
+        oldest = outEnd;
+
+        if (firstLatency == 0)
+        {
+            firstLatency = outEnd - inStart;
+        }
+    }
+
+    Config cfg;
+    bool valid;
+    fftfix_plan_t plan;
+    std::vector<fftfix_complex_t> twiddle;
+    std::vector<uint16_t> bitrev;
+
+    std::vector<fftfix_complex_t> frame;
+    std::vector<uint32_t> input;
+    std::vector<uint64_t> xfft;
+    size_t fill;
+    std::deque<FftStreamBeat> output;
+    Stats stat;
+
+    uint64_t timed;                 // frames through the timing model
+    uint64_t inEnd, outEnd, firstLatency;
+    uint64_t outEndHistory[FFTPIPELINE_IN_FLIGHT];
+};
+
+#endif
@@ -0,0 +1,219 @@
+/*
+fftPlan.c - Iterative in-place software FFT with a precomputed plan (see fftPlan.h).
+*/
+
+#include <math.h>
+#include "fftPlan.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+int fftplan_init(fftplan_t *plan, int n, complex_t *twiddle, uint16_t *bitrev)
+{
+    int log2n = 0;
+
+    if (n < 2 || n > FFTPLAN_MAX_SIZE || (n & (n - 1)) != 0)
+    {
+        return -1;
+    }
+    while ((1 << log2n) < n)
+    {
+        log2n++;
+    }
+
+    // Twiddles in double, once; the transform itself never calls libm
+    for (int k = 0; k < FFTPLAN_TWIDDLES(n); k++)
+    {
+        double angle = -2.0 * M_PI * k / n;
+        twiddle[k].real = (float)cos(angle);
+        twiddle[k].imag = (float)sin(angle);
+    }
+
+    for (int k = 0; k < n; k++)
+    {
+        unsigned r = 0;
+        for (int b = 0; b < log2n; b++)
+        {
+            r |= ((k >> b) & 1u) << (log2n - 1 - b);
+        }
+        bitrev[k] = (uint16_t)r;
+    }
+
+    plan->n = n;
+    plan->log2n = log2n;
+    plan->twiddle = twiddle;
+    plan->bitrev = bitrev;
+    return 0;
+}
+
+static inline complex_t cmul(complex_t a, complex_t w)
+{
+    complex_t r;
+    r.real = a.real * w.real - a.imag * w.imag;
+    r.imag = a.real * w.imag + a.imag * w.real;
+    return r;
+}
+
+void fftplan_execute(const fftplan_t *plan, complex_t *x)
+{
+    const int n = plan->n;
+    const complex_t *tw = plan->twiddle;
+    int m = 1;
+
+    // Bit-reversed input order, so the passes below produce natural order
+    for (int k = 0; k < n; k++)
+    {
+        int r = plan->bitrev[k];
+        if (k < r)
+        {
+            complex_t t = x[k];
+            x[k] = x[r];
+            x[r] = t;
+        }
+    }
+
+    // Odd log2(n): one radix-2 pass (all twiddles 1) before the radix-4 passes
+    if (plan->log2n & 1)
+    {
+        for (int k = 0; k < n; k += 2)
+        {
+            complex_t a = x[k];
+            complex_t b = x[k + 1];
+            x[k].real = a.real + b.real;
+            x[k].imag = a.imag + b.imag;
+            x[k + 1].real = a.real - b.real;
+            x[k + 1].imag = a.imag - b.imag;
+        }
+        m = 2;
+    }
+
+    // Radix-4: blocks of 4m built from four DFTs of size m at j, j+m, j+2m, j+3m.
+    // With W = exp(-2*pi*i / 4m), b0 = a0, b1 = W^2j a1, b2 = W^j a2, b3 = W^3j a3:
+    //   X[j]    = (b0 + b1) +   (b2 + b3)      X[j+2m] = (b0 + b1) -   (b2 + b3)
+    //   X[j+m]  = (b0 - b1) - i (b2 - b3)      X[j+3m] = (b0 - b1) + i (b2 - b3)
+    for (; m < n; m *= 4)
+    {
+        const int stride = n / (4 * m);     // W^j = twiddle[j * stride]
+
+        for (int base = 0; base < n; base += 4 * m)
+        {
+            complex_t *p = x + base;
+
+            for (int j = 0; j < m; j++)
+            {
+                complex_t b0 = p[j];
+                complex_t b1 = p[j + m];
+                complex_t b2 = p[j + 2 * m];
+                complex_t b3 = p[j + 3 * m];
+
+                if (j != 0)
+                {
+                    b1 = cmul(b1, tw[2 * j * stride]);
+                    b2 = cmul(b2, tw[j * stride]);
+                    b3 = cmul(b3, tw[3 * j * stride]);
+                }
+
+                float s0r = b0.real + b1.real, s0i = b0.imag + b1.imag;
+                float d0r = b0.real - b1.real, d0i = b0.imag - b1.imag;
+                float s1r = b2.real + b3.real, s1i = b2.imag + b3.imag;
+                float d1r = b2.real - b3.real, d1i = b2.imag - b3.imag;
+
+                p[j].real = s0r + s1r;
+                p[j].imag = s0i + s1i;
+                p[j + 2 * m].real = s0r - s1r;
+                p[j + 2 * m].imag = s0i - s1i;
+                // -i * (d1r + i d1i) = d1i - i d1r
+                p[j + m].real = d0r + d1i;
+                p[j + m].imag = d0i - d1r;
+                p[j + 3 * m].real = d0r - d1i;
+                p[j + 3 * m].imag = d0i + d1r;
+            }
+        }
+    }
+}
+
+void fftplan_executeTwoReal(const fftplan_t *plan, const float *a, const float *b,
+                            complex_t *work, complex_t *A, complex_t *B)
+{
+    const int n = plan->n;
+
+    for (int k = 0; k < n; k++)
+    {
+        work[k].real = a[k];
+        work[k].imag = b[k];
+    }
+    fftplan_execute(plan, work);
+
+    // Step k reads Z[k] and Z[n-k] (n-k >= n/2), so A can overwrite work
+    for (int k = 0; k <= n / 2; k++)
+    {
+        complex_t z = work[k];
+        complex_t c = work[(n - k) & (n - 1)];
+
+        B[k].real = 0.5f * (z.imag + c.imag);
+        B[k].imag = 0.5f * (c.real - z.real);
+        A[k].real = 0.5f * (z.real + c.real);
+        A[k].imag = 0.5f * (z.imag - c.imag);
+    }
+}
+
+int fftrplan_init(fftrplan_t *plan, int n, complex_t *twiddle, uint16_t *bitrev, complex_t *split)
+{
+    if (n < 4 || fftplan_init(&plan->half, n / 2, twiddle, bitrev) != 0)
+    {
+        return -1;
+    }
+
+    for (int k = 0; k < FFTPLAN_SPLIT(n); k++)
+    {
+        double angle = -2.0 * M_PI * k / n;
+        split[k].real = (float)cos(angle);
+        split[k].imag = (float)sin(angle);
+    }
+
+    plan->n = n;
+    plan->split = split;
+    return 0;
+}
+
+void fftrplan_execute(const fftrplan_t *plan, const float *x, complex_t *X)
+{
+    const int h = plan->n / 2;
+
+    // Even samples as Real, odd samples as Imag
+    if ((const float *)X != x)
+    {
+        for (int m = 0; m < h; m++)
+        {
+            X[m].real = x[2 * m];
+            X[m].imag = x[2 * m + 1];
+        }
+    }
+    fftplan_execute(&plan->half, X);
+
+    // DC and Nyquist are both real: E[0] = Re Z[0], O[0] = Im Z[0]
+    float z0r = X[0].real, z0i = X[0].imag;
+    X[0].real = z0r + z0i;
+    X[0].imag = 0.0f;
+    X[h].real = z0r - z0i;
+    X[h].imag = 0.0f;
+
+    // Bins k and h-k come from the same pair Z[k], Z[h-k]
+    for (int k = 1; k <= h / 2; k++)
+    {
+        complex_t zk = X[k];
+        complex_t zj = X[h - k];
+        complex_t w = plan->split[k];
+
+        float er = 0.5f * (zk.real + zj.real), ei = 0.5f * (zk.imag - zj.imag);
+        float or_ = 0.5f * (zk.imag + zj.imag), oi = 0.5f * (zj.real - zk.real);
+        float tr = w.real * or_ - w.imag * oi;
+        float ti = w.real * oi + w.imag * or_;
+
+        X[k].real = er + tr;
+        X[k].imag = ei + ti;
+        X[h - k].real = er - tr;
+        X[h - k].imag = ti - ei;
+    }
+}
@@ -0,0 +1,108 @@
+/*
+fftPlan.h - Iterative in-place software FFT with a precomputed plan.
+
+The recursive fft() copies both halves into stack arrays at every level and
+calls cos()/sin() for every butterfly. A plan does that work once per size:
+
+    twiddle[k] = exp(-2*pi*i*k / n) for k < 3n/4   (radix-4 needs W^j, W^2j, W^3j)
+    bitrev[k]  = k with its log2(n) bits reversed
+
+and fftplan_execute() then runs in place with no allocation and no libm:
+the input is permuted by bitrev, one radix-2 pass runs if log2(n) is odd,
+and the remaining passes are radix-4 (two radix-2 stages merged, 3 complex
+multiplies per 4 points instead of 4). The result is the same DFT as
+fft(): X[k] = sum x[j] * exp(-2*pi*i*j*k / n), unscaled.
+
+The tables live in caller storage so the MicroBlaze can keep them in a
+static array next to the signal buffer:
+
+    static complex_t twiddle[FFTPLAN_TWIDDLES(SAMPLES_COUNT)];
+    static uint16_t bitrev[SAMPLES_COUNT];
+    fftplan_init(&plan, SAMPLES_COUNT, twiddle, bitrev);
+    fftplan_execute(&plan, signal);             // as often as needed
+
+n must be a power of two between 2 and FFTPLAN_MAX_SIZE.
+
+Real input (accelerometer samples) only needs bins 0..n/2; the rest are
+their conjugates. Two paths avoid the wasted half of a complex transform:
+
+  - fftrplan_execute(): n real samples are read as n/2 complex pairs
+    z[m] = x[2m] + i x[2m+1], transformed with an n/2-point plan and split
+    into X[0..n/2] with the extra table split[k] = exp(-2*pi*i*k / n):
+        E[k] = (Z[k] + conj(Z[n/2-k])) / 2     O[k] = (Z[k] - conj(Z[n/2-k])) / 2i
+        X[k] = E[k] + split[k] O[k]            X[n/2-k] = conj(E[k] - split[k] O[k])
+    The output is n/2+1 bins, so x may be the output buffer itself if it
+    holds n+2 floats (as in main.c).
+
+        static complex_t twiddle[FFTPLAN_TWIDDLES(SAMPLES_COUNT / 2)], split[FFTPLAN_SPLIT(SAMPLES_COUNT)];
+        static uint16_t bitrev[SAMPLES_COUNT / 2];
+        fftrplan_init(&rplan, SAMPLES_COUNT, twiddle, bitrev, split);
+        fftrplan_execute(&rplan, samples, bins);
+
+  - fftplan_executeTwoReal(): two real channels of n samples share one
+    n-point complex transform, z = a + i b, and are separated with
+        A[k] = (Z[k] + conj(Z[n-k])) / 2       B[k] = (Z[k] - conj(Z[n-k])) / 2i
+    for k = 0..n/2 (two axes for the price of one FFT, no extra table).
+*/
+
+#ifndef FFTPLAN_h
+#define FFTPLAN_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FFTPLAN_MAX_SIZE        65536   // bitrev entries are 16-bit
+#define FFTPLAN_TWIDDLES(n)     ((n) * 3 / 4 > 0 ? (n) * 3 / 4 : 1)
+#define FFTPLAN_SPLIT(n)        ((n) / 4 + 1)
+#define FFTPLAN_BINS(n)         ((n) / 2 + 1)   // bins 0..n/2 of a real transform
+
+#ifndef COMPLEX_T_DEFINED
+#define COMPLEX_T_DEFINED
+// Structure for Complex Numbers (same layout as the BRAM result: Real, Imag)
+typedef struct {
+    float real;
+    float imag;
+} complex_t;
+#endif
+
+typedef struct
+{
+    int n;
+    int log2n;
+    const complex_t *twiddle;   // FFTPLAN_TWIDDLES(n) entries
+    const uint16_t *bitrev;     // n entries
+} fftplan_t;
+
+typedef struct
+{
+    int n;                      // real samples in
+    fftplan_t half;             // n/2-point complex plan
+    const complex_t *split;     // FFTPLAN_SPLIT(n) entries
+} fftrplan_t;
+
+// Fill the tables for an n-point transform; returns 0, or -1 if n is not supported
+int fftplan_init(fftplan_t *plan, int n, complex_t *twiddle, uint16_t *bitrev);
+
+// Forward transform of plan->n points, in place
+void fftplan_execute(const fftplan_t *plan, complex_t *x);
+
+// Two real channels of plan->n samples in one complex transform: A and B get
+// FFTPLAN_BINS(n) bins each. work holds n entries; A may be work itself.
+void fftplan_executeTwoReal(const fftplan_t *plan, const float *a, const float *b,
+                            complex_t *work, complex_t *A, complex_t *B);
+
+// Tables for an n-point real transform (n >= 4): twiddle and bitrev for the
+// n/2-point plan, split for the post-processing; returns 0 or -1
+int fftrplan_init(fftrplan_t *plan, int n, complex_t *twiddle, uint16_t *bitrev, complex_t *split);
+
+// n real samples in, FFTPLAN_BINS(n) bins out; x may be (float *)X
+void fftrplan_execute(const fftrplan_t *plan, const float *x, complex_t *X);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
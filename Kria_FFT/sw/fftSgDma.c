@@ -0,0 +1,275 @@
+/*
+fftSgDma.c - Scatter-gather AXI DMA for back-to-back FFT frames (see fftSgDma.h).
+*/
+
+#include "fftSgDma.h"
+
+#define FFTSG_RESET_POLLS       1000
+
+#define FFTSG_LEN_MASK          0x03FFFFFF
+#define FFTSG_CR_RUN            (XAXIDMA_CR_RUNSTOP_MASK | XAXIDMA_IRQ_IOC_MASK | XAXIDMA_IRQ_ERROR_MASK | \
+                                 (1 << XAXIDMA_COALESCE_SHIFT))
+
+// The BDs are written through the BRAM controller, TAILDESC through AXI-Lite:
+// make sure the BD writes have landed before the DMA is told to fetch them
+#if defined(__MICROBLAZE__)
+#define FFTSG_BARRIER()         __asm__ volatile ("mbar 1" ::: "memory")
+#else
+#define FFTSG_BARRIER()         __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+static inline UINTPTR fftsg_bd(UINTPTR ring, int i)
+{
+    return ring + (UINTPTR)i * FFTSG_BD_SIZE;
+}
+
+static inline void fftsg_bdWrite(UINTPTR bd, u32 offset, u32 value)
+{
+    *(volatile u32 *)(bd + offset) = value;
+}
+
+static inline u32 fftsg_bdRead(UINTPTR bd, u32 offset)
+{
+    return *(volatile u32 *)(bd + offset);
+}
+
+static inline u32 fftsg_hi(UINTPTR addr)
+{
+    return (u32)((uint64_t)addr >> 32);
+}
+
+// Write a 64-bit address register pair (the MSB word only exists for > 32-bit addressing)
+static void fftsg_setAddr(fftsg_t *sg, u32 offset, UINTPTR addr)
+{
+    if (sizeof(UINTPTR) > 4)
+    {
+        XAxiDma_WriteReg(sg->regs, offset + 4, fftsg_hi(addr));
+    }
+    XAxiDma_WriteReg(sg->regs, offset, (u32)addr);
+}
+
+// Clear a ring and link its BDs into a circle
+static void fftsg_link(UINTPTR ring, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        UINTPTR bd = fftsg_bd(ring, i);
+        UINTPTR next = fftsg_bd(ring, (i + 1) % count);
+
+        for (u32 offset = 0; offset < FFTSG_BD_SIZE; offset += 4)
+        {
+            fftsg_bdWrite(bd, offset, 0);
+        }
+        fftsg_bdWrite(bd, XAXIDMA_BD_NDESC_OFFSET, (u32)next);
+        fftsg_bdWrite(bd, XAXIDMA_BD_NDESC_MSB_OFFSET, fftsg_hi(next));
+    }
+}
+
+// Reset the core (either channel's reset bit resets both), relink the rings
+// and run both channels with nothing queued
+static int fftsg_restart(fftsg_t *sg)
+{
+    int polls = FFTSG_RESET_POLLS;
+
+    XAxiDma_WriteReg(sg->regs, XAXIDMA_TX_OFFSET + XAXIDMA_CR_OFFSET, XAXIDMA_CR_RESET_MASK);
+    while (XAxiDma_ReadReg(sg->regs, XAXIDMA_TX_OFFSET + XAXIDMA_CR_OFFSET) & XAXIDMA_CR_RESET_MASK)
+    {
+        if (--polls == 0)
+        {
+            return XST_FAILURE;
+        }
+    }
+
+    sg->head = 0;
+    sg->queued = 0;
+    sg->errorIrq = 0;
+
+    fftsg_link(sg->mm2sBd, sg->count);
+    fftsg_link(sg->s2mmBd, sg->count);
+    FFTSG_BARRIER();
+
+    // CURDESC may only be written while the channel is halted
+    fftsg_setAddr(sg, XAXIDMA_TX_OFFSET + XAXIDMA_CDESC_OFFSET, sg->mm2sBd);
+    fftsg_setAddr(sg, XAXIDMA_RX_OFFSET + XAXIDMA_CDESC_OFFSET, sg->s2mmBd);
+    XAxiDma_WriteReg(sg->regs, XAXIDMA_RX_OFFSET + XAXIDMA_CR_OFFSET, FFTSG_CR_RUN);
+    XAxiDma_WriteReg(sg->regs, XAXIDMA_TX_OFFSET + XAXIDMA_CR_OFFSET, FFTSG_CR_RUN);
+
+    return XST_SUCCESS;
+}
+
+int fftsg_init(fftsg_t *sg, UINTPTR regs, UINTPTR mm2sBd, UINTPTR s2mmBd, int count,
+               fftsg_callback_t done, void *ref, uint32_t timeoutTicks)
+{
+    if (count < 1 || count > FFTSG_MAX_BDS ||
+        (mm2sBd % FFTSG_BD_SIZE) != 0 || (s2mmBd % FFTSG_BD_SIZE) != 0)
+    {
+        return XST_FAILURE;
+    }
+
+    sg->regs = regs;
+    sg->mm2sBd = mm2sBd;
+    sg->s2mmBd = s2mmBd;
+    sg->count = count;
+    sg->done = done;
+    sg->ref = ref;
+    sg->timeoutTicks = timeoutTicks;
+    sg->headSince = 0;
+    sg->submitted = 0;
+    sg->completed = 0;
+    sg->errors = 0;
+    sg->timeouts = 0;
+    sg->resets = 0;
+    sg->failed = 0;
+
+    return fftsg_restart(sg);
+}
+
+int fftsg_submit(fftsg_t *sg, int slot, UINTPTR src, UINTPTR dst, uint32_t bytes, uint32_t now)
+{
+    if (sg->failed || sg->queued == sg->count)
+    {
+        return XST_FAILURE;
+    }
+
+    int i = (sg->head + sg->queued) % sg->count;
+    UINTPTR rxBd = fftsg_bd(sg->s2mmBd, i);
+    UINTPTR txBd = fftsg_bd(sg->mm2sBd, i);
+
+    fftsg_bdWrite(rxBd, XAXIDMA_BD_BUFA_OFFSET, (u32)dst);
+    fftsg_bdWrite(rxBd, XAXIDMA_BD_BUFA_MSB_OFFSET, fftsg_hi(dst));
+    fftsg_bdWrite(rxBd, XAXIDMA_BD_CTRL_LEN_OFFSET, bytes & FFTSG_LEN_MASK);
+    fftsg_bdWrite(rxBd, XAXIDMA_BD_STS_OFFSET, 0);
+
+    // One frame = one packet on the stream (TLAST after the last sample)
+    fftsg_bdWrite(txBd, XAXIDMA_BD_BUFA_OFFSET, (u32)src);
+    fftsg_bdWrite(txBd, XAXIDMA_BD_BUFA_MSB_OFFSET, fftsg_hi(src));
+    fftsg_bdWrite(txBd, XAXIDMA_BD_CTRL_LEN_OFFSET,
+                  (bytes & FFTSG_LEN_MASK) | XAXIDMA_BD_CTRL_TXSOF_MASK | XAXIDMA_BD_CTRL_TXEOF_MASK);
+    fftsg_bdWrite(txBd, XAXIDMA_BD_STS_OFFSET, 0);
+
+    sg->slot[i] = slot;
+    if (sg->queued == 0)
+    {
+        sg->headSince = now;
+    }
+    sg->queued++;
+    sg->submitted++;
+
+    // S2MM first, so the result stream always has somewhere to go
+    FFTSG_BARRIER();
+    fftsg_setAddr(sg, XAXIDMA_RX_OFFSET + XAXIDMA_TDESC_OFFSET, rxBd);
+    fftsg_setAddr(sg, XAXIDMA_TX_OFFSET + XAXIDMA_TDESC_OFFSET, txBd);
+
+    return XST_SUCCESS;
+}
+
+// Reset and hand every queued frame back with `status`
+static int fftsg_recover(fftsg_t *sg, int status)
+{
+    int slots[FFTSG_MAX_BDS];
+    int lost = sg->queued;
+
+    for (int n = 0; n < lost; n++)
+    {
+        slots[n] = sg->slot[(sg->head + n) % sg->count];
+    }
+
+    if (fftsg_restart(sg) != XST_SUCCESS)
+    {
+        // Still in reset: the frames go back all the same, nothing new is taken
+        sg->failed = 1;
+        sg->head = 0;
+        sg->queued = 0;
+    }
+    else
+    {
+        sg->resets++;
+    }
+
+    for (int n = 0; n < lost; n++)
+    {
+        if (sg->done != NULL)
+        {
+            sg->done(sg->ref, slots[n], status);
+        }
+    }
+    return lost;
+}
+
+int fftsg_service(fftsg_t *sg, uint32_t now)
+{
+    int calls = 0;
+
+    if (sg->failed)
+    {
+        return 0;
+    }
+
+    if (sg->errorIrq != 0)
+    {
+        sg->errors++;
+        return fftsg_recover(sg, FFTSG_ERROR);
+    }
+
+    while (sg->queued > 0)
+    {
+        int i = sg->head;
+        u32 rxStatus = fftsg_bdRead(fftsg_bd(sg->s2mmBd, i), XAXIDMA_BD_STS_OFFSET);
+        u32 txStatus = fftsg_bdRead(fftsg_bd(sg->mm2sBd, i), XAXIDMA_BD_STS_OFFSET);
+
+        if ((rxStatus & XAXIDMA_BD_STS_COMPLETE_MASK) == 0)
+        {
+            break;
+        }
+        if ((rxStatus | txStatus) & XAXIDMA_BD_STS_ALL_ERR_MASK)
+        {
+            // The channel has halted; its error interrupt may not be in yet
+            sg->errors++;
+            return calls + fftsg_recover(sg, FFTSG_ERROR);
+        }
+
+        int slot = sg->slot[i];
+        sg->head = (i + 1) % sg->count;
+        sg->queued--;
+        sg->headSince = now;
+        sg->completed++;
+
+        if (sg->done != NULL)
+        {
+            sg->done(sg->ref, slot, FFTSG_OK);
+        }
+        calls++;
+    }
+
+    if (sg->queued > 0 && now - sg->headSince >= sg->timeoutTicks)
+    {
+        sg->timeouts++;
+        calls += fftsg_recover(sg, FFTSG_TIMEOUT);
+    }
+
+    return calls;
+}
+
+static void fftsg_isr(fftsg_t *sg, u32 channel)
+{
+    u32 status = XAxiDma_ReadReg(sg->regs, channel + XAXIDMA_SR_OFFSET);
+
+    // Write-1-to-clear the interrupt bits
+    XAxiDma_WriteReg(sg->regs, channel + XAXIDMA_SR_OFFSET, status & XAXIDMA_IRQ_ALL_MASK);
+
+    if (status & XAXIDMA_IRQ_ERROR_MASK)
+    {
+        // The channel halts; fftsg_service() resets it outside the ISR
+        sg->errorIrq = 1;
+    }
+}
+
+void fftsg_mm2sIsr(void *ref)
+{
+    fftsg_isr((fftsg_t *)ref, XAXIDMA_TX_OFFSET);
+}
+
+void fftsg_s2mmIsr(void *ref)
+{
+    fftsg_isr((fftsg_t *)ref, XAXIDMA_RX_OFFSET);
+}
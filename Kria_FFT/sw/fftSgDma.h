@@ -0,0 +1,119 @@
+/*
+fftSgDma.h - Scatter-gather AXI DMA for back-to-back FFT frames.
+
+In simple mode (fftDma.h) the DMA does one frame per SimpleTransfer and the
+FFT idles while the MicroBlaze re-arms it. With scatter-gather the frames
+are queued as buffer descriptors (BDs) in the shared BRAM: one MM2S BD
+(RX frame, SOF | EOF) and one S2MM BD (TX frame) per frame, each channel a
+circular ring of `count` BDs. The driver writes a BD pair and moves
+TAILDESC on; the DMA walks the rings by itself, so as long as frames stay
+queued the xfft sees one frame after the other with no gap.
+
+    fftsg_init(&sg, DMA_BASE, MM2S_BD_ADDR, S2MM_BD_ADDR, FRAME_BUFFERS, frameDone, NULL, TIMEOUT);
+    XIntc_RegisterHandler(INTC_BASE, MM2S_INTR_ID, fftsg_mm2sIsr, &sg);
+    XIntc_RegisterHandler(INTC_BASE, S2MM_INTR_ID, fftsg_s2mmIsr, &sg);
+    while (...) {
+        fftsg_service(&sg, now);            // frameDone(ref, slot, status) per finished frame
+        if (fftsg_free(&sg) > 0) { acquire(slot); fftsg_submit(&sg, slot, rx, tx, FRAME_BYTES, now); }
+    }
+
+Completion is reported per frame, in submit order, when its S2MM BD is
+complete. The S2MM IOC interrupt only wakes the loop; fftsg_service() reads
+the BD status words. A DMA error interrupt, a BD with an error bit, or a
+head frame not finished timeoutTicks after it reached the head of the
+queue resets the core: every queued frame is reported as FFTSG_ERROR or
+FFTSG_TIMEOUT and the rings start again empty. If the core does not come
+out of that reset, the frames are still handed back, fftsg_failed() turns
+true and fftsg_submit() refuses every further frame.
+
+The registers and BDs are driven directly (xaxidma_hw.h layout) rather than
+through the XAxiDma BD ring API, so the same code runs against
+fftSgDmaSim.h when built with FFTSG_HOST (PC_FftSgDma_Test.c). There the
+register base is the address of the model.
+*/
+
+#ifndef FFTSGDMA_h
+#define FFTSGDMA_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef FFTSG_HOST
+#include "fftSgDmaSim.h"
+#else
+#include "xaxidma_hw.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Completion status passed to the callback (same values as fftDma.h)
+#define FFTSG_OK            0
+#define FFTSG_ERROR         1       // DMA error interrupt or BD error bits
+#define FFTSG_TIMEOUT       2       // head frame not done within timeoutTicks
+
+#define FFTSG_MAX_BDS       16
+#define FFTSG_BD_SIZE       0x40    // XAXIDMA_BD_MINIMUM_ALIGNMENT
+
+typedef void (*fftsg_callback_t)(void *ref, int slot, int status);
+
+typedef struct
+{
+    UINTPTR regs;                   // AXI DMA register base
+    UINTPTR mm2sBd;                 // ring of `count` BDs, 64-byte aligned
+    UINTPTR s2mmBd;
+    int count;
+
+    fftsg_callback_t done;
+    void *ref;
+    uint32_t timeoutTicks;
+
+    // Queue: BDs head .. head + queued - 1 belong to the DMA
+    int head;
+    int queued;
+    int slot[FFTSG_MAX_BDS];        // frame slot of each BD pair
+    uint32_t headSince;             // `now` when the head frame became the oldest
+    volatile uint32_t errorIrq;     // set by the ISRs
+    int failed;                     // stuck in reset: nothing is queued any more
+
+    // Counters
+    uint32_t submitted;
+    uint32_t completed;
+    uint32_t errors;
+    uint32_t timeouts;
+    uint32_t resets;
+} fftsg_t;
+
+// Reset the core, link both BD rings and start the channels (nothing queued)
+int fftsg_init(fftsg_t *sg, UINTPTR regs, UINTPTR mm2sBd, UINTPTR s2mmBd, int count,
+               fftsg_callback_t done, void *ref, uint32_t timeoutTicks);
+
+// Queue src -> FFT -> dst for one frame; XST_FAILURE if the rings are full
+// or the core is stuck in reset
+int fftsg_submit(fftsg_t *sg, int slot, UINTPTR src, UINTPTR dst, uint32_t bytes, uint32_t now);
+
+// Report finished frames (or recover from an error / timeout); returns the
+// number of callbacks made
+int fftsg_service(fftsg_t *sg, uint32_t now);
+
+static inline int fftsg_free(const fftsg_t *sg)
+{
+    return sg->count - sg->queued;
+}
+
+// A recovery reset timed out; the DMA is unusable until the next power-up
+static inline int fftsg_failed(const fftsg_t *sg)
+{
+    return sg->failed;
+}
+
+// AXI INTC handlers (ref = the fftsg_t)
+void fftsg_mm2sIsr(void *ref);
+void fftsg_s2mmIsr(void *ref);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
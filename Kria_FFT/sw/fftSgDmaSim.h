@@ -0,0 +1,564 @@
+/*
+fftSgDmaSim.h - Host (Linux) model of the scatter-gather AXI DMA + xfft, selected with FFTSG_HOST.
+
+The register base handed to fftsg_init() is the address of an fftsgsim_t;
+XAxiDma_ReadReg / XAxiDma_WriteReg below decode the AXI DMA register map
+(DMACR, DMASR, CURDESC, TAILDESC per channel, xaxidma_hw.h offsets). A
+model thread walks the BD rings the way the core does: fetch the BD at the
+channel's current pointer, follow NXTDESC, stop after the BD TAILDESC
+points at, and resume when TAILDESC is moved on.
+
+Timing models the pipelined-streaming xfft at 100 MHz: a frame's samples
+enter at one per nsPerWord (10 ns) and its result leaves latencyNs later
+(about two frame lengths); both can be scaled up for hosts whose thread
+wake-ups are too coarse for 10 us frames. A frame whose BDs were handed
+over before the previous frame had been loaded follows it with no gap, so a full ring streams at one
+frame per N words; a frame that finds the pipeline empty pays the latency
+again (counted in `refills`). Results are copied MM2S source -> S2MM
+destination; the data path itself is not modelled.
+
+Descriptor checks, each reported like the core would (SGIntErr, channel
+halted, error interrupt) and counted in `bdErrors`:
+    - BD not 64-byte aligned
+    - BD fetched with its Cmplt bit still set (not recycled by the driver)
+    - MM2S BD without SOF and EOF, zero length, or S2MM BD shorter than the frame
+    - BD address or length changed while the DMA owns it
+Faults for testing recovery (next frame only):
+    fftsgsim_inject(&sim, FFTSGSIM_ERROR)     slave error on S2MM, channel halts
+    fftsgsim_inject(&sim, FFTSGSIM_HANG)      result never arrives (timeout path)
+and for the driver's give-up path (from then on):
+    fftsgsim_inject(&sim, FFTSGSIM_STUCK_RESET)  DMACR.Reset never clears
+*/
+
+#ifndef FFTSGDMASIM_h
+#define FFTSGDMASIM_h
+
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#ifndef XST_SUCCESS
+typedef uint32_t u32;
+typedef uintptr_t UINTPTR;
+#define XST_SUCCESS                     0
+#define XST_FAILURE                     1
+#endif
+
+// Register map (xaxidma_hw.h)
+#define XAXIDMA_TX_OFFSET               0x00
+#define XAXIDMA_RX_OFFSET               0x30
+#define XAXIDMA_CR_OFFSET               0x00
+#define XAXIDMA_SR_OFFSET               0x04
+#define XAXIDMA_CDESC_OFFSET            0x08
+#define XAXIDMA_CDESC_MSB_OFFSET        0x0C
+#define XAXIDMA_TDESC_OFFSET            0x10
+#define XAXIDMA_TDESC_MSB_OFFSET        0x14
+
+#define XAXIDMA_CR_RUNSTOP_MASK         0x00000001
+#define XAXIDMA_CR_RESET_MASK           0x00000004
+#define XAXIDMA_COALESCE_SHIFT          16
+#define XAXIDMA_HALTED_MASK             0x00000001
+#define XAXIDMA_IDLE_MASK               0x00000002
+#define XAXIDMA_ERR_INTERNAL_MASK       0x00000010
+#define XAXIDMA_ERR_SLAVE_MASK          0x00000020
+#define XAXIDMA_ERR_SG_INT_MASK         0x00000100
+#define XAXIDMA_IRQ_IOC_MASK            0x00001000
+#define XAXIDMA_IRQ_DELAY_MASK          0x00002000
+#define XAXIDMA_IRQ_ERROR_MASK          0x00004000
+#define XAXIDMA_IRQ_ALL_MASK            0x00007000
+
+// Buffer descriptor (xaxidma_hw.h)
+#define XAXIDMA_BD_NDESC_OFFSET         0x00
+#define XAXIDMA_BD_NDESC_MSB_OFFSET     0x04
+#define XAXIDMA_BD_BUFA_OFFSET          0x08
+#define XAXIDMA_BD_BUFA_MSB_OFFSET      0x0C
+#define XAXIDMA_BD_CTRL_LEN_OFFSET      0x18
+#define XAXIDMA_BD_STS_OFFSET           0x1C
+#define XAXIDMA_BD_CTRL_TXSOF_MASK      0x08000000
+#define XAXIDMA_BD_CTRL_TXEOF_MASK      0x04000000
+#define XAXIDMA_BD_STS_COMPLETE_MASK    0x80000000
+#define XAXIDMA_BD_STS_SLV_ERR_MASK     0x20000000
+#define XAXIDMA_BD_STS_ALL_ERR_MASK     0x70000000
+#define XAXIDMA_BD_STS_RXSOF_MASK       0x08000000
+#define XAXIDMA_BD_STS_RXEOF_MASK       0x04000000
+
+#define FFTSGSIM_LEN_MASK               0x03FFFFFF
+#define FFTSGSIM_NS_PER_WORD            10
+#define FFTSGSIM_LATENCY_NS             20480
+#define FFTSGSIM_PIPE                   8       // frames in flight inside the model
+#define FFTSGSIM_STAMPS                 16      // BDs handed over but not yet fetched
+#define FFTSGSIM_RING_MAX               256     // longest NXTDESC walk to a tail
+#define FFTSGSIM_ERROR                  1
+#define FFTSGSIM_HANG                   2
+#define FFTSGSIM_STUCK_RESET            3
+
+typedef struct
+{
+    u32 cr;
+    u32 sr;
+    u32 cdescMsb;
+    u32 tdescMsb;
+    UINTPTR curdesc;
+    UINTPTR tail;
+    UINTPTR fetch;          // next BD to fetch
+    UINTPTR covered;        // last BD handed over by a TAILDESC write (0 = none)
+    u32 pending;            // BDs handed over but not yet fetched
+
+    // When each handed-over BD became available, so a late model thread
+    // still starts frames at the time the hardware would have
+    UINTPTR stampBd[FFTSGSIM_STAMPS];
+    uint64_t stampAt[FFTSGSIM_STAMPS];
+    int stampHead, stampCount;
+} fftsgsim_channel_t;
+
+typedef struct
+{
+    UINTPTR txBd, rxBd;
+    UINTPTR src, dst;
+    u32 length;
+    uint64_t mm2sAt, s2mmAt;
+    int mm2sDone;
+    int fault;
+} fftsgsim_frame_t;
+
+typedef struct
+{
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int running;
+
+    fftsgsim_channel_t ch[2];       // 0 = MM2S, 1 = S2MM
+    fftsgsim_frame_t pipe[FFTSGSIM_PIPE];
+    int pipeHead, pipeCount;
+    uint64_t loadEnd;               // when the FFT input is free again
+    int fault;
+    int stalled;
+    int resetStuck;
+
+    void (*isr[2])(void *ref);
+    void *isrRef[2];
+
+    u32 nsPerWord;
+    u32 latencyNs;
+
+    // Counters
+    u32 frames;
+    u32 refills;
+    u32 bdErrors;
+} fftsgsim_t;
+
+static inline uint64_t fftsgsim_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static inline u32 fftsgsim_bd(UINTPTR bd, u32 offset)
+{
+    return *(volatile u32 *)(bd + offset);
+}
+
+static inline void fftsgsim_setBd(UINTPTR bd, u32 offset, u32 value)
+{
+    *(volatile u32 *)(bd + offset) = value;
+}
+
+static inline UINTPTR fftsgsim_addr(UINTPTR bd, u32 offset)
+{
+    uint64_t addr = ((uint64_t)fftsgsim_bd(bd, offset + 4) << 32) | fftsgsim_bd(bd, offset);
+    return (UINTPTR)addr;
+}
+
+// Called with the lock held; drops it around the handler like an interrupt would
+static void fftsgsim_raise(fftsgsim_t *sim, int dir, u32 bits)
+{
+    sim->ch[dir].sr |= bits;
+    if ((sim->ch[dir].cr & bits) != 0 && sim->isr[dir] != NULL)
+    {
+        void (*isr)(void *) = sim->isr[dir];
+        void *ref = sim->isrRef[dir];
+        pthread_mutex_unlock(&sim->lock);
+        isr(ref);
+        pthread_mutex_lock(&sim->lock);
+    }
+}
+
+// DMA error: the core halts the channel and raises its error interrupt
+static void fftsgsim_halt(fftsgsim_t *sim, int dir, u32 srBits)
+{
+    sim->ch[dir].cr &= ~XAXIDMA_CR_RUNSTOP_MASK;
+    sim->ch[dir].sr |= XAXIDMA_HALTED_MASK | srBits;
+    sim->pipeCount = 0;
+    sim->stalled = 1;
+    fftsgsim_raise(sim, dir, XAXIDMA_IRQ_ERROR_MASK);
+}
+
+// Descriptor the driver got wrong
+static void fftsgsim_bdError(fftsgsim_t *sim, int dir, u32 srBits)
+{
+    sim->bdErrors++;
+    fftsgsim_halt(sim, dir, srBits);
+}
+
+// TAILDESC moved on: every BD up to the new tail is available from now.
+// Counted rather than compared with the last fetched BD, so a tail that
+// comes round to that BD again (the whole ring refilled) is still work.
+static void fftsgsim_handOver(fftsgsim_channel_t *ch, uint64_t now)
+{
+    UINTPTR bd = ch->covered != 0 ? fftsgsim_addr(ch->covered, XAXIDMA_BD_NDESC_OFFSET) : ch->fetch;
+
+    for (int walked = 0; walked < FFTSGSIM_RING_MAX; walked++)
+    {
+        if (ch->stampCount < FFTSGSIM_STAMPS)
+        {
+            int n = (ch->stampHead + ch->stampCount) % FFTSGSIM_STAMPS;
+            ch->stampBd[n] = bd;
+            ch->stampAt[n] = now;
+            ch->stampCount++;
+        }
+        ch->pending++;
+        if (bd == ch->tail)
+        {
+            break;
+        }
+        bd = fftsgsim_addr(bd, XAXIDMA_BD_NDESC_OFFSET);
+    }
+    ch->covered = ch->tail;
+}
+
+static uint64_t fftsgsim_availableAt(fftsgsim_channel_t *ch, UINTPTR bd, uint64_t now)
+{
+    while (ch->stampCount > 0)
+    {
+        int n = ch->stampHead;
+        ch->stampHead = (n + 1) % FFTSGSIM_STAMPS;
+        ch->stampCount--;
+        if (ch->stampBd[n] == bd)
+        {
+            return ch->stampAt[n];
+        }
+    }
+    return now;
+}
+
+static int fftsgsim_hasWork(const fftsgsim_channel_t *ch)
+{
+    return (ch->cr & XAXIDMA_CR_RUNSTOP_MASK) && !(ch->sr & XAXIDMA_HALTED_MASK) &&
+           ch->pending > 0;
+}
+
+// Fetch the next BD pair into the pipeline; 0 if a BD was rejected
+static int fftsgsim_load(fftsgsim_t *sim, uint64_t now)
+{
+    fftsgsim_channel_t *tx = &sim->ch[0];
+    fftsgsim_channel_t *rx = &sim->ch[1];
+    UINTPTR txBd = tx->fetch;
+    UINTPTR rxBd = rx->fetch;
+
+    for (int dir = 0; dir < 2; dir++)
+    {
+        UINTPTR bd = dir == 0 ? txBd : rxBd;
+        if ((bd % 0x40) != 0 || (fftsgsim_bd(bd, XAXIDMA_BD_STS_OFFSET) & XAXIDMA_BD_STS_COMPLETE_MASK))
+        {
+            fftsgsim_bdError(sim, dir, XAXIDMA_ERR_SG_INT_MASK);
+            return 0;
+        }
+    }
+
+    u32 txCtrl = fftsgsim_bd(txBd, XAXIDMA_BD_CTRL_LEN_OFFSET);
+    u32 rxCtrl = fftsgsim_bd(rxBd, XAXIDMA_BD_CTRL_LEN_OFFSET);
+    u32 length = txCtrl & FFTSGSIM_LEN_MASK;
+    u32 sofEof = XAXIDMA_BD_CTRL_TXSOF_MASK | XAXIDMA_BD_CTRL_TXEOF_MASK;
+
+    if ((txCtrl & sofEof) != sofEof || length == 0)
+    {
+        fftsgsim_bdError(sim, 0, XAXIDMA_ERR_INTERNAL_MASK);
+        return 0;
+    }
+    if ((rxCtrl & FFTSGSIM_LEN_MASK) < length)
+    {
+        fftsgsim_bdError(sim, 1, XAXIDMA_ERR_INTERNAL_MASK);
+        return 0;
+    }
+
+    fftsgsim_frame_t *f = &sim->pipe[(sim->pipeHead + sim->pipeCount) % FFTSGSIM_PIPE];
+    f->txBd = txBd;
+    f->rxBd = rxBd;
+    f->src = fftsgsim_addr(txBd, XAXIDMA_BD_BUFA_OFFSET);
+    f->dst = fftsgsim_addr(rxBd, XAXIDMA_BD_BUFA_OFFSET);
+    f->length = length;
+    f->fault = sim->fault;
+    f->mm2sDone = 0;
+    sim->fault = 0;
+
+    // Back-to-back if the frame was queued before the previous one had loaded
+    uint64_t txAt = fftsgsim_availableAt(tx, txBd, now);
+    uint64_t rxAt = fftsgsim_availableAt(rx, rxBd, now);
+    uint64_t start = sim->loadEnd;
+    if (txAt > start || rxAt > start)
+    {
+        start = txAt > rxAt ? txAt : rxAt;
+        sim->refills++;
+    }
+    sim->loadEnd = start + (uint64_t)(length / 4) * sim->nsPerWord;
+    f->mm2sAt = sim->loadEnd;
+    f->s2mmAt = sim->loadEnd + sim->latencyNs;
+    sim->pipeCount++;
+
+    tx->pending--;
+    rx->pending--;
+    tx->fetch = fftsgsim_addr(txBd, XAXIDMA_BD_NDESC_OFFSET);
+    rx->fetch = fftsgsim_addr(rxBd, XAXIDMA_BD_NDESC_OFFSET);
+    return 1;
+}
+
+// The driver must leave a BD alone from TAILDESC until it sees Cmplt
+static int fftsgsim_unchanged(const fftsgsim_frame_t *f)
+{
+    return fftsgsim_addr(f->txBd, XAXIDMA_BD_BUFA_OFFSET) == f->src &&
+           fftsgsim_addr(f->rxBd, XAXIDMA_BD_BUFA_OFFSET) == f->dst &&
+           (fftsgsim_bd(f->txBd, XAXIDMA_BD_CTRL_LEN_OFFSET) & FFTSGSIM_LEN_MASK) == f->length;
+}
+
+static void *fftsgsim_run(void *arg)
+{
+    fftsgsim_t *sim = (fftsgsim_t *)arg;
+
+    pthread_mutex_lock(&sim->lock);
+    while (sim->running)
+    {
+        uint64_t now = fftsgsim_now();
+        uint64_t wake = UINT64_MAX;
+        int progressed = 0;
+
+        if (sim->stalled)
+        {
+            pthread_cond_wait(&sim->cond, &sim->lock);
+            continue;
+        }
+
+        // Start loading the next frame once the input side is free
+        int inputBusy = sim->pipeCount > 0 && !sim->pipe[(sim->pipeHead + sim->pipeCount - 1) % FFTSGSIM_PIPE].mm2sDone;
+        if (!inputBusy && sim->pipeCount < FFTSGSIM_PIPE &&
+            fftsgsim_hasWork(&sim->ch[0]) && fftsgsim_hasWork(&sim->ch[1]))
+        {
+            if (!fftsgsim_load(sim, now))
+            {
+                continue;
+            }
+            progressed = 1;
+        }
+
+        for (int n = 0; n < sim->pipeCount && !sim->stalled; n++)
+        {
+            fftsgsim_frame_t *f = &sim->pipe[(sim->pipeHead + n) % FFTSGSIM_PIPE];
+
+            if (!f->mm2sDone)
+            {
+                if (now < f->mm2sAt)
+                {
+                    wake = wake < f->mm2sAt ? wake : f->mm2sAt;
+                    break;
+                }
+                f->mm2sDone = 1;
+                progressed = 1;
+                fftsgsim_setBd(f->txBd, XAXIDMA_BD_STS_OFFSET, XAXIDMA_BD_STS_COMPLETE_MASK | f->length);
+                fftsgsim_raise(sim, 0, XAXIDMA_IRQ_IOC_MASK);
+            }
+        }
+
+        if (sim->pipeCount > 0 && !sim->stalled)
+        {
+            fftsgsim_frame_t *f = &sim->pipe[sim->pipeHead];
+
+            if (f->fault == FFTSGSIM_HANG)
+            {
+                // Result stream stalls: nothing more completes until a reset
+                sim->stalled = 1;
+                continue;
+            }
+            if (f->mm2sDone && now >= f->s2mmAt)
+            {
+                progressed = 1;
+                if (!fftsgsim_unchanged(f))
+                {
+                    fftsgsim_bdError(sim, 1, XAXIDMA_ERR_SG_INT_MASK);
+                    continue;
+                }
+                if (f->fault == FFTSGSIM_ERROR)
+                {
+                    fftsgsim_setBd(f->rxBd, XAXIDMA_BD_STS_OFFSET, XAXIDMA_BD_STS_SLV_ERR_MASK);
+                    fftsgsim_halt(sim, 1, XAXIDMA_ERR_SLAVE_MASK);
+                    continue;
+                }
+
+                memcpy((void *)f->dst, (const void *)f->src, f->length);
+                fftsgsim_setBd(f->rxBd, XAXIDMA_BD_STS_OFFSET,
+                               XAXIDMA_BD_STS_COMPLETE_MASK | XAXIDMA_BD_STS_RXSOF_MASK |
+                               XAXIDMA_BD_STS_RXEOF_MASK | f->length);
+                sim->pipeHead = (sim->pipeHead + 1) % FFTSGSIM_PIPE;
+                sim->pipeCount--;
+                sim->frames++;
+                fftsgsim_raise(sim, 1, XAXIDMA_IRQ_IOC_MASK);
+            }
+            else if (f->mm2sDone)
+            {
+                wake = wake < f->s2mmAt ? wake : f->s2mmAt;
+            }
+        }
+
+        if (progressed)
+        {
+            continue;
+        }
+        if (wake == UINT64_MAX)
+        {
+            pthread_cond_wait(&sim->cond, &sim->lock);
+        }
+        else
+        {
+            struct timespec ts;
+            ts.tv_sec = (time_t)(wake / 1000000000u);
+            ts.tv_nsec = (long)(wake % 1000000000u);
+            pthread_cond_timedwait(&sim->cond, &sim->lock, &ts);
+        }
+    }
+    pthread_mutex_unlock(&sim->lock);
+    return NULL;
+}
+
+static inline void fftsgsim_reset(fftsgsim_t *sim)
+{
+    memset(sim->ch, 0, sizeof(sim->ch));
+    sim->ch[0].sr = sim->ch[1].sr = XAXIDMA_HALTED_MASK;
+    sim->pipeCount = 0;
+    sim->fault = 0;
+    sim->stalled = 0;
+}
+
+static inline u32 XAxiDma_ReadReg(UINTPTR base, u32 offset)
+{
+    fftsgsim_t *sim = (fftsgsim_t *)base;
+    fftsgsim_channel_t *ch = &sim->ch[offset >= XAXIDMA_RX_OFFSET];
+    u32 value = 0;
+
+    pthread_mutex_lock(&sim->lock);
+    switch (offset % XAXIDMA_RX_OFFSET)
+    {
+    case XAXIDMA_CR_OFFSET:         value = ch->cr; break;
+    case XAXIDMA_SR_OFFSET:         value = ch->sr; break;
+    case XAXIDMA_CDESC_OFFSET:      value = (u32)ch->curdesc; break;
+    case XAXIDMA_TDESC_OFFSET:      value = (u32)ch->tail; break;
+    }
+    pthread_mutex_unlock(&sim->lock);
+    return value;
+}
+
+static inline void XAxiDma_WriteReg(UINTPTR base, u32 offset, u32 value)
+{
+    fftsgsim_t *sim = (fftsgsim_t *)base;
+    fftsgsim_channel_t *ch = &sim->ch[offset >= XAXIDMA_RX_OFFSET];
+
+    pthread_mutex_lock(&sim->lock);
+    switch (offset % XAXIDMA_RX_OFFSET)
+    {
+    case XAXIDMA_CR_OFFSET:
+        if ((value & XAXIDMA_CR_RESET_MASK) && sim->resetStuck)
+        {
+            ch->cr |= XAXIDMA_CR_RESET_MASK;
+        }
+        else if (value & XAXIDMA_CR_RESET_MASK)
+        {
+            fftsgsim_reset(sim);        // resets both channels, done at once
+        }
+        else
+        {
+            if ((value & XAXIDMA_CR_RUNSTOP_MASK) && !(ch->cr & XAXIDMA_CR_RUNSTOP_MASK))
+            {
+                ch->sr &= ~XAXIDMA_HALTED_MASK;
+                ch->fetch = ch->curdesc;
+                ch->pending = 0;
+                ch->covered = 0;
+                ch->stampCount = 0;
+            }
+            ch->cr = value;
+        }
+        break;
+    case XAXIDMA_SR_OFFSET:
+        ch->sr &= ~(value & XAXIDMA_IRQ_ALL_MASK);
+        break;
+    case XAXIDMA_CDESC_MSB_OFFSET:
+        ch->cdescMsb = value;
+        break;
+    case XAXIDMA_CDESC_OFFSET:
+        if (!(ch->cr & XAXIDMA_CR_RUNSTOP_MASK))
+        {
+            ch->curdesc = (UINTPTR)(((uint64_t)ch->cdescMsb << 32) | value);
+        }
+        break;
+    case XAXIDMA_TDESC_MSB_OFFSET:
+        ch->tdescMsb = value;
+        break;
+    case XAXIDMA_TDESC_OFFSET:
+        ch->tail = (UINTPTR)(((uint64_t)ch->tdescMsb << 32) | value);
+        fftsgsim_handOver(ch, fftsgsim_now());
+        break;
+    }
+    pthread_cond_signal(&sim->cond);
+    pthread_mutex_unlock(&sim->lock);
+}
+
+// --- Test hooks ---
+
+static inline int fftsgsim_init(fftsgsim_t *sim)
+{
+    pthread_condattr_t attr;
+
+    memset(sim, 0, sizeof(*sim));
+    fftsgsim_reset(sim);
+    sim->nsPerWord = FFTSGSIM_NS_PER_WORD;
+    sim->latencyNs = FFTSGSIM_LATENCY_NS;
+    sim->running = 1;
+    pthread_mutex_init(&sim->lock, NULL);
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&sim->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    return pthread_create(&sim->thread, NULL, fftsgsim_run, sim) == 0 ? XST_SUCCESS : XST_FAILURE;
+}
+
+static inline void fftsgsim_connect(fftsgsim_t *sim, int dir, void (*isr)(void *ref), void *ref)
+{
+    pthread_mutex_lock(&sim->lock);
+    sim->isr[dir] = isr;
+    sim->isrRef[dir] = ref;
+    pthread_mutex_unlock(&sim->lock);
+}
+
+static inline void fftsgsim_inject(fftsgsim_t *sim, int fault)
+{
+    pthread_mutex_lock(&sim->lock);
+    if (fault == FFTSGSIM_STUCK_RESET)
+    {
+        sim->resetStuck = 1;
+    }
+    else
+    {
+        sim->fault = fault;
+    }
+    pthread_mutex_unlock(&sim->lock);
+}
+
+static inline void fftsgsim_shutdown(fftsgsim_t *sim)
+{
+    pthread_mutex_lock(&sim->lock);
+    sim->running = 0;
+    pthread_cond_signal(&sim->cond);
+    pthread_mutex_unlock(&sim->lock);
+    pthread_join(sim->thread, NULL);
+}
+
+#endif
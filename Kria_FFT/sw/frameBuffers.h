@@ -0,0 +1,63 @@
+/*
+frameBuffers.h - N-deep frame buffering in the shared BRAM (MicroBlaze + PS).
+
+Each of FRAME_BUFFERS slots has an RX region (time samples, DMA MM2S source),
+a TX region (power spectrum, DMA S2MM destination) and a state word that
+says who owns the slot. Slots are used in order 0, 1, .., N - 1, 0, ...
+
+    FRAME_FREE        MicroBlaze    fill RX with samples
+    FRAME_PROCESSING  DMA / FFT     RX -> xfft -> mag_squared -> TX
+    FRAME_READY       PS            read TX, then hand the slot back as FREE
+    FRAME_DROPPED     PS            the DMA failed on this frame: skip it and
+                                    hand the slot back as FREE
+
+A dropped frame keeps its place in the slot order, so the PS, which reads
+slots strictly in order, neither stalls on it nor takes later frames early.
+Only the owner writes a slot's state, and writing the next state is what
+hands it over, so plain 32-bit BRAM writes are enough (no read-modify-write).
+With N >= 3 the MicroBlaze fills frame k + 1 while the DMA processes frame k
+and the PS consumes frame k - 1; a stage that has nothing to do waits on the
+state word of its next slot.
+
+Layout (offsets from the BRAM base as each processor sees it; the BRAM is
+mapped 64 KB wide by build_complete_system.tcl):
+    0x0000  RX[0..N-1]      FRAME_BYTES each
+    0x4000  TX[0..N-1]      FRAME_BYTES each
+    0x8000  control         state[N], frame number[N]
+    0x9000  MM2S BD ring    N x 64 bytes (scatter-gather DMA, fftSgDma.h)
+    0x9400  S2MM BD ring    N x 64 bytes
+*/
+
+#ifndef FRAMEBUFFERS_h
+#define FRAMEBUFFERS_h
+
+#define FFT_SIZE                1024
+#define SAMPLE_SIZE_BYTES       4       // 32-bit (16-bit Re + 16-bit Im) in, 32-bit power out
+#define FRAME_BYTES             (FFT_SIZE * SAMPLE_SIZE_BYTES)
+
+// ADXL345 output data rate feeding the FFT: the MicroBlaze programs it, the
+// PS derives the bin width from it (100, 200, 400, 800, 1600 or 3200)
+#define FFT_SAMPLE_RATE_HZ      1600
+
+#define FRAME_BUFFERS           4
+
+#define RX_REGION_OFFSET        0x0000
+#define TX_REGION_OFFSET        0x4000
+#define CONTROL_OFFSET          0x8000
+#define MM2S_BD_OFFSET          0x9000
+#define S2MM_BD_OFFSET          0x9400
+
+#define RX_FRAME_OFFSET(k)      (RX_REGION_OFFSET + (k) * FRAME_BYTES)
+#define TX_FRAME_OFFSET(k)      (TX_REGION_OFFSET + (k) * FRAME_BYTES)
+#define FRAME_STATE_OFFSET(k)   (CONTROL_OFFSET + 4 * (k))
+#define FRAME_NUMBER_OFFSET(k)  (CONTROL_OFFSET + 4 * FRAME_BUFFERS + 4 * (k))
+
+// Slot states (values chosen so a blank BRAM is not mistaken for READY)
+#define FRAME_FREE              0x00000000
+#define FRAME_PROCESSING        0x50524F43      // "PROC"
+#define FRAME_READY             0xCAFEBABE
+#define FRAME_DROPPED           0xDEADF8A3
+
+#define FRAME_NEXT(k)           (((k) + 1) % FRAME_BUFFERS)
+
+#endif
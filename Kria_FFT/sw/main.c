@@ -3,8 +3,11 @@
 #include "xparameters.h"
 #include "xil_printf.h"
 #include "xiic.h"
+#include "deferLog.h"
 #include "math.h"
 #include "complex.h"
+#include "fftPlan.h"
+#include "fftFixed.h"
 
 // ----------------------------------------------------------------------------
 // Configuration
@@ -22,51 +25,29 @@
 
 #define SAMPLES_COUNT       128
 
-// Structure for Complex Numbers
-typedef struct {
-    float real;
-    float imag;
-} complex_t;
+// 1: integer FFT with the xfft_0 arithmetic (fftFixed.c, unscaled, truncation),
+//    no soft-float in the transform; 0: float real-input FFT (fftPlan.c)
+#define FFT_FIXED_POINT     1
 
 // Global Buffers
-complex_t signal[SAMPLES_COUNT];
 XIic Iic;
 
-// ----------------------------------------------------------------------------
-// FFT Implementation
-// ----------------------------------------------------------------------------
-void fft(complex_t *X, int N) {
-    if (N <= 1) return;
-
-    complex_t even[N/2];
-    complex_t odd[N/2];
-
-    for (int i = 0; i < N/2; i++) {
-        even[i] = X[2*i];
-        odd[i] = X[2*i + 1];
-    }
-
-    fft(even, N/2);
-    fft(odd, N/2);
-
-    for (int k = 0; k < N/2; k++) {
-        float r = even[k].real;
-        float i = even[k].imag;
-        
-        float angle = -2 * M_PI * k / N;
-        float wr = cos(angle);
-        float wi = sin(angle);
-        
-        float tr = wr * odd[k].real - wi * odd[k].imag;
-        float ti = wr * odd[k].imag + wi * odd[k].real;
-        
-        X[k].real = r + tr;
-        X[k].imag = i + ti;
-        
-        X[k + N/2].real = r - tr;
-        X[k + N/2].imag = i - ti;
-    }
-}
+#if FFT_FIXED_POINT
+// Raw 16-bit samples in, unscaled 16 + log2(N) + 1 bit bins out, built once in main()
+static fftfix_complex_t fixed_signal[SAMPLES_COUNT];
+static fftfix_complex_t fixed_twiddle[FFTFIX_TWIDDLES(SAMPLES_COUNT)];
+static uint16_t fixed_bitrev[SAMPLES_COUNT];
+static fftfix_plan_t fixed_plan;
+#else
+// Real samples in, bins 0..N/2 out, in place (N + 2 floats)
+complex_t signal[FFTPLAN_BINS(SAMPLES_COUNT)];
+
+// Real-input FFT plan: N/2-point complex tables plus the split table, built once in main()
+static complex_t fft_twiddle[FFTPLAN_TWIDDLES(SAMPLES_COUNT / 2)];
+static complex_t fft_split[FFTPLAN_SPLIT(SAMPLES_COUNT)];
+static uint16_t fft_bitrev[SAMPLES_COUNT / 2];
+static fftrplan_t fft_plan;
+#endif
 
 // ----------------------------------------------------------------------------
 // I2C Helpers
@@ -126,38 +107,68 @@ int main() {
     write_iic(ADXL345_ADDR, ADXL345_power_ctl, 0x08);   // Measurement Mode
     write_iic(ADXL345_ADDR, ADXL345_data_format, 0x01); // +/- 4g
 
+    // Precompute the FFT tables (the only cos/sin calls)
+#if FFT_FIXED_POINT
+    if (fftfix_init(&fixed_plan, SAMPLES_COUNT, fixed_twiddle, fixed_bitrev, FFTFIX_TRUNCATE) != 0) {
+#else
+    if (fftrplan_init(&fft_plan, SAMPLES_COUNT, fft_twiddle, fft_bitrev, fft_split) != 0) {
+#endif
+        xil_printf("FFT Plan Init Failed\r\n");
+        return XST_FAILURE;
+    }
+
     // Pointer to Shared BRAM (floating point view)
-    // We write 2 floats (Real, Imag) per sample.
+    // We write 2 floats (Real, Imag) per bin.
     volatile float *bram_float_ptr = (volatile float *)BRAM_BASE_ADDR;
+#if !FFT_FIXED_POINT
+    float *samples = (float *)signal;
+#endif
 
     while (1) {
-        xil_printf("Acquiring %d samples...\r\n", SAMPLES_COUNT);
+        DLOG1(DLOG_FFT_SW_ACQUIRE, SAMPLES_COUNT);
 
         // 1. Acquire
         for (int i = 0; i < SAMPLES_COUNT; i++) {
             short ax, ay, az;
             read_accel_data(&ax, &ay, &az);
             
-            // Convert to float for FFT
-            signal[i].real = (float)ax;
-            signal[i].imag = 0.0f;
+#if FFT_FIXED_POINT
+            // Raw sample as the xfft input: Real = sample, Imag = 0
+            fixed_signal[i].real = ax;
+            fixed_signal[i].imag = 0;
+#else
+            // Convert to float for FFT (real input, no Imag)
+            samples[i] = (float)ax;
+#endif
             
             // Delay to set roughly sampling rate
             for(volatile int k=0; k<2000; k++); 
         }
 
         // 2. Compute FFT
-        xil_printf("Computing FFT...\r\n");
-        fft(signal, SAMPLES_COUNT);
+        DLOG0(DLOG_FFT_SW_COMPUTE);
+#if FFT_FIXED_POINT
+        fftfix_execute(&fixed_plan, fixed_signal, FFTFIX_UNSCALED, 0, NULL);
+#else
+        fftrplan_execute(&fft_plan, samples, signal);
+#endif
 
         // 3. Write to Shared Memory
-        // Layout: R0, I0, R1, I1 ...
-        for (int i = 0; i < SAMPLES_COUNT; i++) {
+        // Layout: R0, I0, R1, I1 ... for bins 0..N/2 (the rest mirror them)
+        for (int i = 0; i < FFTPLAN_BINS(SAMPLES_COUNT); i++) {
+#if FFT_FIXED_POINT
+            bram_float_ptr[2*i]     = (float)fixed_signal[i].real;
+            bram_float_ptr[2*i + 1] = (float)fixed_signal[i].imag;
+#else
             bram_float_ptr[2*i]     = signal[i].real;
             bram_float_ptr[2*i + 1] = signal[i].imag;
+#endif
         }
         
-        xil_printf("Frame Done. Results in BRAM.\r\n");
+        DLOG0(DLOG_FFT_SW_DONE);
+
+        // Send the frame's log records before the next acquisition
+        dlog_drain(DLOG_DEPTH);
     }
 
     cleanup_platform();
@@ -1,110 +1,188 @@
 
 #include "xparameters.h"
-#include "xaxidma.h"
-#include "xiic.h"
+#include "xintc_l.h"
+#include "xil_exception.h"
 #include "xil_io.h"
 #include "xdebug.h"
 #include "sleep.h"
+#include "deferLog.h"
+#include "doorbell.h"
+#include "frameBuffers.h"
+#include "fftDma.h"
+#include "fftSgDma.h"
+#include "fftAcquire.h"
 
 // --- Hardware Configuration ---
+// 1 = scatter-gather (fftSgDma.c), 0 = simple mode (fftDma.c); must match
+// dma_sg_mode in build_complete_system.tcl
+#define DMA_SG_MODE         1
 #define DMA_DEV_ID          XPAR_AXIDMA_0_DEVICE_ID
-#define IIC_DEV_ID          XPAR_AXI_IIC_0_DEVICE_ID
+#define DMA_BASEADDR        XPAR_AXIDMA_0_BASEADDR
+#define IIC_BASEADDR        XPAR_AXI_IIC_0_BASEADDR
 #define BRAM_BASE_ADDR      XPAR_MB_BRAM_CTRL_S_AXI_BASEADDR  // 0xC0000000 usually
+#define DOORBELL_GPIO_ADDR  XPAR_DOORBELL_GPIO_BASEADDR       // pl_ps_irq0 to the PS
+#define INTC_BASEADDR       XPAR_XINTC_0_BASEADDR
+#define MM2S_INTR_ID        0       // axi_dma_0/mm2s_introut -> INTC input 0
+#define S2MM_INTR_ID        1       // axi_dma_0/s2mm_introut -> INTC input 1
+#define MM2S_INT_MASK       (1 << MM2S_INTR_ID)
+#define S2MM_INT_MASK       (1 << S2MM_INTR_ID)
 
-// --- Memory Map (Shared BRAM) ---
-// We split the BRAM into sections for Raw Data, Processed Data, and Flags
-#define RX_BUFFER_OFFSET    0x0000  // Raw Time-Domain Samples (Input to FFT)
-#define TX_BUFFER_OFFSET    0x1000  // Processed Freq-Domain Power (Output from FFT)
-#define FLAG_OFFSET         0x2000  // Handshake Flag Address used by PS
+// --- Memory Map (Shared BRAM, see frameBuffers.h) ---
+#define RX_FRAME_ADDR(k)    (BRAM_BASE_ADDR + RX_FRAME_OFFSET(k))   // Raw Time-Domain Samples (Input to FFT)
+#define TX_FRAME_ADDR(k)    (BRAM_BASE_ADDR + TX_FRAME_OFFSET(k))   // Processed Freq-Domain Power (Output from FFT)
+#define FRAME_STATE_ADDR(k) (BRAM_BASE_ADDR + FRAME_STATE_OFFSET(k))
+#define FRAME_NUMBER_ADDR(k) (BRAM_BASE_ADDR + FRAME_NUMBER_OFFSET(k))
+#define MM2S_BD_ADDR        (BRAM_BASE_ADDR + MM2S_BD_OFFSET)
+#define S2MM_BD_ADDR        (BRAM_BASE_ADDR + S2MM_BD_OFFSET)
 
-#define RX_BUFFER_ADDR      (BRAM_BASE_ADDR + RX_BUFFER_OFFSET)
-#define TX_BUFFER_ADDR      (BRAM_BASE_ADDR + TX_BUFFER_OFFSET)
-#define FLAG_ADDR           (BRAM_BASE_ADDR + FLAG_OFFSET)
+// --- Acquisition ---
+#define ACQ_AXIS            FFTACQ_AXIS_X
+#if FFT_SAMPLE_RATE_HZ == 3200
+#define ACQ_DATA_RATE       FFTACQ_DATARATE_3200HZ
+#elif FFT_SAMPLE_RATE_HZ == 1600
+#define ACQ_DATA_RATE       FFTACQ_DATARATE_1600HZ
+#elif FFT_SAMPLE_RATE_HZ == 800
+#define ACQ_DATA_RATE       FFTACQ_DATARATE_800HZ
+#elif FFT_SAMPLE_RATE_HZ == 400
+#define ACQ_DATA_RATE       FFTACQ_DATARATE_400HZ
+#elif FFT_SAMPLE_RATE_HZ == 200
+#define ACQ_DATA_RATE       FFTACQ_DATARATE_200HZ
+#elif FFT_SAMPLE_RATE_HZ == 100
+#define ACQ_DATA_RATE       FFTACQ_DATARATE_100HZ
+#else
+#error "FFT_SAMPLE_RATE_HZ must be an ADXL345 output data rate from 100 to 3200 Hz"
+#endif
+#define ACQ_STATS_FRAMES    16      // log the acquisition counters every N frames
 
 // --- Constants ---
-#define FFT_SIZE            1024
-#define SAMPLE_SIZE_BYTES   4       // 32-bit (16-bit Re + 16-bit Im)
-#define DMA_TRANSFER_SIZE   (FFT_SIZE * SAMPLE_SIZE_BYTES)
-
-#define DATA_READY_FLAG     0xCAFEBABE
-#define DATA_ACK_FLAG       0x00000000
+#define DMA_TRANSFER_SIZE   FRAME_BYTES
+// Main-loop passes a transform may take before the DMA is reset; a pass
+// includes at least one I2C FIFO poll (~100 us), a transform ~31 us
+#define DMA_TIMEOUT_PASSES  2000
 
 // --- Global Driver Instances ---
-XAxiDma AxiDma;
-XIic Iic;
+#if DMA_SG_MODE
+fftsg_t Sg;
+#define DMA_RESETS          Sg.resets
+#define DMA_ISR_REF         &Sg
+#define MM2S_ISR            fftsg_mm2sIsr
+#define S2MM_ISR            fftsg_s2mmIsr
+#else
+fftdma_t Fft;
+#define DMA_RESETS          Fft.resets
+#define DMA_ISR_REF         &Fft
+#define MM2S_ISR            fftdma_mm2sIsr
+#define S2MM_ISR            fftdma_s2mmIsr
+#endif
+fftacq_t Acq;
+doorbell_t Bell;
 
-int init_drivers() {
-    int Status;
-    XAxiDma_Config *CfgPtr;
+u32 FramesDone = 0;
+u32 FramesFailed = 0;
 
-    // 1. Initialize DMA
-    CfgPtr = XAxiDma_LookupConfig(DMA_DEV_ID);
-    if (!CfgPtr) {
-        xil_printf("No config found for %d\r\n", DMA_DEV_ID);
-        return XST_FAILURE;
+// DMA completion, called from fftsg_service() / fftdma_service() in the main loop
+// (FFTSG_* and FFTDMA_* statuses have the same values)
+void frame_done(void *ref, int slot, int status) {
+    (void)ref;
+
+    if (status == FFTDMA_OK) {
+        // Signal PS that data is ready
+        DLOG0(DLOG_FFT_SIGNAL);
+        Xil_Out32(FRAME_STATE_ADDR(slot), FRAME_READY);
+        doorbell_ring(&Bell);
+        FramesDone++;
+    } else {
+        // The DMA has been reset; drop the frame, and let the PS skip the slot
+        // in order and hand it back
+        FramesFailed++;
+        DLOG3(DLOG_FFT_DMA_RECOVERED, Xil_In32(FRAME_NUMBER_ADDR(slot)), status, DMA_RESETS);
+        Xil_Out32(FRAME_STATE_ADDR(slot), FRAME_DROPPED);
+        doorbell_ring(&Bell);
     }
+}
 
-    Status = XAxiDma_CfgInitialize(&AxiDma, CfgPtr);
-    if (Status != XST_SUCCESS) {
-        xil_printf("Initialization failed %d\r\n", Status);
+int init_drivers() {
+    // 1. Initialize DMA (IOC + error interrupts on both channels)
+#if DMA_SG_MODE
+    if (fftsg_init(&Sg, DMA_BASEADDR, MM2S_BD_ADDR, S2MM_BD_ADDR, FRAME_BUFFERS,
+                   frame_done, NULL, DMA_TIMEOUT_PASSES) != XST_SUCCESS) {
+#else
+    if (fftdma_init(&Fft, DMA_DEV_ID, frame_done, NULL, DMA_TIMEOUT_PASSES) != XST_SUCCESS) {
+#endif
+        xil_printf("DMA initialization failed\r\n");
         return XST_FAILURE;
     }
 
-    // Disable Interrupts for Polling Mode initially
-    XAxiDma_IntrDisable(&AxiDma, XAXIDMA_IRQ_ALL_MASK, XAXIDMA_DEVICE_TO_DMA);
-    XAxiDma_IntrDisable(&AxiDma, XAXIDMA_IRQ_ALL_MASK, XAXIDMA_DMA_TO_DEVICE);
+    // 2. DMA interrupts through the AXI INTC
+    XIntc_RegisterHandler(INTC_BASEADDR, MM2S_INTR_ID, (XInterruptHandler)MM2S_ISR, DMA_ISR_REF);
+    XIntc_RegisterHandler(INTC_BASEADDR, S2MM_INTR_ID, (XInterruptHandler)S2MM_ISR, DMA_ISR_REF);
 
-    // 2. Initialize I2C (Optional: Add actual sensor init here)
-    // Status = XIic_Initialize(&Iic, IIC_DEV_ID);
-    // ...
+    void* ptr = (void*)(u32)INTC_BASEADDR;
+    Xil_ExceptionInit();
+    Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_INT,
+                                 (Xil_ExceptionHandler)XIntc_DeviceInterruptHandler,
+                                 ptr);
 
-    return XST_SUCCESS;
-}
+    XIntc_Out32(INTC_BASEADDR + XIN_IAR_OFFSET, MM2S_INT_MASK | S2MM_INT_MASK);
+    XIntc_EnableIntr(INTC_BASEADDR, MM2S_INT_MASK | S2MM_INT_MASK);
+    XIntc_Out32(INTC_BASEADDR + XIN_MER_OFFSET, XIN_INT_MASTER_ENABLE_MASK | XIN_INT_HARDWARE_ENABLE_MASK);
+    Xil_ExceptionEnable();
+
+    // 3. Doorbell to the PS (idle low)
+    doorbell_init(&Bell, DOORBELL_GPIO_ADDR);
 
-void acquire_sensor_data() {
-    // Simulate reading I2C sensor data and writing to BRAM
-    // In real app, loop over I2C reads here.
-    
-    volatile u32 *rx_ptr = (u32 *)RX_BUFFER_ADDR;
-    
-    for (int i = 0; i < FFT_SIZE; i++) {
-        // Generate dummy sine wave or simpler pattern for test
-        // Packing: [31:16] Imag (0), [15:0] Real (Sample)
-        int16_t sample = (int16_t)(i % 256); // Dummy sawtooth
-        u32 packed_data = (0 << 16) | (sample & 0xFFFF);
-        
-        rx_ptr[i] = packed_data;
+    // 4. ADXL345: ODR, full resolution, FIFO in stream mode
+    if (fftacq_init(&Acq, IIC_BASEADDR, FFTACQ_BUS_HZ, ACQ_AXIS, ACQ_DATA_RATE) != XST_SUCCESS) {
+        xil_printf("ADXL345 not found\r\n");
+        return XST_FAILURE;
     }
-    
-    // Flush Data Cache to ensure DMA sees updated BRAM content (if cache enabled)
-    Xil_DCacheFlushRange((UINTPTR)RX_BUFFER_ADDR, DMA_TRANSFER_SIZE);
+
+    return XST_SUCCESS;
 }
 
-int run_hardware_acceleration() {
-    int Status;
+// Log sustained acquisition and I2C bus load since the last report
+void report_acquisition(void) {
+    static u32 lastSamples = 0, lastOverruns = 0;
+    static uint64_t lastDataBits = 0, lastPollBits = 0;
 
-    // 1. Invalidate Cache for Result Buffer (So CPU reads fresh data from DMA)
-    Xil_DCacheInvalidateRange((UINTPTR)TX_BUFFER_ADDR, DMA_TRANSFER_SIZE);
+    u32 samples = Acq.samples - lastSamples;
+    uint64_t dataBits = Acq.dataBits - lastDataBits;
+    u32 bus = fftacq_busPermille(&Acq, dataBits + (Acq.pollBits - lastPollBits), samples);
+    u32 busData = fftacq_busPermille(&Acq, dataBits, samples);
 
-    // 2. Start DMA Transfer: MM2S (Read from BRAM -> FFT)
-    Status = XAxiDma_SimpleTransfer(&AxiDma, (UINTPTR)RX_BUFFER_ADDR,
-                                   DMA_TRANSFER_SIZE, XAXIDMA_DMA_TO_DEVICE);
-    if (Status != XST_SUCCESS) return XST_FAILURE;
+    DLOG3(DLOG_FFT_ACQ_STATS, samples, fftacq_odrMilliHz(Acq.dataRate) / 1000, Acq.overruns - lastOverruns);
+    DLOG4(DLOG_FFT_ACQ_BUS, bus / 10, bus % 10, busData / 10, busData % 10);
 
-    // 3. Start DMA Transfer: S2MM (Write FFT Result -> BRAM)
-    Status = XAxiDma_SimpleTransfer(&AxiDma, (UINTPTR)TX_BUFFER_ADDR,
-                                   DMA_TRANSFER_SIZE, XAXIDMA_DEVICE_TO_DMA);
-    if (Status != XST_SUCCESS) return XST_FAILURE;
+    lastSamples = Acq.samples;
+    lastOverruns = Acq.overruns;
+    lastDataBits = Acq.dataBits;
+    lastPollBits = Acq.pollBits;
+}
+
+// Move whatever the ADXL345 FIFO holds into frame k; returns 1 once the frame is full
+int acquire_sensor_data(int k) {
+    static int count = 0;
+    static u32 frames = 0;
+    volatile u32 *rx_ptr = (volatile u32 *)RX_FRAME_ADDR(k);
 
-    // 4. Wait for Completion (Polling)
-    while (XAxiDma_Busy(&AxiDma, XAXIDMA_DMA_TO_DEVICE)) {
-        // Wait for MM2S
+    if (count == 0) {
+        DLOG0(DLOG_FFT_ACQUIRE);
     }
-    while (XAxiDma_Busy(&AxiDma, XAXIDMA_DEVICE_TO_DMA)) {
-        // Wait for S2MM
+
+    // Packing: [31:16] Imag (0), [15:0] Real (Sample), straight into the RX buffer
+    count += fftacq_fill(&Acq, rx_ptr + count, FFT_SIZE - count);
+    if (count < FFT_SIZE) {
+        return 0;
     }
+    count = 0;
 
-    return XST_SUCCESS;
+    if (++frames % ACQ_STATS_FRAMES == 0) {
+        report_acquisition();
+    }
+
+    // Flush Data Cache to ensure DMA sees updated BRAM content (if cache enabled)
+    Xil_DCacheFlushRange((UINTPTR)RX_FRAME_ADDR(k), DMA_TRANSFER_SIZE);
+    return 1;
 }
 
 int main() {
@@ -116,31 +194,88 @@ int main() {
         return 1;
     }
 
+    // All slots start out ours
+    for (int k = 0; k < FRAME_BUFFERS; k++) {
+        Xil_Out32(FRAME_STATE_ADDR(k), FRAME_FREE);
+    }
+
+    int fill = 0;           // next slot to acquire into
+    u32 frameNumber = 0;
+    u32 pass = 0;
+#if !DMA_SG_MODE
+    int filled = 0;         // slot `fill` holds a complete frame not yet started
+#endif
+
     while (1) {
-        // 1. Acquire Data (I2C -> BRAM)
-        xil_printf("Acquiring Data...\r\n");
-        acquire_sensor_data();
-
-        // 2. Run Hardware Acceleration (BRAM -> DMA -> FFT -> BRAM)
-        xil_printf("Running FFT Acceleration...\r\n");
-        if (run_hardware_acceleration() != XST_SUCCESS) {
-            xil_printf("DMA Transfer Failed\r\n");
+        pass++;
+
+#if DMA_SG_MODE
+        // 1. Retire finished transforms (READY + doorbell), or recover from a DMA error
+        fftsg_service(&Sg, pass);
+        if (fftsg_failed(&Sg)) {
+            // The recovery reset never completed; the queued frames went back as DROPPED
+            DLOG1(DLOG_FFT_DMA_HALTED, DMA_RESETS);
+            break;
+        }
+
+        // 2. Acquire Data (I2C -> BRAM); once the frame is full, queue it straight
+        //    behind the frames the DMA is working on, so the FFT streams them back to back
+        if (Xil_In32(FRAME_STATE_ADDR(fill)) == FRAME_FREE && fftsg_free(&Sg) > 0 &&
+            acquire_sensor_data(fill)) {
+            DLOG0(DLOG_FFT_RUN);
+            Xil_Out32(FRAME_NUMBER_ADDR(fill), frameNumber++);
+            Xil_Out32(FRAME_STATE_ADDR(fill), FRAME_PROCESSING);
+            Xil_DCacheInvalidateRange((UINTPTR)TX_FRAME_ADDR(fill), DMA_TRANSFER_SIZE);
+
+            if (fftsg_submit(&Sg, fill, (UINTPTR)RX_FRAME_ADDR(fill), (UINTPTR)TX_FRAME_ADDR(fill),
+                             DMA_TRANSFER_SIZE, pass) != XST_SUCCESS) {
+                // Ring refused the frame: keep the slot and acquire into it again
+                DLOG0(DLOG_FFT_DMA_FAILED);
+                Xil_Out32(FRAME_STATE_ADDR(fill), FRAME_FREE);
+            } else {
+                fill = FRAME_NEXT(fill);
+            }
+        }
+#else
+        // 1. Retire a finished transform (READY + doorbell), or recover a failed one
+        fftdma_service(&Fft, pass);
+        if (fftdma_failed(&Fft)) {
+            // The recovery reset never completed; the frame went back as DROPPED
+            DLOG1(DLOG_FFT_DMA_HALTED, DMA_RESETS);
             break;
         }
 
-        // 3. Signal PS that data is ready
-        xil_printf("Data Ready. Signaling PS...\r\n");
-        Xil_Out32(FLAG_ADDR, DATA_READY_FLAG);
+        // 2. Acquire Data (I2C -> BRAM) while the DMA works on the previous frame
+        if (!filled && Xil_In32(FRAME_STATE_ADDR(fill)) == FRAME_FREE) {
+            filled = acquire_sensor_data(fill);
+        }
+
+        // 3. Run Hardware Acceleration (BRAM -> DMA -> FFT -> BRAM) once the DMA is free;
+        //    completion arrives by interrupt
+        if (filled && !fftdma_busy(&Fft)) {
+            DLOG0(DLOG_FFT_RUN);
+            Xil_Out32(FRAME_NUMBER_ADDR(fill), frameNumber++);
+            Xil_Out32(FRAME_STATE_ADDR(fill), FRAME_PROCESSING);
+            Xil_DCacheInvalidateRange((UINTPTR)TX_FRAME_ADDR(fill), DMA_TRANSFER_SIZE);
 
-        // 4. Wait for PS to Acknowledge (Clear Flag)
-        while (Xil_In32(FLAG_ADDR) == DATA_READY_FLAG) {
-            sleep(1); // Wait 1ms
+            if (fftdma_start(&Fft, fill, (UINTPTR)RX_FRAME_ADDR(fill), (UINTPTR)TX_FRAME_ADDR(fill),
+                             DMA_TRANSFER_SIZE, pass) != XST_SUCCESS) {
+                // Refused even after a reset: keep the frame and try again next pass
+                DLOG0(DLOG_FFT_DMA_FAILED);
+                Xil_Out32(FRAME_STATE_ADDR(fill), FRAME_FREE);
+            } else {
+                filled = 0;
+                fill = FRAME_NEXT(fill);
+            }
         }
-        
-        // Loop
-        sleep(100); // 100ms delay between frames
+#endif
+
+        // Send the frame's log records while the DMA and the PS work
+        dlog_drain(DLOG_DEPTH);
     }
 
+    dlog_drain(DLOG_DEPTH);
+
     cleanup_platform();
     return 0;
 }
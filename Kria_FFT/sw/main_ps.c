@@ -1,24 +1,60 @@
 
 #include <stdio.h>
 #include "platform.h"
+#include "xparameters.h"
 #include "xil_printf.h"
 #include "xil_io.h"
+#include "xscugic.h"
+#include "xil_exception.h"
 #include "sleep.h"
+#include "deferLog.h"
+#include "telemetry.h"
+#include "doorbell.h"
+#include "frameBuffers.h"
+#include "xtime_l.h"
+
+// 1: stream each power spectrum as binary telemetry (PC_Telemetry_Decode.cpp)
+#ifndef PS_TELEMETRY
+#define PS_TELEMETRY        0
+#endif
 
 // --- Helper Macros ---
 // NOTE: Verify these addresses in Vivado Address Editor for the PS View
 #define SHARED_BRAM_BASE    0xC0000000 
-#define RX_BUFFER_OFFSET    0x0000  // Raw Data (Input)
-#define TX_BUFFER_OFFSET    0x1000  // Processed Data (Output)
-#define FLAG_OFFSET         0x2000  // Handshake Flag
 
-#define TX_BUFFER_ADDR      (SHARED_BRAM_BASE + TX_BUFFER_OFFSET)
-#define FLAG_ADDR           (SHARED_BRAM_BASE + FLAG_OFFSET)
+// Frame slots (see frameBuffers.h)
+#define TX_FRAME_ADDR(k)    (SHARED_BRAM_BASE + TX_FRAME_OFFSET(k))     // Processed Data (Output)
+#define FRAME_STATE_ADDR(k) (SHARED_BRAM_BASE + FRAME_STATE_OFFSET(k))  // Handshake Flag
+#define FRAME_NUMBER_ADDR(k) (SHARED_BRAM_BASE + FRAME_NUMBER_OFFSET(k))
 
 // --- Constants ---
-#define FFT_SIZE            1024
-#define DATA_READY_FLAG     0xCAFEBABE
-#define DATA_ACK_FLAG       0x00000000
+#define BIN_WIDTH_MHZ       (FFT_SAMPLE_RATE_HZ * 1000 / FFT_SIZE)
+#define STATS_EVERY         16      // frames between doorbell reports
+
+static XScuGic Gic;
+static doorbell_t Bell;
+
+// GIC + doorbell (pl_ps_irq0 pulsed by the MicroBlaze after each frame)
+static int setup_doorbell(void)
+{
+    XScuGic_Config *config = XScuGic_LookupConfig(XPAR_SCUGIC_SINGLE_DEVICE_ID);
+    if (config == NULL) {
+        return XST_FAILURE;
+    }
+    if (XScuGic_CfgInitialize(&Gic, config, config->CpuBaseAddress) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+
+    Xil_ExceptionInit();
+    Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_INT, (Xil_ExceptionHandler)XScuGic_InterruptHandler, &Gic);
+
+    if (doorbell_attach(&Bell, &Gic, DOORBELL_INT_ID) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+
+    Xil_ExceptionEnable();
+    return XST_SUCCESS;
+}
 
 int main()
 {
@@ -26,25 +62,41 @@ int main()
     print("--- Kria FFT System Monitor (PS) ---\n\r");
     print("Waiting for data from MicroBlaze...\n\r");
 
-    // Clear any stale flags
-    Xil_Out32(FLAG_ADDR, DATA_ACK_FLAG);
+    // Slot states are initialised by the MicroBlaze; frames come in slot order
+    if (setup_doorbell() != XST_SUCCESS) {
+        print("Doorbell interrupt setup failed\n\r");
+        return 1;
+    }
 
     u32 frame_count = 0;
+    u32 dropped_count = 0;
+    int slot = 0;
+
+    // End-to-end frame rate, reported once a second
+    XTime rate_start, now;
+    u32 rate_frames = 0;
+    XTime_GetTime(&rate_start);
+
+#if PS_TELEMETRY
+    static u32 spectrum[FFT_SIZE / 2];
+    XTime frame_time = 0;
+    outbyte(0);     // ends the start-up text, so the first frame decodes
+#endif
 
     while (1) {
-        // 1. Poll Flag
-        volatile u32 flag = Xil_In32(FLAG_ADDR);
+        // 1. Check the next slot; it is only re-read after a doorbell, not on a timer
+        volatile u32 flag = Xil_In32(FRAME_STATE_ADDR(slot));
         
-        if (flag == DATA_READY_FLAG) {
+        if (flag == FRAME_READY) {
             frame_count++;
+            rate_frames++;
+            u32 frame_number = Xil_In32(FRAME_NUMBER_ADDR(slot));
             
             // 2. Read Results from BRAM
             // Note: We need to invalidate cache to ensure we read fresh data from BRAM
-            Xil_DCacheInvalidateRange((UINTPTR)TX_BUFFER_ADDR, FFT_SIZE * 4);
-            
-            xil_printf("Frame %d Received! Processing results...\n\r", frame_count);
+            Xil_DCacheInvalidateRange((UINTPTR)TX_FRAME_ADDR(slot), FRAME_BYTES);
             
-            volatile u32 *fft_results = (u32 *)TX_BUFFER_ADDR;
+            volatile u32 *fft_results = (u32 *)TX_FRAME_ADDR(slot);
             
             // Example: Find Peer Frequency (Max Magnitude)
             u32 max_power = 0;
@@ -52,20 +104,62 @@ int main()
             
             for (int i = 0; i < FFT_SIZE/2; i++) { // Only look at positive frequencies
                 u32 power = fft_results[i];
+#if PS_TELEMETRY
+                spectrum[i] = power;
+#endif
                 if (power > max_power) {
                     max_power = power;
                     max_idx = i;
                 }
             }
             
-            xil_printf("  - Peak Frequency Bin: %d\n\r", max_idx);
-            xil_printf("  - Peak Power: %u\n\r", max_power);
+            DLOG3(DLOG_FFT_FRAME, frame_number, max_idx, max_power);
+#if PS_TELEMETRY
+            XTime_GetTime(&frame_time);
+#endif
             
-            // 3. Acknowledge Receipt (Clear Flag)
-            Xil_Out32(FLAG_ADDR, DATA_ACK_FLAG);
+            // 3. Acknowledge Receipt: the slot goes back to the MicroBlaze
+            Xil_Out32(FRAME_STATE_ADDR(slot), FRAME_FREE);
+            slot = FRAME_NEXT(slot);
+
+#if PS_TELEMETRY
+            // Sent from the copy, so the MicroBlaze is not held up by the UART
+            tlm_sendSpectrum((u32)(frame_time / (COUNTS_PER_SECOND / 1000000)), 0, BIN_WIDTH_MHZ,
+                             spectrum, FFT_SIZE / 2);
+#endif
+        } else if (flag == FRAME_DROPPED) {
+            // The MicroBlaze lost this frame to a DMA error: skip it, keeping the slot order
+            dropped_count++;
+            DLOG2(DLOG_FFT_FRAME_DROPPED, Xil_In32(FRAME_NUMBER_ADDR(slot)), dropped_count);
+            Xil_Out32(FRAME_STATE_ADDR(slot), FRAME_FREE);
+            slot = FRAME_NEXT(slot);
+        }
+
+        XTime_GetTime(&now);
+        if (now - rate_start >= COUNTS_PER_SECOND) {
+            u32 fps_x10 = (u32)((u64)rate_frames * 10 * COUNTS_PER_SECOND / (now - rate_start));
+            DLOG3(DLOG_FFT_RATE, fps_x10 / 10, fps_x10 % 10, frame_count);
+            rate_start = now;
+            rate_frames = 0;
+        }
+
+#if !PS_TELEMETRY
+        if (flag == FRAME_READY && frame_count % STATS_EVERY == 0) {
+            DLOG3(DLOG_DOORBELL_WAKEUPS, Bell.stats.wakeups, Bell.stats.rings, frame_count);
+            DLOG3(DLOG_DOORBELL_LATENCY, Bell.stats.latencyMinNs, doorbell_latencyAvgNs(&Bell.stats),
+                  Bell.stats.latencyMaxNs);
+        }
+
+        // Text goes out between frames, off the acknowledge path
+        dlog_drain(DLOG_DEPTH);
+#endif
+
+        // Sleep until the MicroBlaze rings (a ring during the work above is
+        // already pending, so this returns at once)
+        if (flag != FRAME_READY && flag != FRAME_DROPPED) {
+            doorbell_rearm(&Bell);
+            doorbell_wait(&Bell);
         }
-        
-        usleep(1000); // Check every 1ms
     }
 
     cleanup_platform();
@@ -0,0 +1,72 @@
+/*
+telemetry.h - Binary telemetry frames for streaming samples and spectra.
+
+Each frame is a little-endian payload protected by a CRC-16, COBS-encoded
+so it contains no zero bytes, and terminated by 0x00. A receiver can
+therefore resynchronise on the next zero after any line error.
+
+Payload:
+    0  type (1)                 TLM_TYPE_SAMPLES / TLM_TYPE_SPECTRUM
+    1  reserved (1)             0
+    2  seq (2)                  incremented per frame, all types
+    4  timestamp_us (4)         first sample / frame time
+    8  type specific
+       SAMPLES:  count (2), period_us (2), count x {x, y, z} int16
+       SPECTRUM: first_bin (2), count (2), bin_mhz (4), count x uint32 power
+    .. crc (2)                  CRC-16/CCITT-FALSE over everything before
+
+A 32-sample frame is 208 bytes on the wire (6.5 B/sample, against ~60
+for "AccelX: %d.%03d ..." text), so 115200 baud carries about 1700
+samples/s. The host side is PC_Telemetry_Decode.cpp.
+
+Frames go out through tlm_send*(), one byte at a time via outbyte(), or
+-DTLM_OUTBYTE=name for another sink. The telemetry stream needs the UART
+to itself; do not mix it with xil_printf or deferLog output.
+*/
+
+#ifndef TELEMETRY_h
+#define TELEMETRY_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TLM_TYPE_SAMPLES        1
+#define TLM_TYPE_SPECTRUM       2
+
+#define TLM_HEADER_SIZE         8
+#define TLM_CRC_SIZE            2
+#define TLM_MAX_SAMPLES         64
+#define TLM_MAX_BINS            512
+
+// Largest payload (a full spectrum frame) and its COBS-encoded size with delimiter
+#define TLM_MAX_PAYLOAD         (TLM_HEADER_SIZE + 8 + 4 * TLM_MAX_BINS + TLM_CRC_SIZE)
+#define TLM_MAX_ENCODED         (TLM_MAX_PAYLOAD + TLM_MAX_PAYLOAD / 254 + 2)
+
+uint16_t tlm_crc16(const uint8_t *data, size_t length);
+
+// COBS: encode returns the encoded length (no delimiter); decode returns the
+// payload length, or 0 if the input is malformed
+size_t tlm_cobsEncode(const uint8_t *src, size_t length, uint8_t *dst);
+size_t tlm_cobsDecode(const uint8_t *src, size_t length, uint8_t *dst);
+
+// Build a payload (CRC included) in frame[TLM_MAX_PAYLOAD]; returns its length
+size_t tlm_buildSamples(uint8_t *frame, uint16_t seq, uint32_t timestamp_us, uint16_t period_us,
+                        const int16_t *xyz, uint16_t count);
+size_t tlm_buildSpectrum(uint8_t *frame, uint16_t seq, uint32_t timestamp_us, uint16_t first_bin,
+                         uint32_t bin_mhz, const uint32_t *power, uint16_t count);
+
+// Build, encode and send one frame with the next sequence number.
+// xyz holds count interleaved x, y, z samples (as from drainFifo).
+void tlm_sendSamples(uint32_t timestamp_us, uint16_t period_us, const int16_t *xyz, uint16_t count);
+void tlm_sendSpectrum(uint32_t timestamp_us, uint16_t first_bin, uint32_t bin_mhz,
+                      const uint32_t *power, uint16_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,127 @@
+/*
+ * Host Stress Test for the Shared BRAM Seqlock
+ * ==========================================
+ * Runs Vitis/Microblaze_app/sharedSeqlock.h on your local PC. A writer
+ * thread (the MicroBlaze) publishes 6-word records as fast as it can into
+ * a shared-memory page standing in for the BRAM, while a reader thread
+ * (the A53) copies them out. It does so both with the seqlock and with the
+ * plain word-by-word copy used before. Every payload word is derived from
+ * one counter, so a copy mixing two writes is detected.
+ *
+ * Expected: "torn" stays 0 for the seqlock reads and is usually non-zero
+ * for the plain reads (more so on a multi-core host).
+ *
+ * To compile: gcc -O2 -IVitis/Microblaze_app PC_Seqlock_Stress.c -o seqlock_stress -lpthread
+ * To run: ./seqlock_stress [seconds]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <time.h>
+#include "sharedSeqlock.h"
+
+#define VECTOR_SIZE     6
+#define READ_RETRIES    4
+
+static volatile uint32_t *record;        // seqlock-protected copy
+static volatile uint32_t *plain;         // unprotected copy, as before
+static volatile int running = 1;
+
+static void *writer(void *arg)
+{
+    uint32_t payload[VECTOR_SIZE];
+    uint32_t counter = 0;
+
+    (void)arg;
+    while (running) {
+        counter++;
+        for (int i = 0; i < VECTOR_SIZE; i++) {
+            payload[i] = counter * 7u + (uint32_t)i;
+        }
+
+        seqlock_write(record, payload, VECTOR_SIZE);
+
+        for (int i = 0; i < VECTOR_SIZE; i++) {
+            plain[i] = payload[i];
+        }
+    }
+    return NULL;
+}
+
+static int consistent(const uint32_t *payload)
+{
+    for (int i = 1; i < VECTOR_SIZE; i++) {
+        if (payload[i] != payload[0] + (uint32_t)i) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    int seconds = argc > 1 ? atoi(argv[1]) : 2;
+
+    // One shared page, record and plain copy on separate cache lines
+    uint32_t *page = mmap(NULL, 4096, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (page == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    record = page;
+    plain = page + 32;
+    seqlock_init(record, VECTOR_SIZE);
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, writer, NULL);
+
+    unsigned long reads = 0, fast = 0, failed = 0, torn = 0, stale = 0;
+    unsigned long plainReads = 0, plainTorn = 0;
+    uint32_t payload[VECTOR_SIZE];
+    uint32_t lastSeq = 0;
+    time_t end = time(NULL) + seconds;
+
+    while (time(NULL) < end) {
+        for (int k = 0; k < 1000; k++) {
+            uint32_t seq = seqlock_tryRead(record, payload, VECTOR_SIZE);
+            if (seq != 0) {
+                fast++;
+            } else {
+                seq = seqlock_read(record, payload, VECTOR_SIZE, READ_RETRIES);
+            }
+            reads++;
+
+            if (seq == 0) {
+                failed++;
+            } else {
+                if (!consistent(payload)) {
+                    torn++;
+                }
+                if (seq == lastSeq) {
+                    stale++;
+                }
+                lastSeq = seq;
+            }
+
+            for (int i = 0; i < VECTOR_SIZE; i++) {
+                payload[i] = plain[i];
+            }
+            plainReads++;
+            if (!consistent(payload)) {
+                plainTorn++;
+            }
+        }
+    }
+
+    running = 0;
+    pthread_join(thread, NULL);
+
+    printf("seqlock: %lu reads, %.2f%% fast path, %lu gave up after %d retries, %lu repeated, %lu torn\n",
+           reads, 100.0 * fast / reads, failed, READ_RETRIES, stale, torn);
+    printf("plain:   %lu reads, %lu torn\n", plainReads, plainTorn);
+
+    return torn == 0 ? 0 : 1;
+}
@@ -4,23 +4,32 @@
 #include <stdlib.h>
 #include <sleep.h>
 #include "xparameters.h"
+#include "sharedSeqlock.h"
 
 #define VECTOR_SIZE 6
 #define BRAM_BASE_ADDRESS XPAR_AXI_BRAM_0_BASEADDRESS
+#define READ_RETRIES 4
 
 
 // Launch the serial port in setup
 int main() {
 
     int read_data[6];
+    uint32_t last_seq = 0;
+
+    const volatile uint32_t *record = (const volatile uint32_t *)BRAM_BASE_ADDRESS;
 
     while(1){
 
-        // Read data from BRAM
-        for (int i = 0; i < VECTOR_SIZE; i++) {
-            u32 address = BRAM_BASE_ADDRESS + (i * 4); // Calculate address for each element
-            read_data[i] = Xil_In32(address);
+        // Copy the record; retried only if the copy overlapped a MicroBlaze write
+        uint32_t seq = seqlock_read(record, (uint32_t *)read_data, VECTOR_SIZE, READ_RETRIES);
+
+        if (seq == 0 || seq == last_seq) {
+            // Torn every time, not written yet, or nothing new since the last pass
+            usleep(20000);
+            continue;
         }
+        last_seq = seq;
 
 		xil_printf("\033[2J");  // Clears the screen
     	xil_printf("\033[1A");  // Moves the cursor up three lines
@@ -4,6 +4,7 @@
 #include <stdlib.h>
 #include <sleep.h>
 #include "xparameters.h"
+#include "sharedSeqlock.h"
 
 #define VECTOR_SIZE 6
 #define BRAM_BASE_ADDRESS XPAR_AXI_BRAM_0_BASEADDRESS
@@ -15,6 +16,10 @@ int main() {
     float counter = 0;
     int data_to_write[6];
 
+    // Sample record at the start of the BRAM: begin, 6 payload words, end
+    volatile uint32_t *record = (volatile uint32_t *)BRAM_BASE_ADDRESS;
+    seqlock_init(record, VECTOR_SIZE);
+
 	// infinite loop
 	while(1){
 
@@ -39,11 +44,8 @@ int main() {
         data_to_write[5] = AccelZ_frac;
         
 
-        // Write data to BRAM
-        for (int i = 0; i < VECTOR_SIZE; i++) {
-            u32 address = BRAM_BASE_ADDRESS + (i * 4); // Calculate address for each element
-            Xil_Out32(address, data_to_write[i]);
-        }
+        // Publish all six words as one record, so the A53 never sees a mix of two samples
+        seqlock_write(record, (const uint32_t *)data_to_write, VECTOR_SIZE);
 
         counter += 1;
 
@@ -0,0 +1,132 @@
+/*
+sharedSeqlock.h - Seqlock-protected fixed-size records in shared BRAM.
+
+One writer (e.g. the MicroBlaze) publishes records that any number of
+readers (e.g. the A53) copy out without ever seeing half of one update and
+half of the next. BRAM has no atomic read-modify-write, so the record is
+bracketed by two sequence words instead of the usual single odd/even one:
+
+    word 0          begin   incremented before the payload is written
+    word 1..n       payload
+    word n + 1      end     set equal to begin once the payload is complete
+
+A reader reads end, the payload, then begin; the copy is consistent when
+begin == end. seq 0 means "never written" (see seqlock_init).
+
+Readers get a retry-free fast path, seqlock_tryRead(), which fails only if
+it overlapped a write, and a bounded slow path, seqlock_read(), which
+retries up to a given number of times. Both return the record's sequence
+number, so a poller can skip copies it has already seen:
+    uint32_t seq = seqlock_read(rec, words, SAMPLE_WORDS, 4);
+    if (seq != 0 && seq != lastSeq) { ... lastSeq = seq; }
+
+Plain C (MicroBlaze) and C++ (A53); the record pointer is the BRAM address
+as seen by that processor. SEQLOCK_BARRIER() orders the accesses across
+masters (mbar on MicroBlaze, dmb on the A53, a full fence on a host).
+*/
+
+#ifndef SHAREDSEQLOCK_h
+#define SHAREDSEQLOCK_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__MICROBLAZE__)
+#define SEQLOCK_BARRIER()       __asm__ __volatile__ ("mbar 1" ::: "memory")
+#elif defined(__aarch64__)
+#define SEQLOCK_BARRIER()       __asm__ __volatile__ ("dmb sy" ::: "memory")
+#elif defined(__arm__)
+#define SEQLOCK_BARRIER()       __asm__ __volatile__ ("dmb" ::: "memory")
+#else
+#define SEQLOCK_BARRIER()       __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+// Words a record with n payload words occupies
+#define SEQLOCK_RECORD_WORDS(n)     ((n) + 2)
+#define SEQLOCK_RECORD_BYTES(n)     (4 * SEQLOCK_RECORD_WORDS(n))
+
+// Clear the record (writer, before the readers start)
+static inline void seqlock_init(volatile uint32_t *record, unsigned int words)
+{
+    unsigned int i;
+
+    record[0] = 0;
+    for (i = 0; i < words; i++)
+    {
+        record[1 + i] = 0;
+    }
+    record[1 + words] = 0;
+    SEQLOCK_BARRIER();
+}
+
+// Publish a new payload; returns its sequence number (single writer only)
+static inline uint32_t seqlock_write(volatile uint32_t *record, const uint32_t *payload, unsigned int words)
+{
+    uint32_t seq = record[0] + 1;
+    unsigned int i;
+
+    if (seq == 0)
+    {
+        seq = 1;
+    }
+
+    record[0] = seq;
+    SEQLOCK_BARRIER();
+
+    for (i = 0; i < words; i++)
+    {
+        record[1 + i] = payload[i];
+    }
+
+    SEQLOCK_BARRIER();
+    record[1 + words] = seq;
+    return seq;
+}
+
+// Sequence number of the last completed write, without copying the payload
+static inline uint32_t seqlock_sequence(const volatile uint32_t *record, unsigned int words)
+{
+    return record[1 + words];
+}
+
+// One attempt: copies the payload and returns its sequence number, or 0 if
+// the copy overlapped a write (or nothing was ever written)
+static inline uint32_t seqlock_tryRead(const volatile uint32_t *record, uint32_t *payload, unsigned int words)
+{
+    uint32_t end = record[1 + words];
+    uint32_t begin;
+    unsigned int i;
+
+    SEQLOCK_BARRIER();
+    for (i = 0; i < words; i++)
+    {
+        payload[i] = record[1 + i];
+    }
+    SEQLOCK_BARRIER();
+
+    begin = record[0];
+    return begin == end ? end : 0;
+}
+
+// Up to 1 + retries attempts; returns 0 if every one overlapped a write
+static inline uint32_t seqlock_read(const volatile uint32_t *record, uint32_t *payload, unsigned int words,
+                                    unsigned int retries)
+{
+    uint32_t seq;
+
+    do
+    {
+        seq = seqlock_tryRead(record, payload, words);
+    } while (seq == 0 && retries-- > 0 && seqlock_sequence(record, words) != 0);
+
+    return seq;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif